@@ -16,7 +16,7 @@ async function buildAll() {
       bundle: true,
       outfile: `${libFolder}${filename}`,
       format: "esm",
-      external: ["fastedge::fs"],
+      external: ["fastedge::fs", "fastedge::assets"],
       logLevel: "info",
     });
   }
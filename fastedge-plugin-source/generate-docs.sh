@@ -93,7 +93,7 @@ SOURCE_FILES[BUILD_CLI.md]="src/cli/fastedge-build/build.ts src/cli/fastedge-bui
 SOURCE_FILES[INIT_CLI.md]="src/cli/fastedge-init/init.ts src/cli/fastedge-init/http-handler.ts src/cli/fastedge-init/static-site.ts src/cli/fastedge-init/create-config.ts"
 SOURCE_FILES[ASSETS_CLI.md]="src/cli/fastedge-assets/asset-cli.ts src/server/static-assets/asset-manifest/create-manifest.ts"
 SOURCE_FILES[STATIC_SITES.md]="src/server/static-assets/static-server/create-static-server.ts"
-SOURCE_FILES[SDK_API.md]="types/fastedge-env.d.ts types/fastedge-secret.d.ts types/fastedge-kv.d.ts types/fastedge-cache.d.ts types/globals.d.ts"
+SOURCE_FILES[SDK_API.md]="types/fastedge-env.d.ts types/fastedge-secret.d.ts types/fastedge-kv.d.ts types/fastedge-cache.d.ts types/fastedge-codec.d.ts types/fastedge-ip.d.ts types/fastedge-ja3.d.ts types/fastedge-pattern.d.ts types/fastedge-router.d.ts types/fastedge-assets.d.ts types/globals.d.ts"
 
 # =============================================================================
 # === CUSTOMIZE: Package name for the generation prompt ===
@@ -0,0 +1,48 @@
+import type { CheckContext } from '../types.js';
+import { CIDR_SET } from '../routes.js';
+
+export const name = CIDR_SET.name;
+
+// Prefixes from handlers/cidr-set.ts: 10.0.0.0/8, 192.168.1.128/25, 2001:db8::/32, ::1/128,
+// fe80::/10.
+const EXPECTED: Record<string, boolean> = {
+  '9.255.255.255': false,
+  '10.0.0.0': true,
+  '10.255.255.255': true,
+  '11.0.0.0': false,
+  '192.168.1.127': false,
+  '192.168.1.128': true,
+  '192.168.1.255': true,
+  '192.168.2.0': false,
+  '::ffff:10.1.2.3': true,
+  '2001:db7:ffff:ffff:ffff:ffff:ffff:ffff': false,
+  '2001:db8::': true,
+  '2001:db8:ffff:ffff:ffff:ffff:ffff:ffff': true,
+  '2001:db9::': false,
+  '::': false,
+  '::1': true,
+  '::2': false,
+  'fe80::1': true,
+  'febf:ffff::1': true,
+  'fec0::': false,
+  'not-an-ip': false,
+};
+
+export async function check(appUrl: string, _ctx: CheckContext): Promise<void> {
+  const res = await fetch(`${appUrl}${CIDR_SET.route}`);
+  if (res.status !== 200) throw new Error(`${CIDR_SET.route}: bad status ${res.status}`);
+  const data = (await res.json()) as {
+    size: number;
+    results: Record<string, boolean>;
+    bytes: boolean;
+  };
+  if (data.size !== 5) throw new Error(`${CIDR_SET.route}: size ${data.size}, expected 5`);
+  for (const [address, expected] of Object.entries(EXPECTED)) {
+    if (data.results[address] !== expected) {
+      throw new Error(
+        `${CIDR_SET.route}: contains("${address}") was ${data.results[address]}, expected ${expected}`,
+      );
+    }
+  }
+  if (!data.bytes) throw new Error(`${CIDR_SET.route}: contains(Uint8Array 10.0.0.1) was false`);
+}
@@ -0,0 +1,32 @@
+import type { CheckContext } from '../types.js';
+import { CODEC } from '../routes.js';
+
+export const name = CODEC.name;
+
+// Values decoded from the documents in handlers/codec.ts.
+const EXPECTED: Record<string, unknown> = {
+  msgpackMap: { a: 1, b: [true, null, 'hi'], c: -1.5 },
+  msgpackMapViaDecode: { a: 1, b: [true, null, 'hi'], c: -1.5 },
+  big: '9007199254740992',
+  bin: [1, 2],
+  cborMap: { a: 1, b: [true, null, 'hi'] },
+  epoch: 0,
+  bytes: [1, 2],
+};
+
+export async function check(appUrl: string, _ctx: CheckContext): Promise<void> {
+  const res = await fetch(`${appUrl}${CODEC.route}`);
+  if (res.status !== 200) throw new Error(`${CODEC.route}: bad status ${res.status}`);
+  const data = (await res.json()) as Record<string, unknown>;
+  for (const [key, expected] of Object.entries(EXPECTED)) {
+    if (JSON.stringify(data[key]) !== JSON.stringify(expected)) {
+      throw new Error(
+        `${CODEC.route}: ${key} decoded to ${JSON.stringify(data[key])}, ` +
+          `expected ${JSON.stringify(expected)}`,
+      );
+    }
+  }
+  for (const key of ['truncated', 'trailing']) {
+    if (!data[key]) throw new Error(`${CODEC.route}: ${key} input did not throw`);
+  }
+}
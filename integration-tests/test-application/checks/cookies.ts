@@ -0,0 +1,44 @@
+import type { CheckContext } from '../types.js';
+import { COOKIES } from '../routes.js';
+
+export const name = COOKIES.name;
+
+interface CookiesResult {
+  get: Record<string, string | null>;
+  has: Record<string, boolean>;
+  all: Record<string, string>;
+}
+
+// Header values go on the wire as Latin-1, one byte per character. `utf8` is the UTF-8
+// encoding of "é" (C3 A9); `obsText` is a lone 0xE9 byte, which is not valid UTF-8.
+const COOKIE_HEADER =
+  'plain=1; quoted="two"; utf8=caf\u00c3\u00a9; obsText=caf\u00e9; dup=first; dup=second';
+
+const EXPECTED_GET: Record<string, string | null> = {
+  plain: '1',
+  quoted: 'two',
+  utf8: 'caf\u00e9',
+  obsText: 'caf\u00e9',
+  dup: 'first',
+  missing: null,
+};
+
+function assert(condition: boolean, message: string): void {
+  if (!condition) throw new Error(`${COOKIES.route}: ${message}`);
+}
+
+export async function check(appUrl: string, _ctx: CheckContext): Promise<void> {
+  const res = await fetch(`${appUrl}${COOKIES.route}`, { headers: { cookie: COOKIE_HEADER } });
+  assert(res.status === 200, `bad status ${res.status}`);
+  const data = (await res.json()) as CookiesResult;
+
+  for (const [cookie, value] of Object.entries(EXPECTED_GET)) {
+    assert(data.get[cookie] === value, `get("${cookie}") = ${JSON.stringify(data.get[cookie])}`);
+    assert(data.has[cookie] === (value !== null), `has("${cookie}") = ${data.has[cookie]}`);
+  }
+  assert(
+    data.all.obsText === 'caf\u00e9',
+    `getAll().obsText = ${JSON.stringify(data.all.obsText)}`,
+  );
+  assert(data.all.dup === 'first', `getAll().dup = ${JSON.stringify(data.all.dup)}`);
+}
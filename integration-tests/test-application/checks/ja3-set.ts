@@ -0,0 +1,46 @@
+import type { CheckContext } from '../types.js';
+import { JA3_SET } from '../routes.js';
+
+export const name = JA3_SET.name;
+
+// Labels expected from the two sets compiled in handlers/ja3-set.ts.
+const EXPECTED = {
+  groupedSize: 3,
+  labelledSize: 3,
+  grouped: {
+    browser: 'good',
+    curl: 'bad',
+    scanner: 'bad',
+    scannerBytes: 'bad',
+    tor: null,
+    empty: null,
+    malformed: null,
+  },
+  labelled: {
+    tor: 'tor',
+    scanner: 'scanner',
+    browser: 'match',
+    curl: null,
+  },
+};
+
+export async function check(appUrl: string, _ctx: CheckContext): Promise<void> {
+  const res = await fetch(`${appUrl}${JA3_SET.route}`);
+  if (res.status !== 200) throw new Error(`${JA3_SET.route}: bad status ${res.status}`);
+  const data = (await res.json()) as typeof EXPECTED;
+  if (data.groupedSize !== EXPECTED.groupedSize || data.labelledSize !== EXPECTED.labelledSize) {
+    throw new Error(
+      `${JA3_SET.route}: sizes ${data.groupedSize}/${data.labelledSize}, expected 3/3`,
+    );
+  }
+  for (const set of ['grouped', 'labelled'] as const) {
+    for (const [fingerprint, label] of Object.entries(EXPECTED[set])) {
+      const actual = (data[set] as Record<string, string | null>)[fingerprint];
+      if (actual !== label) {
+        throw new Error(
+          `${JA3_SET.route}: ${set} classify(${fingerprint}) was ${actual}, expected ${label}`,
+        );
+      }
+    }
+  }
+}
@@ -0,0 +1,22 @@
+import type { CheckContext } from '../types.js';
+import { KV_CLOSE } from '../routes.js';
+
+export const name = KV_CLOSE.name;
+
+export async function check(appUrl: string, _ctx: CheckContext): Promise<void> {
+  const res = await fetch(`${appUrl}${KV_CLOSE.route}`);
+  if (res.status !== 200) throw new Error(`${KV_CLOSE.route}: bad status ${res.status}`);
+  const data = (await res.json()) as {
+    closedError: string;
+    reopenedValue: unknown;
+    otherValue: unknown;
+  };
+  if (!data.closedError.includes('closed')) {
+    throw new Error(`${KV_CLOSE.route}: get after close() did not throw (got "${data.closedError}")`);
+  }
+  if (data.reopenedValue !== null || data.otherValue !== null) {
+    throw new Error(
+      `${KV_CLOSE.route}: get after reopen returned ${JSON.stringify(data)} for a missing key`,
+    );
+  }
+}
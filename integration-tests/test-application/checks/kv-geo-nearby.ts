@@ -0,0 +1,18 @@
+import type { CheckContext } from '../types.js';
+import { KV_GEO_NEARBY } from '../routes.js';
+
+export const name = KV_GEO_NEARBY.name;
+
+export async function check(appUrl: string, _ctx: CheckContext): Promise<void> {
+  const res = await fetch(`${appUrl}${KV_GEO_NEARBY.route}`);
+  if (res.status !== 200) throw new Error(`${KV_GEO_NEARBY.route}: bad status ${res.status}`);
+  const data = (await res.json()) as Record<string, number | string>;
+  if (Object.keys(data).length === 0) throw new Error(`${KV_GEO_NEARBY.route}: no results`);
+  for (const [search, result] of Object.entries(data)) {
+    if (result !== 0) {
+      throw new Error(
+        `${KV_GEO_NEARBY.route}: ${search} search on a missing key returned ${JSON.stringify(result)}`,
+      );
+    }
+  }
+}
@@ -0,0 +1,29 @@
+import type { CheckContext } from '../types.js';
+import { KV_MIRROR } from '../routes.js';
+
+export const name = KV_MIRROR.name;
+
+const EXPECTED: Record<string, unknown> = {
+  keysMatch: true,
+  get: null,
+  getText: null,
+  getJSON: null,
+  zrange: 0,
+  classScan: 0,
+  sharedCopy: true,
+};
+
+export async function check(appUrl: string, _ctx: CheckContext): Promise<void> {
+  const res = await fetch(`${appUrl}${KV_MIRROR.route}`);
+  if (res.status !== 200) throw new Error(`${KV_MIRROR.route}: bad status ${res.status}`);
+  const data = (await res.json()) as Record<string, unknown>;
+  for (const [field, expected] of Object.entries(EXPECTED)) {
+    if (data[field] !== expected) {
+      throw new Error(
+        `${KV_MIRROR.route}: ${field} was ${JSON.stringify(data[field])}, expected ` +
+          `${JSON.stringify(expected)} (host keys ${data.hostKeyCount}, mirror keys ` +
+          `${data.mirrorKeyCount})`,
+      );
+    }
+  }
+}
@@ -0,0 +1,15 @@
+import type { CheckContext } from '../types.js';
+import { KV_ZRANGE } from '../routes.js';
+
+export const name = KV_ZRANGE.name;
+
+export async function check(appUrl: string, _ctx: CheckContext): Promise<void> {
+  const res = await fetch(`${appUrl}${KV_ZRANGE.route}`);
+  if (res.status !== 200) throw new Error(`${KV_ZRANGE.route}: bad status ${res.status}`);
+  const data = (await res.json()) as Record<string, number>;
+  for (const [variant, length] of Object.entries(data)) {
+    if (length !== 0) {
+      throw new Error(`${KV_ZRANGE.route}: ${variant} returned ${length} members for a missing key`);
+    }
+  }
+}
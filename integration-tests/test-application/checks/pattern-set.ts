@@ -0,0 +1,35 @@
+import type { CheckContext } from '../types.js';
+import { PATTERN_SET } from '../routes.js';
+
+export const name = PATTERN_SET.name;
+
+// Rule IDs from handlers/pattern-set.ts, in rule order.
+const EXPECTED: Record<string, unknown> = {
+  ushers: [0, 1, 3],
+  this: [2],
+  none: [],
+  bytes: [0, 1, 2, 3],
+  testShe: true,
+  testNone: false,
+  adminUpper: ['admin', 'adm', 'traversal'],
+  admOnly: ['adm'],
+  literal: [0],
+  literalNoCaret: [],
+};
+
+export async function check(appUrl: string, _ctx: CheckContext): Promise<void> {
+  const res = await fetch(`${appUrl}${PATTERN_SET.route}`);
+  if (res.status !== 200) throw new Error(`${PATTERN_SET.route}: bad status ${res.status}`);
+  const data = (await res.json()) as Record<string, unknown>;
+  for (const [input, expected] of Object.entries(EXPECTED)) {
+    if (JSON.stringify(data[input]) !== JSON.stringify(expected)) {
+      throw new Error(
+        `${PATTERN_SET.route}: ${input} gave ${JSON.stringify(data[input])}, ` +
+          `expected ${JSON.stringify(expected)}`,
+      );
+    }
+  }
+  if (!String(data.regexError).includes('regular-expression syntax')) {
+    throw new Error(`${PATTERN_SET.route}: regex-looking rule was not rejected`);
+  }
+}
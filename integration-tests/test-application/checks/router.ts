@@ -0,0 +1,47 @@
+import type { CheckContext } from '../types.js';
+import { ROUTER } from '../routes.js';
+
+export const name = ROUTER.name;
+
+interface RouterResult {
+  target: string;
+  index: number | null;
+  params: Record<string, string> | null;
+}
+
+// Route indices from handlers/router.ts: 0 = /login, 1 = /admin, 2 = /users/:id.
+const EXPECTED: Record<string, number | null> = {
+  '/login?next=https://x/admin': 0,
+  '/login#https://x/admin': 0,
+  'https://example.com/users/42?next=https://x/admin': 2,
+  'https://example.com?next=/admin': null,
+  '/users/a%3A%2F%2Fb': 2,
+  '/users/%FF': 2,
+  '/users/%E2%82': 2,
+};
+
+// Expected `id` param for each /users/:id target.
+const EXPECTED_IDS: Record<string, string> = {
+  '/users/a%3A%2F%2Fb': 'a://b',
+  '/users/%FF': '%FF',
+  '/users/%E2%82': '%E2%82',
+};
+
+export async function check(appUrl: string, _ctx: CheckContext): Promise<void> {
+  const res = await fetch(`${appUrl}${ROUTER.route}`);
+  if (res.status !== 200) throw new Error(`${ROUTER.route}: bad status ${res.status}`);
+  const data = (await res.json()) as RouterResult[];
+  for (const { target, index } of data) {
+    if (index !== EXPECTED[target]) {
+      throw new Error(
+        `${ROUTER.route}: "${target}" matched route ${index}, expected ${EXPECTED[target]}`,
+      );
+    }
+  }
+  for (const [target, id] of Object.entries(EXPECTED_IDS)) {
+    const result = data.find((r) => r.target === target);
+    if (result?.params?.id !== id) {
+      throw new Error(`${ROUTER.route}: "${target}" id wrong: "${result?.params?.id}"`);
+    }
+  }
+}
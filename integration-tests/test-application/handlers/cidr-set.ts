@@ -0,0 +1,48 @@
+import { CidrSet } from 'fastedge::ip';
+import { CIDR_SET } from '../routes.js';
+
+export const route = CIDR_SET.route;
+
+const set = CidrSet.compile(`
+# IPv4
+10.0.0.0/8
+192.168.1.128/25
+# IPv6
+2001:db8::/32, ::1/128, fe80::/10
+`);
+
+// Addresses on either side of each prefix boundary; the check compares `contains`.
+const ADDRESSES = [
+  '9.255.255.255',
+  '10.0.0.0',
+  '10.255.255.255',
+  '11.0.0.0',
+  '192.168.1.127',
+  '192.168.1.128',
+  '192.168.1.255',
+  '192.168.2.0',
+  '::ffff:10.1.2.3',
+  '2001:db7:ffff:ffff:ffff:ffff:ffff:ffff',
+  '2001:db8::',
+  '2001:db8:ffff:ffff:ffff:ffff:ffff:ffff',
+  '2001:db9::',
+  '::',
+  '::1',
+  '::2',
+  'fe80::1',
+  'febf:ffff::1',
+  'fec0::',
+  'not-an-ip',
+];
+
+export async function handler(_req: Request): Promise<Response> {
+  const results: Record<string, boolean> = {};
+  for (const address of ADDRESSES) {
+    results[address] = set.contains(address);
+  }
+  return Response.json({
+    size: set.size,
+    results,
+    bytes: set.contains(new Uint8Array([10, 0, 0, 1])),
+  });
+}
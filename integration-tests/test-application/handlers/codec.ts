@@ -0,0 +1,50 @@
+import { Codec } from 'fastedge::codec';
+import { CODEC } from '../routes.js';
+
+export const route = CODEC.route;
+
+// {"a": 1, "b": [true, null, "hi"], "c": -1.5}
+const MSGPACK_MAP = new Uint8Array([
+  0x83, 0xa1, 0x61, 0x01, 0xa1, 0x62, 0x93, 0xc3, 0xc0, 0xa2, 0x68, 0x69, 0xa1, 0x63, 0xcb,
+  0xbf, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+]);
+// uint64 2^53, one past Number.MAX_SAFE_INTEGER.
+const MSGPACK_BIG = new Uint8Array([0xcf, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00]);
+// bin8 [1, 2]
+const MSGPACK_BIN = new Uint8Array([0xc4, 0x02, 0x01, 0x02]);
+// {"a": 1, "b": [true, null, "hi"]}
+const CBOR_MAP = new Uint8Array([
+  0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x83, 0xf5, 0xf6, 0x62, 0x68, 0x69,
+]);
+// tag 1 (epoch time) 0
+const CBOR_EPOCH = new Uint8Array([0xc1, 0x1a, 0x00, 0x00, 0x00, 0x00]);
+// byte string [1, 2]
+const CBOR_BYTES = new Uint8Array([0x42, 0x01, 0x02]);
+
+function decodeError(decode: () => unknown): string {
+  try {
+    decode();
+    return '';
+  } catch (err) {
+    return String(err);
+  }
+}
+
+export async function handler(_req: Request): Promise<Response> {
+  const big = Codec.decodeMsgpack<bigint>(MSGPACK_BIG);
+  const bin = Codec.decodeMsgpack<Uint8Array>(MSGPACK_BIN.buffer);
+  const epoch = Codec.decodeCbor<Date>(CBOR_EPOCH);
+  const bytes = Codec.decode<Uint8Array>(CBOR_BYTES, 'cbor');
+
+  return Response.json({
+    msgpackMap: Codec.decodeMsgpack(MSGPACK_MAP),
+    msgpackMapViaDecode: Codec.decode(MSGPACK_MAP, 'msgpack'),
+    big: typeof big === 'bigint' ? big.toString() : `not a BigInt: ${String(big)}`,
+    bin: bin instanceof Uint8Array ? Array.from(bin) : null,
+    cborMap: Codec.decodeCbor(CBOR_MAP),
+    epoch: epoch instanceof Date ? epoch.getTime() : null,
+    bytes: bytes instanceof Uint8Array ? Array.from(bytes) : null,
+    truncated: decodeError(() => Codec.decodeMsgpack(new Uint8Array([0x92, 0x01]))),
+    trailing: decodeError(() => Codec.decodeCbor(new Uint8Array([0x01, 0x02]))),
+  });
+}
@@ -0,0 +1,14 @@
+import { COOKIES } from '../routes.js';
+
+export const route = COOKIES.route;
+
+// Echoes what `event.cookies` makes of the Cookie header the check sends.
+export async function handler(_req: Request, event: FetchEvent): Promise<Response> {
+  const { cookies } = event;
+  const names = ['plain', 'quoted', 'utf8', 'obsText', 'dup', 'missing'];
+  return Response.json({
+    get: Object.fromEntries(names.map((name) => [name, cookies.get(name)])),
+    has: Object.fromEntries(names.map((name) => [name, cookies.has(name)])),
+    all: cookies.getAll(),
+  });
+}
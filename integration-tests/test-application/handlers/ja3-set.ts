@@ -0,0 +1,44 @@
+import { Ja3Set } from 'fastedge::ja3';
+import { JA3_SET } from '../routes.js';
+
+export const route = JA3_SET.route;
+
+const BROWSER = 'e7d705a3286e19ea42f587b344ee6865';
+const CURL = '456523fc94726331a4d5a2e1d40b2cd7';
+const SCANNER = '3b5074b1b5d032e5620f69f9f700ff0e';
+const TOR = 'e35df3e00ca4ef31d42b34bebaa2f86e';
+
+// Grouped by label. CURL is listed under both labels, so the later one ("bad") wins.
+const grouped = Ja3Set.compile({
+  good: [BROWSER, CURL],
+  bad: `# known bad\n${CURL}\n${SCANNER.toUpperCase()}\n`,
+});
+
+// One list with per-line labels; an entry without a label gets "match".
+const labelled = Ja3Set.compile(`${TOR} tor\n${SCANNER},scanner\n${BROWSER}\n`);
+
+function hexBytes(hex: string): Uint8Array {
+  return new Uint8Array(hex.match(/../g)!.map((byte) => parseInt(byte, 16)));
+}
+
+export async function handler(_req: Request): Promise<Response> {
+  return Response.json({
+    groupedSize: grouped.size,
+    labelledSize: labelled.size,
+    grouped: {
+      browser: grouped.classify(BROWSER),
+      curl: grouped.classify(CURL),
+      scanner: grouped.classify(SCANNER),
+      scannerBytes: grouped.classify(hexBytes(SCANNER)),
+      tor: grouped.classify(TOR),
+      empty: grouped.classify(''),
+      malformed: grouped.classify('not-a-fingerprint'),
+    },
+    labelled: {
+      tor: labelled.classify(TOR),
+      scanner: labelled.classify(SCANNER.toUpperCase()),
+      browser: labelled.classify(BROWSER),
+      curl: labelled.classify(CURL),
+    },
+  });
+}
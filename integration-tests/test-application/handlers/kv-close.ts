@@ -0,0 +1,35 @@
+import { getEnv } from 'fastedge::env';
+import { KvStore } from 'fastedge::kv';
+import { KV_CLOSE } from '../routes.js';
+
+export const route = KV_CLOSE.route;
+
+export async function handler(_req: Request): Promise<Response> {
+  const storeName = getEnv('TEST_KV_STORE') || 'fastedge-sdk-js-test-kv';
+  const missingKey = `missing-key-${Date.now()}`;
+
+  // Both wrappers share one host handle, so closing one closes the other.
+  const kv = KvStore.open(storeName);
+  const other = KvStore.open(storeName);
+  kv.close();
+  kv.close();
+
+  let closedError = '';
+  try {
+    other.get(missingKey);
+  } catch (err) {
+    closedError = String(err);
+  }
+
+  // Reopening restores the handle for every wrapper of the store.
+  const reopened = KvStore.open(storeName);
+  const reopenedValue = reopened.get(missingKey);
+  const otherValue = other.get(missingKey);
+  reopened.close();
+
+  return Response.json({
+    closedError,
+    reopenedValue,
+    otherValue,
+  });
+}
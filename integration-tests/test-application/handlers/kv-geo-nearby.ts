@@ -0,0 +1,34 @@
+import { getEnv } from 'fastedge::env';
+import { KvStore } from 'fastedge::kv';
+import { KV_GEO_NEARBY } from '../routes.js';
+
+export const route = KV_GEO_NEARBY.route;
+
+// Search centres whose 3x3 block of geohash cells is empty on the host. Each one is a separate
+// zrangeByScore per cell, so every cell comes back as an empty host list.
+const SEARCHES: Array<[label: string, latitude: number, longitude: number, radiusKm: number]> = [
+  ['city', 51.5074, -0.1278, 5],
+  // Cells on both sides of the antimeridian, from either side.
+  ['antimeridian east', -16.5, 179.99, 50],
+  ['antimeridian west', -16.5, -179.99, 50],
+  ['antimeridian edge', 0, -180, 50],
+  // The top row of cells has no northern neighbours.
+  ['polar edge', 85.05, 10, 100],
+  // A radius large enough to search a coarse step.
+  ['continental', 48.8566, 2.3522, 2000],
+];
+
+export async function handler(_req: Request): Promise<Response> {
+  const kv = KvStore.open(getEnv('TEST_KV_STORE') || 'fastedge-sdk-js-test-kv');
+  const missingKey = `missing-geo-${Date.now()}`;
+
+  const results: Record<string, number | string> = {};
+  for (const [label, latitude, longitude, radiusKm] of SEARCHES) {
+    try {
+      results[label] = kv.geoNearby(missingKey, latitude, longitude, radiusKm, { limit: 10 }).length;
+    } catch (error) {
+      results[label] = error instanceof Error ? error.message : String(error);
+    }
+  }
+  return Response.json(results);
+}
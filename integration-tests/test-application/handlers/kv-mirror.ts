@@ -0,0 +1,29 @@
+import { getEnv } from 'fastedge::env';
+import { KvStore } from 'fastedge::kv';
+import { KV_MIRROR } from '../routes.js';
+
+export const route = KV_MIRROR.route;
+
+export async function handler(_req: Request): Promise<Response> {
+  const storeName = getEnv('TEST_KV_STORE') || 'fastedge-sdk-js-test-kv';
+  const mirror = KvStore.openMirrored(storeName, { refreshMs: 60000 });
+  const missingKey = `missing-key-${Date.now()}`;
+
+  // The mirror holds every key of the store, so its key list matches a host scan.
+  const hostKeys = KvStore.open(storeName).scan('*').sort();
+  const mirrorKeys = mirror.scan('*').sort();
+
+  mirror.refresh();
+
+  return Response.json({
+    keysMatch: JSON.stringify(hostKeys) === JSON.stringify(mirrorKeys),
+    hostKeyCount: hostKeys.length,
+    mirrorKeyCount: mirrorKeys.length,
+    get: mirror.get(missingKey),
+    getText: mirror.getText(missingKey),
+    getJSON: mirror.getJSON(missingKey),
+    zrange: mirror.zrangeByScore(missingKey, -Infinity, Infinity).length,
+    classScan: mirror.scan(`${missingKey}-[0-9a-f]*`).length,
+    sharedCopy: KvStore.openMirrored(storeName).scan('*').length === mirrorKeys.length,
+  });
+}
@@ -0,0 +1,27 @@
+import { getEnv } from 'fastedge::env';
+import { KvStore } from 'fastedge::kv';
+import { KV_ZRANGE } from '../routes.js';
+
+export const route = KV_ZRANGE.route;
+
+export async function handler(_req: Request): Promise<Response> {
+  const kv = KvStore.open(getEnv('TEST_KV_STORE') || 'fastedge-sdk-js-test-kv');
+
+  // The host answers a missing key with an empty list, which the runtime then narrows to the
+  // requested window. Each call takes a different narrowing path over that empty list.
+  const missingKey = `missing-zset-${Date.now()}`;
+  const plain = kv.zrangeByScore(missingKey, -Infinity, Infinity);
+  const windowed = kv.zrangeByScore(missingKey, 0, 100, { offset: 1, count: 5 });
+  const reversed = kv.zrangeByScore(missingKey, 0, 100, { reverse: true, count: 1 });
+  const exclusive = kv.zrangeByScore(missingKey, 0, 100, {
+    minExclusive: true,
+    maxExclusive: true,
+  });
+
+  return Response.json({
+    plain: plain.length,
+    windowed: windowed.length,
+    reversed: reversed.length,
+    exclusive: exclusive.length,
+  });
+}
@@ -0,0 +1,40 @@
+import { PatternSet } from 'fastedge::pattern';
+import { PATTERN_SET } from '../routes.js';
+
+export const route = PATTERN_SET.route;
+
+// Overlapping patterns: "she" contains "he", "hers" starts with "he", and "/adm" is a
+// prefix of "/admin".
+const overlap = PatternSet.compile(['he', 'she', 'his', 'hers']);
+const paths = PatternSet.compile(
+  [
+    { id: 'admin', pattern: '/admin' },
+    { id: 'adm', pattern: '/adm' },
+    { id: 'traversal', pattern: '../' },
+  ],
+  { caseInsensitive: true },
+);
+const literal = PatternSet.compile(['^/admin'], { allowRegexSyntax: true });
+
+export async function handler(_req: Request): Promise<Response> {
+  let regexError = '';
+  try {
+    PatternSet.compile(['union.*select']);
+  } catch (err) {
+    regexError = String(err);
+  }
+
+  return Response.json({
+    ushers: overlap.scan('ushers'),
+    this: overlap.scan('this'),
+    none: overlap.scan('abc'),
+    bytes: overlap.scan(new TextEncoder().encode('hishers')),
+    testShe: overlap.test('ashe'),
+    testNone: overlap.test('xyz'),
+    adminUpper: paths.scan('/ADMIN/../etc'),
+    admOnly: paths.scan('/adm'),
+    literal: literal.scan('/x?next=^/admin'),
+    literalNoCaret: literal.scan('/admin'),
+    regexError,
+  });
+}
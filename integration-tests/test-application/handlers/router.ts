@@ -0,0 +1,27 @@
+import { Router } from 'fastedge::router';
+import { ROUTER } from '../routes.js';
+
+export const route = ROUTER.route;
+
+const router = Router.compile(['/login', '/admin', '/users/:id']);
+
+// Each target is matched natively; the check compares the matched route index.
+const TARGETS = [
+  '/login?next=https://x/admin',
+  '/login#https://x/admin',
+  'https://example.com/users/42?next=https://x/admin',
+  'https://example.com?next=/admin',
+  '/users/a%3A%2F%2Fb',
+  // Percent-escapes that decode to invalid UTF-8 keep the raw segment.
+  '/users/%FF',
+  '/users/%E2%82',
+];
+
+export async function handler(_req: Request): Promise<Response> {
+  return Response.json(
+    TARGETS.map((target) => {
+      const match = router.match('GET', target);
+      return { target, index: match?.index ?? null, params: match?.params ?? null };
+    }),
+  );
+}
@@ -6,3 +6,13 @@ export const RESPONSE_CLONE = { name: 'Response.clone', route: '/response-clone'
 // Source for the Response.clone guard: serves a multi-chunk streaming body so the clone
 // test can exercise a host-backed (HttpIncomingBody), multi-read body. Remove with the guard.
 export const MULTI_CHUNK_SOURCE = { name: 'multi-chunk source', route: '/multi-chunk-source' };
+export const KV_ZRANGE      = { name: 'kv zrangeByScore', route: '/kv-zrange' };
+export const ROUTER         = { name: 'native router',  route: '/router' };
+export const KV_GEO_NEARBY  = { name: 'kv geoNearby',   route: '/kv-geo-nearby' };
+export const COOKIES        = { name: 'event.cookies',  route: '/cookies' };
+export const KV_CLOSE       = { name: 'kv close',       route: '/kv-close' };
+export const CIDR_SET       = { name: 'CidrSet',        route: '/cidr-set' };
+export const JA3_SET        = { name: 'Ja3Set',         route: '/ja3-set' };
+export const PATTERN_SET    = { name: 'PatternSet',     route: '/pattern-set' };
+export const CODEC          = { name: 'Codec',          route: '/codec' };
+export const KV_MIRROR      = { name: 'kv openMirrored', route: '/kv-mirror' };
@@ -1,14 +1,43 @@
 import { Hono } from 'hono';
+import * as cidrSet from './handlers/cidr-set.js';
+import * as codec from './handlers/codec.js';
+import * as cookies from './handlers/cookies.js';
 import * as echo from './handlers/echo.js';
 import * as env from './handlers/env.js';
+import * as ja3Set from './handlers/ja3-set.js';
+import * as kvClose from './handlers/kv-close.js';
+import * as kvGeoNearby from './handlers/kv-geo-nearby.js';
+import * as kvMirror from './handlers/kv-mirror.js';
+import * as kvZrange from './handlers/kv-zrange.js';
 import * as multiChunkSource from './handlers/multi-chunk-source.js';
 import * as outboundFetch from './handlers/outbound-fetch.js';
+import * as patternSet from './handlers/pattern-set.js';
 import * as responseClone from './handlers/response-clone.js';
+import * as router from './handlers/router.js';
 import * as secret from './handlers/secret.js';
 
-const app = new Hono();
+// Handlers that read FetchEvent-only APIs (`event.cookies`, `event.client`) get the event
+// through Hono's env binding.
+const app = new Hono<{ Bindings: { event: FetchEvent } }>();
 
-const handlers = [env, outboundFetch, secret, echo, responseClone, multiChunkSource];
-handlers.forEach((m) => app.all(m.route, (c) => m.handler(c.req.raw)));
+const handlers = [
+  env,
+  outboundFetch,
+  secret,
+  echo,
+  responseClone,
+  multiChunkSource,
+  kvZrange,
+  kvGeoNearby,
+  kvClose,
+  kvMirror,
+  router,
+  cookies,
+  cidrSet,
+  ja3Set,
+  patternSet,
+  codec,
+];
+handlers.forEach((m) => app.all(m.route, (c) => m.handler(c.req.raw, c.env.event)));
 
-addEventListener('fetch', (event) => event.respondWith(app.fetch(event.request)));
+addEventListener('fetch', (event) => event.respondWith(app.fetch(event.request, { event })));
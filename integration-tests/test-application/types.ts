@@ -4,7 +4,7 @@ export interface CheckContext {
 
 export interface HandlerModule {
   route: string;
-  handler: (req: Request) => Promise<Response>;
+  handler: (req: Request, event: FetchEvent) => Promise<Response>;
 }
 
 export interface CheckModule {
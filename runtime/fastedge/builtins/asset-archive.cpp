@@ -0,0 +1,1049 @@
+#include "builtin.h"
+#include "encode.h"
+#include "fastedge.h"
+
+#include <js/Array.h>
+#include <js/ArrayBuffer.h>
+#include <js/RegExp.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fastedge::asset_archive {
+
+namespace {
+
+// A packed archive of static files, written by `fastedge-assets` (see
+// src/server/static-assets/asset-manifest/create-asset-archive.ts, which
+// documents the layout). All integers are little-endian u32.
+//
+//   header   magic "FEPK", version, entry count, then the offsets of the
+//            displacement table, entry table, string table and data, and
+//            the total length
+//   displacements  one i32 per entry: the minimal perfect hash
+//   entries  ENTRY_WORDS u32s per file, see `Field`
+//   strings  UTF-8 paths, content types, ETags and Last-Modified values
+//   data     file contents and precompressed variants, 8-byte aligned
+constexpr uint32_t MAGIC = 0x4b504546; // "FEPK"
+constexpr uint32_t VERSION = 2;
+constexpr size_t HEADER_WORDS = 8;
+constexpr size_t ENTRY_WORDS = 18;
+
+enum Header : size_t {
+  Magic,
+  Version,
+  EntryCount,
+  DisplacementsOffset,
+  EntriesOffset,
+  StringsOffset,
+  DataOffset,
+  TotalLength,
+};
+
+enum Field : size_t {
+  PathOffset,
+  PathLength,
+  DataStart,
+  DataLength,
+  ContentTypeOffset,
+  ContentTypeLength,
+  EtagOffset,
+  EtagLength,
+  LastModifiedOffset,
+  LastModifiedLength,
+  LastModifiedTime,
+  Flags,
+  // Start and length of each precompressed variant, in `Encoding` order;
+  // a length of 0 means there is none.
+  VariantsStart,
+};
+
+constexpr uint32_t FLAG_IS_TEXT = 1;
+
+// Precompressed variant encodings, in archive order (`ARCHIVE_ENCODINGS` in
+// compress-asset.ts).
+enum Encoding : uint32_t { Br, Gzip, Zstd, EncodingCount };
+constexpr const char *ENCODING_NAMES[EncodingCount] = {"br", "gzip", "zstd"};
+
+Field variant_start(Encoding encoding) { return Field(VariantsStart + encoding * 2); }
+Field variant_length(Encoding encoding) { return Field(VariantsStart + encoding * 2 + 1); }
+
+uint32_t read_u32(const uint8_t *p) {
+  return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+// FNV-1a with `seed` as the offset basis; seed 0 selects the standard one.
+// Must match `hashAssetPath` in create-asset-archive.ts.
+uint32_t hash_path(uint32_t seed, std::string_view path) {
+  uint32_t h = seed ? seed : 0x811c9dc5;
+  for (unsigned char c : path) {
+    h = (h ^ c) * 0x01000193;
+  }
+  return h;
+}
+
+// Options given to `AssetArchive.open` for `serve`, matching the static
+// server's `ServerConfig`. RegExp `extendedCache` entries are kept on the
+// archive object's ExtendedCacheRegExps slot.
+struct ServeConfig {
+  std::string route_prefix;
+  std::string public_dir_prefix;
+  std::vector<std::string> auto_ext;
+  std::vector<std::string> auto_index;
+  std::vector<std::string> extended_cache;
+  uint32_t compression = 0;  // Bitmask of `Encoding`s that may be served
+};
+
+class Archive {
+public:
+  // Validates the layout of `bytes` so lookups can index it unchecked.
+  static std::unique_ptr<Archive> open(const uint8_t *bytes, size_t size, const char **error) {
+    auto archive = std::unique_ptr<Archive>(new Archive(bytes));
+    if (size < HEADER_WORDS * 4 || archive->header(Magic) != MAGIC) {
+      *error = "not an asset archive";
+      return nullptr;
+    }
+    if (archive->header(Version) != VERSION) {
+      *error = "unsupported archive version";
+      return nullptr;
+    }
+    uint64_t count = archive->count_ = archive->header(EntryCount);
+    uint64_t strings = archive->header(StringsOffset);
+    uint64_t data = archive->header(DataOffset);
+    if (archive->header(TotalLength) != size ||
+        archive->header(DisplacementsOffset) + count * 4 > size ||
+        archive->header(EntriesOffset) + count * ENTRY_WORDS * 4 > size || strings > data ||
+        data > size) {
+      *error = "archive is truncated or corrupt";
+      return nullptr;
+    }
+    uint64_t strings_length = data - strings;
+    uint64_t data_length = size - data;
+    for (uint32_t i = 0; i < count; i++) {
+      for (Field field : {PathOffset, ContentTypeOffset, EtagOffset, LastModifiedOffset}) {
+        if (uint64_t(archive->field(i, field)) + archive->field(i, Field(field + 1)) >
+            strings_length) {
+          *error = "archive string table is corrupt";
+          return nullptr;
+        }
+      }
+      if (uint64_t(archive->field(i, DataStart)) + archive->field(i, DataLength) > data_length) {
+        *error = "archive data is corrupt";
+        return nullptr;
+      }
+      for (uint32_t e = 0; e < EncodingCount; e++) {
+        if (uint64_t(archive->field(i, variant_start(Encoding(e)))) +
+                archive->field(i, variant_length(Encoding(e))) >
+            data_length) {
+          *error = "archive data is corrupt";
+          return nullptr;
+        }
+      }
+    }
+    return archive;
+  }
+
+  uint32_t size() const { return count_; }
+
+  ServeConfig &config() { return config_; }
+  const ServeConfig &config() const { return config_; }
+
+  // Index of the entry for `path`, or -1. One hash to pick a bucket, at
+  // most one more through its displacement, then a single comparison.
+  int64_t find(std::string_view path) const {
+    if (count_ == 0) return -1;
+    auto displacement = static_cast<int32_t>(
+        read_u32(bytes_ + header(DisplacementsOffset) + (hash_path(0, path) % count_) * 4));
+    uint32_t index = displacement < 0 ? uint32_t(-(displacement + 1))
+                                      : hash_path(uint32_t(displacement), path) % count_;
+    if (index >= count_ || string(index, PathOffset) != path) return -1;
+    return index;
+  }
+
+  uint32_t field(uint32_t index, Field f) const {
+    return read_u32(bytes_ + header(EntriesOffset) + (size_t(index) * ENTRY_WORDS + f) * 4);
+  }
+
+  // The string whose offset is in `f` and length in the field after it.
+  std::string_view string(uint32_t index, Field f) const {
+    return {reinterpret_cast<const char *>(bytes_ + header(StringsOffset) + field(index, f)),
+            field(index, Field(f + 1))};
+  }
+
+  const uint8_t *data(uint32_t index) const {
+    return bytes_ + header(DataOffset) + field(index, DataStart);
+  }
+
+  // The precompressed variant of entry `index`; its size is 0 if there is none.
+  const uint8_t *variant(uint32_t index, Encoding encoding, uint32_t *size) const {
+    *size = field(index, variant_length(encoding));
+    return bytes_ + header(DataOffset) + field(index, variant_start(encoding));
+  }
+
+  // Content types repeat across files; each distinct one is a pinned atom.
+  JSString *content_type(JSContext *cx, uint32_t index) {
+    std::string_view type = string(index, ContentTypeOffset);
+    auto cached = content_types_.find(type);
+    if (cached != content_types_.end()) return cached->second;
+    JSString *atom = JS_AtomizeAndPinStringN(cx, type.data(), type.size());
+    if (atom) content_types_.emplace(type, atom);
+    return atom;
+  }
+
+private:
+  explicit Archive(const uint8_t *bytes) : bytes_(bytes) {}
+
+  uint32_t header(Header h) const { return read_u32(bytes_ + h * 4); }
+
+  const uint8_t *bytes_;  // Private copy of the archive file; never freed.
+  uint32_t count_ = 0;
+  ServeConfig config_;
+  std::unordered_map<std::string_view, JSString *> content_types_;
+};
+
+api::Engine *ENGINE;
+JS::PersistentRooted<JSObject *> *ASSET_ARCHIVE_PROTO;
+
+class AssetArchiveObject {
+public:
+  enum class Slot : uint32_t {
+    Archive,               // PrivateValue(Archive*)
+    ExtendedCacheRegExps,  // Array of RegExp, or undefined
+    Count
+  };
+
+  static const JSClass class_;
+  static const JSFunctionSpec methods[];
+  static const JSPropertySpec properties[];
+
+  static bool open(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool get(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool has(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool keys(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool serve(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool size_get(JSContext *cx, unsigned argc, JS::Value *vp);
+
+  static void finalize(JS::GCContext *gcx, JSObject *obj);
+};
+
+static const JSClassOps asset_archive_class_ops = {
+    .finalize = AssetArchiveObject::finalize,
+};
+
+const JSClass AssetArchiveObject::class_ = {
+    "AssetArchive",
+    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(AssetArchiveObject::Slot::Count)) |
+        JSCLASS_FOREGROUND_FINALIZE,
+    &asset_archive_class_ops
+};
+
+const JSFunctionSpec AssetArchiveObject::methods[] = {
+    JS_FN("get", AssetArchiveObject::get, 1, JSPROP_ENUMERATE),
+    JS_FN("has", AssetArchiveObject::has, 1, JSPROP_ENUMERATE),
+    JS_FN("keys", AssetArchiveObject::keys, 0, JSPROP_ENUMERATE),
+    JS_FN("serve", AssetArchiveObject::serve, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+const JSPropertySpec AssetArchiveObject::properties[] = {
+    JS_PSG("size", AssetArchiveObject::size_get, JSPROP_ENUMERATE),
+    JS_PS_END,
+};
+
+Archive *archive_of(JSObject *obj) {
+  if (!obj || JS::GetClass(obj) != &AssetArchiveObject::class_) return nullptr;
+  JS::Value v = JS::GetReservedSlot(obj, static_cast<uint32_t>(AssetArchiveObject::Slot::Archive));
+  if (v.isUndefined()) return nullptr;
+  return static_cast<Archive *>(v.toPrivate());
+}
+
+Archive *this_archive(JSContext *cx, JS::CallArgs &args, const char *fn_name) {
+  Archive *archive = args.thisv().isObject() ? archive_of(&args.thisv().toObject()) : nullptr;
+  if (!archive) JS_ReportErrorUTF8(cx, "%s: receiver must be an AssetArchive", fn_name);
+  return archive;
+}
+
+void AssetArchiveObject::finalize(JS::GCContext *gcx, JSObject *obj) {
+  delete archive_of(obj);
+}
+
+bool read_string_option(JSContext *cx, JS::HandleObject options, const char *name,
+                        std::string *out) {
+  JS::RootedValue value(cx);
+  if (!JS_GetProperty(cx, options, name, &value)) return false;
+  if (value.isNullOrUndefined()) return true;
+  auto chars = core::encode(cx, value);
+  if (!chars) return false;
+  out->assign(chars.begin(), chars.size());
+  return true;
+}
+
+// Reads an array option of strings into `out`. With `regexps`, RegExp
+// entries are collected there instead of being stringified.
+bool read_string_list_option(JSContext *cx, JS::HandleObject options, const char *name,
+                             std::vector<std::string> *out,
+                             JS::RootedObject *regexps = nullptr) {
+  JS::RootedValue value(cx);
+  if (!JS_GetProperty(cx, options, name, &value)) return false;
+  if (value.isNullOrUndefined()) return true;
+
+  bool is_array;
+  if (!JS::IsArrayObject(cx, value, &is_array)) return false;
+  if (!is_array) {
+    JS_ReportErrorUTF8(cx, "AssetArchive.open: options.%s must be an array", name);
+    return false;
+  }
+  JS::RootedObject array(cx, &value.toObject());
+  uint32_t length;
+  if (!JS::GetArrayLength(cx, array, &length)) return false;
+
+  JS::RootedValue item(cx);
+  for (uint32_t i = 0; i < length; i++) {
+    if (!JS_GetElement(cx, array, i, &item)) return false;
+    if (regexps && item.isObject()) {
+      JS::RootedObject item_obj(cx, &item.toObject());
+      bool is_regexp;
+      if (!JS::ObjectIsRegExp(cx, item_obj, &is_regexp)) return false;
+      if (is_regexp) {
+        if (!*regexps) {
+          *regexps = JS::NewArrayObject(cx, 0);
+          if (!*regexps) return false;
+        }
+        uint32_t count;
+        if (!JS::GetArrayLength(cx, *regexps, &count) ||
+            !JS_SetElement(cx, *regexps, count, item)) {
+          return false;
+        }
+        continue;
+      }
+    }
+    auto chars = core::encode(cx, item);
+    if (!chars) return false;
+    out->emplace_back(chars.begin(), chars.size());
+  }
+  return true;
+}
+
+bool AssetArchiveObject::open(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  INIT_ONLY("AssetArchive.open");
+  if (!args.requireAtLeast(cx, "AssetArchive.open", 1)) return false;
+
+  auto path = core::encode(cx, args[0]);
+  if (!path) return false;
+
+  // The archive reads its own copy of the file, outside the GC heap, and
+  // serves entries straight from it. `readFileSync` hands out writable
+  // views of its copies, and a write into the index after validation would
+  // turn the unchecked lookups below into out-of-bounds reads.
+  const uint8_t *bytes;
+  size_t size;
+  if (!::fastedge::fastedge::read_private_file(cx, std::string_view(path.begin(), path.size()),
+                                               &bytes, &size)) {
+    return false;
+  }
+
+  const char *error = nullptr;
+  auto archive = Archive::open(bytes, size, &error);
+  if (!archive) {
+    JS_ReportErrorUTF8(cx, "AssetArchive.open: %s: %s", path.begin(), error);
+    return false;
+  }
+
+  JS::RootedObject regexps(cx);
+  if (args.get(1).isObject()) {
+    JS::RootedObject options(cx, &args[1].toObject());
+    ServeConfig &config = archive->config();
+    if (!read_string_option(cx, options, "routePrefix", &config.route_prefix) ||
+        !read_string_option(cx, options, "publicDirPrefix", &config.public_dir_prefix) ||
+        !read_string_list_option(cx, options, "autoExt", &config.auto_ext) ||
+        !read_string_list_option(cx, options, "autoIndex", &config.auto_index) ||
+        !read_string_list_option(cx, options, "extendedCache", &config.extended_cache,
+                                 &regexps)) {
+      return false;
+    }
+
+    // Unknown encodings are ignored, as `findAcceptEncodings` would never
+    // find a variant for them either.
+    std::vector<std::string> compression;
+    if (!read_string_list_option(cx, options, "compression", &compression)) return false;
+    for (const auto &name : compression) {
+      for (uint32_t e = 0; e < EncodingCount; e++) {
+        if (name == ENCODING_NAMES[e]) config.compression |= 1u << e;
+      }
+    }
+  }
+
+  JS::RootedObject proto(cx, *ASSET_ARCHIVE_PROTO);
+  JS::RootedObject obj(cx, JS_NewObjectWithGivenProto(cx, &AssetArchiveObject::class_, proto));
+  if (!obj) return false;
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(Slot::Archive),
+                      JS::PrivateValue(archive.release()));
+  if (regexps) {
+    JS::SetReservedSlot(obj, static_cast<uint32_t>(Slot::ExtendedCacheRegExps),
+                        JS::ObjectValue(*regexps));
+  }
+
+  args.rval().setObject(*obj);
+  return true;
+}
+
+bool new_utf8_string(JSContext *cx, std::string_view text, JS::MutableHandleValue rval) {
+  JSString *str = JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(text.data(), text.size()));
+  if (!str) return false;
+  rval.setString(str);
+  return true;
+}
+
+// A Uint8Array holding a copy of archive bytes. The archive's own bytes
+// are never handed to JS: a write through a view would change what later
+// requests are served, and the unchecked index lookups rely on them.
+JSObject *new_bytes(JSContext *cx, const uint8_t *data, size_t size) {
+  JSObject *array = JS_NewUint8Array(cx, size);
+  if (!array) return nullptr;
+  if (size > 0) {
+    JS::AutoCheckCannotGC noGC(cx);
+    bool is_shared;
+    void *dst = JS_GetArrayBufferViewData(array, &is_shared, noGC);
+    memcpy(dst, data, size);
+  }
+  return array;
+}
+
+// `{ body, size, contentType, etag, lastModified, lastModifiedTime, isText,
+// encodings }` for entry `index`. `body` and the `encodings` variants are
+// copies of the archive's bytes.
+JSObject *new_entry(JSContext *cx, Archive *archive, uint32_t index) {
+  JS::RootedObject entry(cx, JS_NewPlainObject(cx));
+  if (!entry) return nullptr;
+
+  uint32_t size = archive->field(index, DataLength);
+  JS::RootedObject body(cx, new_bytes(cx, archive->data(index), size));
+  if (!body) return nullptr;
+
+  JS::RootedValue value(cx, JS::ObjectValue(*body));
+  if (!JS_DefineProperty(cx, entry, "body", value, JSPROP_ENUMERATE)) return nullptr;
+
+  value.setNumber(size);
+  if (!JS_DefineProperty(cx, entry, "size", value, JSPROP_ENUMERATE)) return nullptr;
+
+  JSString *content_type = archive->content_type(cx, index);
+  if (!content_type) return nullptr;
+  value.setString(content_type);
+  if (!JS_DefineProperty(cx, entry, "contentType", value, JSPROP_ENUMERATE)) return nullptr;
+
+  if (!new_utf8_string(cx, archive->string(index, EtagOffset), &value) ||
+      !JS_DefineProperty(cx, entry, "etag", value, JSPROP_ENUMERATE)) {
+    return nullptr;
+  }
+
+  std::string_view last_modified = archive->string(index, LastModifiedOffset);
+  if (last_modified.empty()) {
+    value.setNull();
+  } else if (!new_utf8_string(cx, last_modified, &value)) {
+    return nullptr;
+  }
+  if (!JS_DefineProperty(cx, entry, "lastModified", value, JSPROP_ENUMERATE)) return nullptr;
+
+  value.setNumber(archive->field(index, LastModifiedTime));
+  if (!JS_DefineProperty(cx, entry, "lastModifiedTime", value, JSPROP_ENUMERATE)) return nullptr;
+
+  value.setBoolean(archive->field(index, Flags) & FLAG_IS_TEXT);
+  if (!JS_DefineProperty(cx, entry, "isText", value, JSPROP_ENUMERATE)) return nullptr;
+
+  JS::RootedObject encodings(cx, JS_NewPlainObject(cx));
+  if (!encodings) return nullptr;
+  for (uint32_t e = 0; e < EncodingCount; e++) {
+    uint32_t variant_size;
+    const uint8_t *variant = archive->variant(index, Encoding(e), &variant_size);
+    if (variant_size == 0) continue;
+    JSObject *view = new_bytes(cx, variant, variant_size);
+    if (!view) return nullptr;
+    value.setObject(*view);
+    if (!JS_DefineProperty(cx, encodings, ENCODING_NAMES[e], value, JSPROP_ENUMERATE)) {
+      return nullptr;
+    }
+  }
+  value.setObject(*encodings);
+  if (!JS_DefineProperty(cx, entry, "encodings", value, JSPROP_ENUMERATE)) return nullptr;
+
+  return entry;
+}
+
+bool AssetArchiveObject::get(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  Archive *archive = this_archive(cx, args, "AssetArchive.get");
+  if (!archive) return false;
+
+  auto path = core::encode(cx, args.get(0));
+  if (!path) return false;
+
+  int64_t index = archive->find(std::string_view(path.begin(), path.size()));
+  if (index < 0) {
+    args.rval().setNull();
+    return true;
+  }
+
+  JSObject *entry = new_entry(cx, archive, uint32_t(index));
+  if (!entry) return false;
+  args.rval().setObject(*entry);
+  return true;
+}
+
+bool AssetArchiveObject::has(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  Archive *archive = this_archive(cx, args, "AssetArchive.has");
+  if (!archive) return false;
+
+  auto path = core::encode(cx, args.get(0));
+  if (!path) return false;
+
+  args.rval().setBoolean(archive->find(std::string_view(path.begin(), path.size())) >= 0);
+  return true;
+}
+
+bool AssetArchiveObject::keys(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  Archive *archive = this_archive(cx, args, "AssetArchive.keys");
+  if (!archive) return false;
+
+  JS::RootedObject array(cx, JS::NewArrayObject(cx, archive->size()));
+  if (!array) return false;
+  JS::RootedValue key(cx);
+  for (uint32_t i = 0; i < archive->size(); i++) {
+    if (!new_utf8_string(cx, archive->string(i, PathOffset), &key) ||
+        !JS_SetElement(cx, array, i, key)) {
+      return false;
+    }
+  }
+
+  args.rval().setObject(*array);
+  return true;
+}
+
+// The path of a request URL, without query string or fragment; the same
+// string as `new URL(url).pathname` for the absolute URLs requests carry.
+std::string_view url_path(std::string_view url) {
+  size_t scheme = url.find("://");
+  if (scheme != std::string_view::npos) {
+    size_t path_start = url.find_first_of("/?#", scheme + 3);
+    if (path_start == std::string_view::npos || url[path_start] != '/') return "/";
+    url = url.substr(path_start);
+  }
+  size_t end = url.find_first_of("?#");
+  return end == std::string_view::npos ? url : url.substr(0, end);
+}
+
+// The entry `getMatchingAsset` in static-server.ts would pick for `path`:
+// an exact match, then `autoExt` suffixes, then `autoIndex` files.
+int64_t find_matching_entry(const Archive &archive, std::string_view path) {
+  const ServeConfig &config = archive.config();
+  std::string key(path);
+  if (!config.route_prefix.empty()) {
+    size_t pos = key.find(config.route_prefix);
+    if (pos != std::string::npos) key.erase(pos, config.route_prefix.size());
+  }
+  key.insert(0, config.public_dir_prefix);
+  if (key.empty() || key.front() != '/') key.insert(0, 1, '/');
+
+  if (key.back() != '/') {
+    int64_t index = archive.find(key);
+    if (index >= 0) return index;
+    for (const auto &ext : config.auto_ext) {
+      index = archive.find(key + ext);
+      if (index >= 0) return index;
+    }
+  }
+
+  if (!config.auto_index.empty()) {
+    while (!key.empty() && key.back() == '/') key.pop_back();
+    key.push_back('/');
+    for (const auto &index_file : config.auto_index) {
+      int64_t index = archive.find(key + index_file);
+      if (index >= 0) return index;
+    }
+  }
+  return -1;
+}
+
+// Whether `pathname` gets a year-long Cache-Control, as `testExtendedCache`
+// decides: exact paths, `/`-terminated prefixes, or RegExps.
+bool extended_cache(JSContext *cx, JS::HandleObject self, const ServeConfig &config,
+                    std::string_view pathname, bool *result) {
+  *result = false;
+  for (const auto &entry : config.extended_cache) {
+    if (!entry.empty() && entry.back() == '/' ? pathname.substr(0, entry.size()) == entry
+                                               : pathname == entry) {
+      *result = true;
+      return true;
+    }
+  }
+
+  JS::Value regexps_val =
+      JS::GetReservedSlot(self, static_cast<uint32_t>(AssetArchiveObject::Slot::ExtendedCacheRegExps));
+  if (regexps_val.isUndefined()) return true;
+
+  JS::RootedObject regexps(cx, &regexps_val.toObject());
+  uint32_t count;
+  if (!JS::GetArrayLength(cx, regexps, &count)) return false;
+  std::u16string chars(pathname.begin(), pathname.end());  // Paths are ASCII.
+  JS::RootedValue regexp(cx);
+  JS::RootedObject regexp_obj(cx);
+  JS::RootedValue match(cx);
+  for (uint32_t i = 0; i < count; i++) {
+    if (!JS_GetElement(cx, regexps, i, &regexp)) return false;
+    regexp_obj = &regexp.toObject();
+    size_t index = 0;
+    if (!JS::ExecuteRegExpNoStatics(cx, regexp_obj, chars.data(), chars.size(), &index, true,
+                                    &match)) {
+      return false;
+    }
+    if (match.isBoolean() && match.toBoolean()) {
+      *result = true;
+      return true;
+    }
+  }
+  return true;
+}
+
+// `headers.get(name)` as a UTF-8 string; nullopt when the header is absent.
+bool request_header(JSContext *cx, JS::HandleObject headers, const char *name,
+                    std::optional<std::string> *out) {
+  JS::RootedValueArray<1> get_args(cx);
+  JSString *name_str = JS_NewStringCopyZ(cx, name);
+  if (!name_str) return false;
+  get_args[0].setString(name_str);
+  JS::RootedValue value(cx);
+  if (!JS::Call(cx, headers, "get", get_args, &value)) return false;
+  if (value.isNullOrUndefined()) {
+    out->reset();
+    return true;
+  }
+  auto chars = core::encode(cx, value);
+  if (!chars) return false;
+  out->emplace(chars.begin(), chars.size());
+  return true;
+}
+
+std::string_view trim(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+  return text;
+}
+
+// Whether `tag`, an entity tag from a request, names `etag` under the weak
+// comparison If-None-Match uses. The static server sends the bare content
+// hash; quoted and weak forms of it match too.
+bool etag_matches(std::string_view tag, std::string_view etag) {
+  if (tag.substr(0, 2) == "W/") tag.remove_prefix(2);
+  if (tag.size() >= 2 && tag.front() == '"' && tag.back() == '"') {
+    tag = tag.substr(1, tag.size() - 2);
+  }
+  return tag == etag;
+}
+
+// Strong comparison (RFC 9110 §13.1.5), as If-Range requires: a weak tag
+// never matches, even with the same opaque value.
+bool etag_strong_matches(std::string_view tag, std::string_view etag) {
+  return tag.substr(0, 2) != "W/" && etag_matches(tag, etag);
+}
+
+// If-None-Match evaluates to false (the client's copy is current).
+bool none_match_fails(std::string_view header, std::string_view etag) {
+  while (!header.empty()) {
+    size_t comma = header.find(',');
+    std::string_view tag = trim(header.substr(0, comma));
+    if (tag == "*" || etag_matches(tag, etag)) return true;
+    if (comma == std::string_view::npos) break;
+    header.remove_prefix(comma + 1);
+  }
+  return false;
+}
+
+// Seconds since the epoch for an IMF-fixdate such as
+// "Sun, 06 Nov 1994 08:49:37 GMT", the only format HTTP/1.1 senders
+// generate. Anything else is treated as invalid and the header ignored.
+std::optional<int64_t> parse_http_date(std::string_view text) {
+  static constexpr std::string_view months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                                "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+  text = trim(text);
+  if (text.size() != 29 || text.substr(3, 2) != ", " || text.substr(25) != " GMT") {
+    return std::nullopt;
+  }
+  auto number = [&](size_t pos, size_t len) -> int {
+    int value = 0;
+    for (size_t i = pos; i < pos + len; i++) {
+      if (text[i] < '0' || text[i] > '9') return -1;
+      value = value * 10 + (text[i] - '0');
+    }
+    return value;
+  };
+  int day = number(5, 2), year = number(12, 4);
+  int hour = number(17, 2), minute = number(20, 2), second = number(23, 2);
+  int month = -1;
+  for (int m = 0; m < 12; m++) {
+    if (text.substr(8, 3) == months[m]) month = m + 1;
+  }
+  if (day < 1 || day > 31 || year < 0 || month < 0 || hour < 0 || hour > 23 || minute < 0 ||
+      minute > 59 || second < 0 || second > 60 || text[16] != ' ' || text[19] != ':' ||
+      text[22] != ':') {
+    return std::nullopt;
+  }
+
+  // Days from civil, http://howardhinnant.github.io/date_algorithms.html
+  int y = year - (month <= 2);
+  int era = (y >= 0 ? y : y - 399) / 400;
+  int yoe = y - era * 400;
+  int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  int64_t days = int64_t(era) * 146097 + doe - 719468;
+  return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+// A single `bytes=` range resolved against `size`. Multiple ranges and
+// other units aren't supported, and such requests get the whole file.
+enum class RangeResult { Ignore, Satisfiable, Unsatisfiable };
+
+RangeResult parse_range(std::string_view header, uint64_t size, uint64_t *start, uint64_t *end) {
+  header = trim(header);
+  if (header.substr(0, 6) != "bytes=") return RangeResult::Ignore;
+  header.remove_prefix(6);
+  if (header.find(',') != std::string_view::npos) return RangeResult::Ignore;
+  size_t dash = header.find('-');
+  if (dash == std::string_view::npos) return RangeResult::Ignore;
+
+  auto parse = [](std::string_view digits, uint64_t *out) {
+    digits = trim(digits);
+    if (digits.empty() || digits.size() > 15) return false;
+    *out = 0;
+    for (char c : digits) {
+      if (c < '0' || c > '9') return false;
+      *out = *out * 10 + (c - '0');
+    }
+    return true;
+  };
+
+  uint64_t first, last;
+  bool has_first = parse(header.substr(0, dash), &first);
+  bool has_last = parse(header.substr(dash + 1), &last);
+  if (!has_first && trim(header.substr(0, dash)).size()) return RangeResult::Ignore;
+  if (!has_last && trim(header.substr(dash + 1)).size()) return RangeResult::Ignore;
+  if (!has_first && !has_last) return RangeResult::Ignore;
+
+  if (!has_first) {
+    // Suffix range: the last `last` bytes.
+    if (last == 0 || size == 0) return RangeResult::Unsatisfiable;
+    *start = last >= size ? 0 : size - last;
+    *end = size - 1;
+    return RangeResult::Satisfiable;
+  }
+  if (has_last && last < first) return RangeResult::Ignore;
+  if (first >= size) return RangeResult::Unsatisfiable;
+  *start = first;
+  *end = has_last && last < size ? last : size - 1;
+  return RangeResult::Satisfiable;
+}
+
+// A q-value from the parameters of an Accept-Encoding element, scaled to
+// 0..1000 the way `findAcceptEncodings` reads it: a missing or malformed
+// value counts as 1, and out-of-range values are clamped.
+int parse_qvalue(std::string_view params) {
+  while (!params.empty()) {
+    size_t semi = params.find(';');
+    std::string_view param = trim(params.substr(0, semi));
+    if (param.size() >= 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+      std::string value(trim(param.substr(2)));
+      char *end;
+      double q = std::strtod(value.c_str(), &end);
+      if (end == value.c_str() || std::isnan(q) || q > 1) return 1000;
+      return q < 0 ? 0 : int(std::floor(q * 1000));
+    }
+    if (semi == std::string_view::npos) break;
+    params.remove_prefix(semi + 1);
+  }
+  return 1000;
+}
+
+bool equals_ignore_case(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    char c = a[i] >= 'A' && a[i] <= 'Z' ? char(a[i] - 'A' + 'a') : a[i];
+    if (c != b[i]) return false;
+  }
+  return true;
+}
+
+// The variant of entry `index` to serve for an Accept-Encoding header, or
+// EncodingCount for the original bytes. Only encodings in `available` (a
+// bitmask) are candidates: the highest q-value wins, ties go to the smaller
+// variant, and `*` covers encodings the header doesn't name.
+Encoding negotiate_encoding(std::string_view header, const Archive &archive, uint32_t index,
+                            uint32_t available) {
+  int qvalues[EncodingCount] = {-1, -1, -1};
+  int wildcard = 0;
+  while (!header.empty()) {
+    size_t comma = header.find(',');
+    std::string_view item = trim(header.substr(0, comma));
+    size_t semi = item.find(';');
+    std::string_view coding = trim(item.substr(0, semi));
+    int q = semi == std::string_view::npos ? 1000 : parse_qvalue(item.substr(semi + 1));
+    if (coding == "*") {
+      wildcard = q;
+    } else {
+      for (uint32_t e = 0; e < EncodingCount; e++) {
+        if (equals_ignore_case(coding, ENCODING_NAMES[e])) qvalues[e] = q;
+      }
+    }
+    if (comma == std::string_view::npos) break;
+    header.remove_prefix(comma + 1);
+  }
+
+  Encoding best = EncodingCount;
+  int best_q = 0;
+  uint32_t best_size = 0;
+  for (uint32_t e = 0; e < EncodingCount; e++) {
+    if (!(available & (1u << e))) continue;
+    int q = qvalues[e] >= 0 ? qvalues[e] : wildcard;
+    uint32_t size;
+    archive.variant(index, Encoding(e), &size);
+    if (q > best_q || (q > 0 && q == best_q && size < best_size)) {
+      best = Encoding(e);
+      best_q = q;
+      best_size = size;
+    }
+  }
+  return best;
+}
+
+bool set_header(JSContext *cx, JS::HandleObject headers, const char *name,
+                std::string_view value) {
+  JS::RootedValue value_val(cx);
+  return new_utf8_string(cx, value, &value_val) &&
+         JS_DefineProperty(cx, headers, name, value_val, JSPROP_ENUMERATE);
+}
+
+// `new Response(body, { status, headers })`.
+bool new_response(JSContext *cx, JS::HandleValue body, uint16_t status, JS::HandleObject headers,
+                  JS::MutableHandleValue rval) {
+  JS::RootedObject init(cx, JS_NewPlainObject(cx));
+  if (!init) return false;
+  JS::RootedValue value(cx, JS::Int32Value(status));
+  if (!JS_DefineProperty(cx, init, "status", value, JSPROP_ENUMERATE)) return false;
+  value.setObject(*headers);
+  if (!JS_DefineProperty(cx, init, "headers", value, JSPROP_ENUMERATE)) return false;
+
+  JS::RootedValue response_ctor_val(cx);
+  if (!JS_GetProperty(cx, ENGINE->global(), "Response", &response_ctor_val)) return false;
+  JS::RootedValueArray<2> ctor_args(cx);
+  ctor_args[0].set(body);
+  ctor_args[1].setObject(*init);
+  JS::RootedObject response(cx);
+  if (!JS::Construct(cx, response_ctor_val, ctor_args, &response)) return false;
+  rval.setObject(*response);
+  return true;
+}
+
+// Serves GET and HEAD requests for archived assets entirely in native code:
+// path matching, Accept-Encoding negotiation over precompressed variants,
+// If-None-Match / If-Modified-Since (304), Range / If-Range (206 / 416) and
+// the response itself. Returns null for other methods and
+// for paths with no asset, leaving fallbacks (SPA entrypoint, not-found
+// page) to the caller.
+bool AssetArchiveObject::serve(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  Archive *archive = this_archive(cx, args, "AssetArchive.serve");
+  if (!archive) return false;
+  JS::RootedObject self(cx, &args.thisv().toObject());
+
+  if (!args.get(0).isObject()) {
+    JS_ReportErrorUTF8(cx, "AssetArchive.serve: request must be a Request");
+    return false;
+  }
+  JS::RootedObject request(cx, &args[0].toObject());
+
+  JS::RootedValue value(cx);
+  if (!JS_GetProperty(cx, request, "method", &value)) return false;
+  auto method = core::encode(cx, value);
+  if (!method) return false;
+  std::string_view method_view(method.begin(), method.size());
+  bool is_head = method_view == "HEAD";
+  if (!is_head && method_view != "GET") {
+    args.rval().setNull();
+    return true;
+  }
+
+  if (!JS_GetProperty(cx, request, "url", &value)) return false;
+  auto url = core::encode(cx, value);
+  if (!url) return false;
+  std::string_view pathname = url_path(std::string_view(url.begin(), url.size()));
+
+  int64_t found = find_matching_entry(*archive, pathname);
+  if (found < 0) {
+    args.rval().setNull();
+    return true;
+  }
+  auto index = uint32_t(found);
+  const ServeConfig &config = archive->config();
+  std::string_view last_modified = archive->string(index, LastModifiedOffset);
+  uint32_t last_modified_time = archive->field(index, LastModifiedTime);
+
+  bool long_cache;
+  if (!extended_cache(cx, self, config, pathname, &long_cache)) return false;
+
+  JS::RootedValue headers_val(cx);
+  if (!JS_GetProperty(cx, request, "headers", &headers_val)) return false;
+  if (!headers_val.isObject()) {
+    JS_ReportErrorUTF8(cx, "AssetArchive.serve: request must be a Request");
+    return false;
+  }
+  JS::RootedObject request_headers(cx, &headers_val.toObject());
+
+  // Pick the representation: a precompressed variant the server config
+  // allows, or the original bytes. Each variant has its own ETag.
+  std::optional<std::string> header;
+  uint32_t available = 0;
+  for (uint32_t e = 0; e < EncodingCount; e++) {
+    uint32_t variant_size;
+    archive->variant(index, Encoding(e), &variant_size);
+    if ((config.compression & (1u << e)) && variant_size) available |= 1u << e;
+  }
+  Encoding encoding = EncodingCount;
+  if (available) {
+    if (!request_header(cx, request_headers, "Accept-Encoding", &header)) return false;
+    if (header) encoding = negotiate_encoding(*header, *archive, index, available);
+  }
+  std::string etag(archive->string(index, EtagOffset));
+  const uint8_t *data = archive->data(index);
+  uint64_t size = archive->field(index, DataLength);
+  if (encoding != EncodingCount) {
+    uint32_t variant_size;
+    data = archive->variant(index, encoding, &variant_size);
+    size = variant_size;
+    etag = etag + "-" + ENCODING_NAMES[encoding];
+  }
+
+  JS::RootedObject headers(cx, JS_NewPlainObject(cx));
+  if (!headers) return false;
+
+  // Preconditions, in RFC 9110 section 13.2.2 order. Both 304 paths keep
+  // only the validator and caching headers.
+  bool not_modified = false;
+  if (!request_header(cx, request_headers, "If-None-Match", &header)) return false;
+  if (header && !trim(*header).empty()) {
+    not_modified = none_match_fails(*header, etag);
+  } else {
+    if (!request_header(cx, request_headers, "If-Modified-Since", &header)) return false;
+    if (header) {
+      std::optional<int64_t> since = parse_http_date(*header);
+      not_modified = since && last_modified_time <= *since;
+    }
+  }
+
+  if (long_cache && !set_header(cx, headers, "Cache-Control", "max-age=31536000")) return false;
+  if (!set_header(cx, headers, "ETag", etag)) return false;
+  if (available && !set_header(cx, headers, "Vary", "Accept-Encoding")) return false;
+  if (not_modified) {
+    return new_response(cx, JS::NullHandleValue, 304, headers, args.rval());
+  }
+
+  JSString *content_type_str = archive->content_type(cx, index);
+  if (!content_type_str) return false;
+  JS::RootedValue content_type(cx, JS::StringValue(content_type_str));
+  if (!JS_DefineProperty(cx, headers, "Content-Type", content_type, JSPROP_ENUMERATE) ||
+      (!last_modified.empty() && !set_header(cx, headers, "Last-Modified", last_modified)) ||
+      !set_header(cx, headers, "Accept-Ranges", "bytes") ||
+      (encoding != EncodingCount &&
+       !set_header(cx, headers, "Content-Encoding", ENCODING_NAMES[encoding]))) {
+    return false;
+  }
+
+  // Range applies to GET only, and only if If-Range (when present) still
+  // names this representation.
+  uint64_t start = 0, end = size ? size - 1 : 0;
+  uint16_t status = 200;
+  if (!is_head) {
+    if (!request_header(cx, request_headers, "Range", &header)) return false;
+    if (header) {
+      std::optional<std::string> if_range;
+      if (!request_header(cx, request_headers, "If-Range", &if_range)) return false;
+      std::string_view validator = if_range ? trim(*if_range) : std::string_view();
+      bool range_applies = !if_range || etag_strong_matches(validator, etag) ||
+                           (!last_modified.empty() && validator == last_modified);
+      if (range_applies) {
+        switch (parse_range(*header, size, &start, &end)) {
+          case RangeResult::Ignore:
+            break;
+          case RangeResult::Satisfiable:
+            status = 206;
+            break;
+          case RangeResult::Unsatisfiable: {
+            if (!set_header(cx, headers, "Content-Range", "bytes */" + std::to_string(size))) {
+              return false;
+            }
+            return new_response(cx, JS::NullHandleValue, 416, headers, args.rval());
+          }
+        }
+      }
+    }
+  }
+
+  if (status == 206) {
+    std::string content_range = "bytes " + std::to_string(start) + "-" + std::to_string(end) +
+                                "/" + std::to_string(size);
+    if (!set_header(cx, headers, "Content-Range", content_range)) return false;
+  }
+
+  // Only the requested range is copied out of the archive.
+  uint64_t length = size ? end - start + 1 : 0;
+  JS::RootedObject body(cx, new_bytes(cx, data + start, length));
+  if (!body) return false;
+  JS::RootedValue body_val(cx, JS::ObjectValue(*body));
+  return new_response(cx, body_val, status, headers, args.rval());
+}
+
+bool AssetArchiveObject::size_get(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  Archive *archive = this_archive(cx, args, "AssetArchive.size");
+  if (!archive) return false;
+  args.rval().setNumber(archive->size());
+  return true;
+}
+
+const JSFunctionSpec asset_archive_static_methods[] = {
+    JS_FN("open", AssetArchiveObject::open, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+}  // namespace
+
+bool install(api::Engine *engine) {
+  ENGINE = engine;
+  JSContext *cx = engine->cx();
+
+  JS::RootedObject proto(cx, JS_NewPlainObject(cx));
+  if (!proto) return false;
+  if (!JS_DefineFunctions(cx, proto, AssetArchiveObject::methods) ||
+      !JS_DefineProperties(cx, proto, AssetArchiveObject::properties)) {
+    return false;
+  }
+  ASSET_ARCHIVE_PROTO = new JS::PersistentRooted<JSObject *>(cx, proto);
+
+  JS::RootedObject asset_archive_obj(cx, JS_NewPlainObject(cx));
+  if (!asset_archive_obj) return false;
+  if (!JS_DefineFunctions(cx, asset_archive_obj, asset_archive_static_methods)) return false;
+
+  if (!JS_DefineProperty(cx, engine->global(), "AssetArchive", asset_archive_obj, 0)) {
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace fastedge::asset_archive
@@ -378,6 +378,7 @@ bool Cache::get(JSContext *cx, unsigned argc, JS::Value *vp) {
   auto key = core::encode(cx, key_str);
   if (!key) return false;
 
+  host_api::HostArenaScope arena;
   auto result = host_api::cache_get(std::string_view(key.ptr.get(), key.len));
   if (!result.is_ok()) {
     throw_cache_error(cx, result.unwrap_err());
@@ -407,6 +408,7 @@ bool Cache::exists(JSContext *cx, unsigned argc, JS::Value *vp) {
   auto key = core::encode(cx, key_str);
   if (!key) return false;
 
+  host_api::HostArenaScope arena;
   auto result = host_api::cache_exists(std::string_view(key.ptr.get(), key.len));
   if (!result.is_ok()) {
     throw_cache_error(cx, result.unwrap_err());
@@ -426,6 +428,7 @@ bool Cache::delete_op(JSContext *cx, unsigned argc, JS::Value *vp) {
   auto key = core::encode(cx, key_str);
   if (!key) return false;
 
+  host_api::HostArenaScope arena;
   auto err = host_api::cache_delete(std::string_view(key.ptr.get(), key.len));
   if (err) {
     throw_cache_error(cx, *err);
@@ -590,6 +593,7 @@ bool Cache::getOrSet(JSContext *cx, unsigned argc, JS::Value *vp) {
   }
 
   // 4. Cache hit fast path: return resolved Promise<CacheEntry>.
+  host_api::HostArenaScope arena;
   auto cache_result = host_api::cache_get(std::string_view(key_chars.ptr.get(), key_chars.len));
   if (!cache_result.is_ok()) {
     throw_cache_error(cx, cache_result.unwrap_err());
@@ -696,6 +700,7 @@ bool Cache::expire(JSContext *cx, unsigned argc, JS::Value *vp) {
     return false;
   }
 
+  host_api::HostArenaScope arena;
   auto result = host_api::cache_expire(std::string_view(key.ptr.get(), key.len), *ttl_ms);
   if (!result.is_ok()) {
     throw_cache_error(cx, result.unwrap_err());
@@ -829,6 +834,7 @@ bool getOrSet_finalize(JSContext *cx, JS::HandleObject outer_promise,
   }
 
   host_api::CacheBytesView view{bytes, len};
+  host_api::HostArenaScope arena;
   auto err = host_api::cache_set(std::string_view(key_chars.ptr.get(), key_chars.len), view, ttl_ms);
   if (err) {
     throw_cache_error(cx, *err);
@@ -869,6 +875,7 @@ bool finish_set(JSContext *cx, JS::HandleObject outer_promise,
   if (!key_chars) return false;
 
   host_api::CacheBytesView view{bytes, len};
+  host_api::HostArenaScope arena;
   auto err = host_api::cache_set(std::string_view(key_chars.ptr.get(), key_chars.len), view, ttl_ms);
   if (err) {
     throw_cache_error(cx, *err);
@@ -1166,6 +1173,7 @@ bool incr_common(JSContext *cx, JS::CallArgs &args, const char *fn_name,
   }
   if (negate) delta = -delta;
 
+  host_api::HostArenaScope arena;
   auto result = host_api::cache_incr(std::string_view(key.ptr.get(), key.len), delta);
   if (!result.is_ok()) {
     throw_cache_error(cx, result.unwrap_err());
@@ -1190,6 +1198,7 @@ bool Cache::decr(JSContext *cx, unsigned argc, JS::Value *vp) {
 bool Cache::purge(JSContext *cx, unsigned argc, JS::Value *vp) {
   JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
 
+  host_api::HostArenaScope arena;
   auto result = host_api::cache_purge();
   if (!result.is_ok()) {
     throw_cache_error(cx, result.unwrap_err());
@@ -1209,6 +1218,7 @@ bool Cache::purge_prefix(JSContext *cx, unsigned argc, JS::Value *vp) {
   auto prefix = core::encode(cx, prefix_str);
   if (!prefix) return false;
 
+  host_api::HostArenaScope arena;
   auto result = host_api::cache_purge_prefix(std::string_view(prefix.ptr.get(), prefix.len));
   if (!result.is_ok()) {
     throw_cache_error(cx, result.unwrap_err());
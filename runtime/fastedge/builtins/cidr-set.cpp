@@ -0,0 +1,567 @@
+#include "cidr-set.h"
+#include "encode.h"
+
+#include <js/Array.h>
+#include <js/ArrayBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fastedge::cidr_set {
+
+namespace {
+
+// 128-bit unsigned integer holding an IPv6 address, most significant half
+// first so comparisons follow address order.
+struct U128 {
+  uint64_t hi;
+  uint64_t lo;
+};
+
+bool operator<(const U128 &a, const U128 &b) {
+  return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+bool operator<=(const U128 &a, const U128 &b) { return !(b < a); }
+
+// The value after `v`; false if `v` is already the largest value.
+bool successor(uint32_t v, uint32_t *out) {
+  if (v == UINT32_MAX) return false;
+  *out = v + 1;
+  return true;
+}
+
+bool successor(const U128 &v, U128 *out) {
+  if (v.lo != UINT64_MAX) {
+    *out = {v.hi, v.lo + 1};
+    return true;
+  }
+  if (v.hi == UINT64_MAX) return false;
+  *out = {v.hi + 1, 0};
+  return true;
+}
+
+uint32_t v4_value(const uint8_t *bytes) {
+  return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) |
+         (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+}
+
+U128 v6_value(const uint8_t *bytes) {
+  U128 v{0, 0};
+  for (size_t i = 0; i < 8; i++) v.hi = (v.hi << 8) | bytes[i];
+  for (size_t i = 8; i < 16; i++) v.lo = (v.lo << 8) | bytes[i];
+  return v;
+}
+
+// Inclusive address range covered by one or more prefixes.
+template <typename T> struct Range {
+  T first;
+  T last;
+};
+
+// Sort `ranges` and merge overlapping or adjacent ones, so each address
+// falls in at most one range and lookups are a single binary search.
+template <typename T> void coalesce(std::vector<Range<T>> *ranges) {
+  std::sort(ranges->begin(), ranges->end(),
+            [](const Range<T> &a, const Range<T> &b) { return a.first < b.first; });
+
+  size_t out = 0;
+  for (size_t i = 0; i < ranges->size(); i++) {
+    const Range<T> &r = (*ranges)[i];
+    if (out > 0) {
+      Range<T> &prev = (*ranges)[out - 1];
+      T after;
+      if (!successor(prev.last, &after) || r.first <= after) {
+        if (prev.last < r.last) prev.last = r.last;
+        continue;
+      }
+    }
+    (*ranges)[out++] = r;
+  }
+  ranges->resize(out);
+  ranges->shrink_to_fit();
+}
+
+template <typename T> bool in_ranges(const std::vector<Range<T>> &ranges, const T &v) {
+  auto it = std::upper_bound(ranges.begin(), ranges.end(), v,
+                             [](const T &value, const Range<T> &r) { return value < r.first; });
+  if (it == ranges.begin()) return false;
+  --it;
+  return v <= it->last;
+}
+
+// A compiled CidrSet. Prefixes are turned into address ranges, then sorted
+// and coalesced per family; a lookup is one binary search over a flat
+// array, which keeps a 100k-prefix set compact and cache-friendly.
+struct CidrTable {
+  std::vector<Range<uint32_t>> v4;
+  std::vector<Range<U128>> v6;
+  uint32_t prefixes = 0;
+
+  bool contains(const IpAddress &ip) const {
+    if (ip.v6) return in_ranges(v6, v6_value(ip.bytes));
+    return in_ranges(v4, v4_value(ip.bytes));
+  }
+};
+
+bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && is_space(s.front())) s.remove_prefix(1);
+  while (!s.empty() && is_space(s.back())) s.remove_suffix(1);
+  return s;
+}
+
+bool parse_ipv4(std::string_view s, uint8_t out[4]) {
+  size_t i = 0;
+  for (size_t part = 0; part < 4; part++) {
+    if (part > 0) {
+      if (i >= s.size() || s[i] != '.') return false;
+      i++;
+    }
+    size_t start = i;
+    unsigned v = 0;
+    while (i < s.size() && s[i] >= '0' && s[i] <= '9') {
+      if (i - start == 3) return false;
+      v = v * 10 + (s[i] - '0');
+      i++;
+    }
+    if (i == start || v > 255) return false;
+    out[part] = static_cast<uint8_t>(v);
+  }
+  return i == s.size();
+}
+
+int hex_digit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+bool parse_ipv6(std::string_view s, uint8_t out[16]) {
+  uint16_t groups[8];
+  size_t n = 0;
+  int gap = -1;  // Index in `groups` where `::` stands, if any.
+  size_t i = 0;
+
+  if (s.size() >= 2 && s[0] == ':' && s[1] == ':') {
+    gap = 0;
+    i = 2;
+  } else if (!s.empty() && s[0] == ':') {
+    return false;
+  }
+
+  while (i < s.size()) {
+    size_t colon = s.find(':', i);
+    std::string_view token = s.substr(i, colon == std::string_view::npos ? s.npos : colon - i);
+
+    // Trailing dotted-quad (`::ffff:1.2.3.4`) fills the last two groups.
+    if (token.find('.') != std::string_view::npos) {
+      if (colon != std::string_view::npos || n > 6) return false;
+      uint8_t v4[4];
+      if (!parse_ipv4(token, v4)) return false;
+      groups[n++] = static_cast<uint16_t>((v4[0] << 8) | v4[1]);
+      groups[n++] = static_cast<uint16_t>((v4[2] << 8) | v4[3]);
+      break;
+    }
+
+    if (token.empty() || token.size() > 4 || n == 8) return false;
+    uint16_t group = 0;
+    for (char c : token) {
+      int d = hex_digit(c);
+      if (d < 0) return false;
+      group = static_cast<uint16_t>((group << 4) | d);
+    }
+    groups[n++] = group;
+
+    i += token.size();
+    if (i == s.size()) break;
+    i++;  // ':'
+    if (i < s.size() && s[i] == ':') {
+      if (gap >= 0) return false;
+      gap = static_cast<int>(n);
+      i++;
+    } else if (i == s.size()) {
+      return false;
+    }
+  }
+
+  uint16_t full[8] = {0};
+  if (gap < 0) {
+    if (n != 8) return false;
+    std::copy(groups, groups + 8, full);
+  } else {
+    if (n > 7) return false;
+    std::copy(groups, groups + gap, full);
+    std::copy(groups + gap, groups + n, full + 8 - (n - gap));
+  }
+
+  for (size_t g = 0; g < 8; g++) {
+    out[2 * g] = static_cast<uint8_t>(full[g] >> 8);
+    out[2 * g + 1] = static_cast<uint8_t>(full[g]);
+  }
+  return true;
+}
+
+bool is_v4_mapped(const uint8_t bytes[16]) {
+  for (size_t i = 0; i < 10; i++) {
+    if (bytes[i] != 0) return false;
+  }
+  return bytes[10] == 0xff && bytes[11] == 0xff;
+}
+
+// Parse an address without unmapping IPv4-mapped IPv6.
+bool parse_ip_literal(std::string_view text, IpAddress *out) {
+  text = trim(text);
+  if (text.size() >= 2 && text.front() == '[' && text.back() == ']') {
+    text = text.substr(1, text.size() - 2);
+  }
+  if (text.find(':') == std::string_view::npos) {
+    out->v6 = false;
+    return parse_ipv4(text, out->bytes);
+  }
+  size_t zone = text.find('%');
+  if (zone != std::string_view::npos) text = text.substr(0, zone);
+  out->v6 = true;
+  return parse_ipv6(text, out->bytes);
+}
+
+void unmap_v4(IpAddress *ip) {
+  if (ip->v6 && is_v4_mapped(ip->bytes)) {
+    std::memmove(ip->bytes, ip->bytes + 12, 4);
+    ip->v6 = false;
+  }
+}
+
+// Add one `address[/length]` entry to `table`. A bare address is a
+// full-length prefix; host bits below the prefix length are ignored.
+bool add_prefix(CidrTable *table, std::string_view entry) {
+  std::string_view address = entry;
+  int length = -1;
+  size_t slash = entry.find('/');
+  if (slash != std::string_view::npos) {
+    address = entry.substr(0, slash);
+    std::string_view len_text = trim(entry.substr(slash + 1));
+    if (len_text.empty() || len_text.size() > 3) return false;
+    length = 0;
+    for (char c : len_text) {
+      if (c < '0' || c > '9') return false;
+      length = length * 10 + (c - '0');
+    }
+  }
+
+  IpAddress ip;
+  if (!parse_ip_literal(address, &ip)) return false;
+
+  // `::ffff:0:0/96` and longer cover IPv4 addresses; lookups unmap them.
+  if (ip.v6 && is_v4_mapped(ip.bytes) && (length < 0 || length >= 96)) {
+    unmap_v4(&ip);
+    if (length >= 0) length -= 96;
+  }
+
+  int bits = ip.v6 ? 128 : 32;
+  if (length < 0) length = bits;
+  if (length > bits) return false;
+
+  if (!ip.v6) {
+    uint32_t mask = length == 0 ? 0 : UINT32_MAX << (32 - length);
+    uint32_t first = v4_value(ip.bytes) & mask;
+    table->v4.push_back({first, first | ~mask});
+  } else {
+    U128 value = v6_value(ip.bytes);
+    uint64_t hi_mask = length == 0 ? 0 : length >= 64 ? UINT64_MAX : UINT64_MAX << (64 - length);
+    uint64_t lo_mask = length <= 64 ? 0 : length == 128 ? UINT64_MAX : UINT64_MAX << (128 - length);
+    U128 first{value.hi & hi_mask, value.lo & lo_mask};
+    table->v6.push_back({first, {first.hi | ~hi_mask, first.lo | ~lo_mask}});
+  }
+  table->prefixes++;
+  return true;
+}
+
+// Add every entry in `text`: entries are separated by newlines or commas,
+// and `#` starts a comment running to the end of the line.
+bool add_prefix_list(JSContext *cx, CidrTable *table, std::string_view text,
+                     uint32_t *entry_index) {
+  size_t pos = 0;
+  while (pos <= text.size()) {
+    size_t end = text.find('\n', pos);
+    if (end == std::string_view::npos) end = text.size();
+    std::string_view line = text.substr(pos, end - pos);
+    size_t comment = line.find('#');
+    if (comment != std::string_view::npos) line = line.substr(0, comment);
+
+    size_t item_pos = 0;
+    while (item_pos <= line.size()) {
+      size_t item_end = line.find(',', item_pos);
+      if (item_end == std::string_view::npos) item_end = line.size();
+      std::string_view item = trim(line.substr(item_pos, item_end - item_pos));
+      if (!item.empty()) {
+        if (!add_prefix(table, item)) {
+          std::string shown(item.substr(0, 64));
+          JS_ReportErrorUTF8(cx, "CidrSet.compile: invalid prefix '%s' (entry %u)",
+                             shown.c_str(), *entry_index);
+          return false;
+        }
+        (*entry_index)++;
+      }
+      item_pos = item_end + 1;
+    }
+    pos = end + 1;
+  }
+  return true;
+}
+
+bool read_bytes_text(JSContext *cx, JS::HandleObject obj, std::string *out) {
+  JS::AutoCheckCannotGC noGC(cx);
+  bool is_shared;
+  if (JS::IsArrayBufferObject(obj)) {
+    size_t len = JS::GetArrayBufferByteLength(obj);
+    if (len > 0) {
+      auto *src = static_cast<const char *>(JS::GetArrayBufferData(obj, &is_shared, noGC));
+      out->assign(src, len);
+    }
+    return true;
+  }
+  if (JS_IsArrayBufferViewObject(obj)) {
+    size_t len = JS_GetArrayBufferViewByteLength(obj);
+    if (len > 0) {
+      auto *src = static_cast<const char *>(JS_GetArrayBufferViewData(obj, &is_shared, noGC));
+      out->assign(src, len);
+    }
+    return true;
+  }
+  return false;
+}
+
+// Fill `table` from `source`: an array of prefix strings, a newline /
+// comma separated string, or the bytes of such a string (a file read with
+// readFileSync or a KV value).
+bool compile_source(JSContext *cx, JS::HandleValue source, CidrTable *table) {
+  uint32_t entry_index = 0;
+
+  if (source.isString()) {
+    auto text = core::encode(cx, source);
+    if (!text) return false;
+    return add_prefix_list(cx, table, std::string_view(text.ptr.get(), text.len), &entry_index);
+  }
+
+  if (source.isObject()) {
+    JS::RootedObject obj(cx, &source.toObject());
+
+    std::string text;
+    if (read_bytes_text(cx, obj, &text)) {
+      return add_prefix_list(cx, table, text, &entry_index);
+    }
+
+    bool is_array = false;
+    if (!JS::IsArrayObject(cx, source, &is_array)) return false;
+    if (is_array) {
+      uint32_t len;
+      if (!JS::GetArrayLength(cx, obj, &len)) return false;
+      JS::RootedValue item_val(cx);
+      JS::RootedString item_str(cx);
+      for (uint32_t i = 0; i < len; i++) {
+        if (!JS_GetElement(cx, obj, i, &item_val)) return false;
+        item_str = JS::ToString(cx, item_val);
+        if (!item_str) return false;
+        auto item = core::encode(cx, item_str);
+        if (!item) return false;
+        if (!add_prefix_list(cx, table, std::string_view(item.ptr.get(), item.len),
+                             &entry_index)) {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+
+  JS_ReportErrorUTF8(cx, "CidrSet.compile: source must be an array of prefixes, a string, "
+                         "an ArrayBuffer or an ArrayBufferView");
+  return false;
+}
+
+// Read the address argument of `contains`. Sets `*present` to false for
+// null / undefined / unparseable strings, which are never in the set.
+bool read_address(JSContext *cx, JS::HandleValue value, IpAddress *out, bool *present) {
+  *present = false;
+  if (value.isNullOrUndefined()) return true;
+
+  if (value.isString()) {
+    auto text = core::encode(cx, value);
+    if (!text) return false;
+    *present = parse_ip(std::string_view(text.ptr.get(), text.len), out);
+    return true;
+  }
+
+  if (value.isObject()) {
+    JS::RootedObject obj(cx, &value.toObject());
+    if (JS_IsArrayBufferViewObject(obj)) {
+      size_t len = JS_GetArrayBufferViewByteLength(obj);
+      if (len == 4 || len == 16) {
+        {
+          JS::AutoCheckCannotGC noGC(cx);
+          bool is_shared;
+          memcpy(out->bytes, JS_GetArrayBufferViewData(obj, &is_shared, noGC), len);
+        }
+        out->v6 = len == 16;
+        unmap_v4(out);
+        *present = true;
+        return true;
+      }
+    }
+  }
+
+  JS_ReportErrorUTF8(cx, "CidrSet.contains: address must be a string or a 4- or 16-byte "
+                         "Uint8Array");
+  return false;
+}
+
+JS::PersistentRooted<JSObject *> *CIDR_SET_PROTO = nullptr;
+
+// `CidrSet` instance. Owns its CidrTable; freed by the finalizer.
+class CidrSetObject {
+public:
+  enum class Slot : uint32_t {
+    Table,  // PrivateValue(CidrTable*)
+    Count
+  };
+
+  static const JSClass class_;
+  static const JSFunctionSpec methods[];
+  static const JSPropertySpec properties[];
+
+  static bool compile(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool contains(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool size_get(JSContext *cx, unsigned argc, JS::Value *vp);
+
+  static void finalize(JS::GCContext *gcx, JSObject *obj);
+};
+
+static const JSClassOps cidr_set_class_ops = {
+    .finalize = CidrSetObject::finalize,
+};
+
+const JSClass CidrSetObject::class_ = {
+    "CidrSet",
+    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(CidrSetObject::Slot::Count)) |
+        JSCLASS_FOREGROUND_FINALIZE,
+    &cidr_set_class_ops
+};
+
+const JSFunctionSpec CidrSetObject::methods[] = {
+    JS_FN("contains", CidrSetObject::contains, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+const JSPropertySpec CidrSetObject::properties[] = {
+    JS_PSG("size", CidrSetObject::size_get, JSPROP_ENUMERATE),
+    JS_PS_END,
+};
+
+CidrTable *cidr_table(JSObject *obj) {
+  if (!obj || JS::GetClass(obj) != &CidrSetObject::class_) return nullptr;
+  JS::Value v = JS::GetReservedSlot(obj, static_cast<uint32_t>(CidrSetObject::Slot::Table));
+  if (v.isUndefined()) return nullptr;
+  return static_cast<CidrTable *>(v.toPrivate());
+}
+
+CidrTable *this_table(JSContext *cx, JS::CallArgs &args, const char *fn_name) {
+  CidrTable *table = args.thisv().isObject() ? cidr_table(&args.thisv().toObject()) : nullptr;
+  if (!table) JS_ReportErrorUTF8(cx, "%s: receiver must be a CidrSet", fn_name);
+  return table;
+}
+
+void CidrSetObject::finalize(JS::GCContext *gcx, JSObject *obj) {
+  delete cidr_table(obj);
+}
+
+bool CidrSetObject::compile(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "CidrSet.compile", 1)) return false;
+
+  auto table = std::make_unique<CidrTable>();
+  if (!compile_source(cx, args[0], table.get())) return false;
+  coalesce(&table->v4);
+  coalesce(&table->v6);
+
+  JS::RootedObject proto(cx, *CIDR_SET_PROTO);
+  JS::RootedObject obj(cx, JS_NewObjectWithGivenProto(cx, &CidrSetObject::class_, proto));
+  if (!obj) return false;
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(Slot::Table),
+                      JS::PrivateValue(table.release()));
+
+  args.rval().setObject(*obj);
+  return true;
+}
+
+bool CidrSetObject::contains(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  CidrTable *table = this_table(cx, args, "CidrSet.contains");
+  if (!table) return false;
+
+  IpAddress ip;
+  bool present;
+  if (!read_address(cx, args.get(0), &ip, &present)) return false;
+  args.rval().setBoolean(present && table->contains(ip));
+  return true;
+}
+
+bool CidrSetObject::size_get(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  CidrTable *table = this_table(cx, args, "CidrSet.size");
+  if (!table) return false;
+  args.rval().setNumber(table->prefixes);
+  return true;
+}
+
+const JSFunctionSpec cidr_set_static_methods[] = {
+    JS_FN("compile", CidrSetObject::compile, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+}  // namespace
+
+bool parse_ip(std::string_view text, IpAddress *out) {
+  if (!parse_ip_literal(text, out)) return false;
+  unmap_v4(out);
+  return true;
+}
+
+JSObject *ip_to_bytes(JSContext *cx, const IpAddress &ip) {
+  JS::RootedObject byte_array(cx, JS_NewUint8Array(cx, ip.size()));
+  if (!byte_array) return nullptr;
+
+  JS::AutoCheckCannotGC noGC(cx);
+  bool is_shared;
+  void *dst = JS_GetArrayBufferViewData(byte_array, &is_shared, noGC);
+  memcpy(dst, ip.bytes, ip.size());
+  return byte_array;
+}
+
+bool install(api::Engine *engine) {
+  JSContext *cx = engine->cx();
+
+  JS::RootedObject proto(cx, JS_NewPlainObject(cx));
+  if (!proto) return false;
+  if (!JS_DefineFunctions(cx, proto, CidrSetObject::methods) ||
+      !JS_DefineProperties(cx, proto, CidrSetObject::properties)) {
+    return false;
+  }
+  CIDR_SET_PROTO = new JS::PersistentRooted<JSObject *>(cx, proto);
+
+  JS::RootedObject cidr_set_obj(cx, JS_NewPlainObject(cx));
+  if (!cidr_set_obj) return false;
+  if (!JS_DefineFunctions(cx, cidr_set_obj, cidr_set_static_methods)) return false;
+
+  if (!JS_DefineProperty(cx, engine->global(), "CidrSet", cidr_set_obj, 0)) {
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace fastedge::cidr_set
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "builtin.h"
+
+#include <cstdint>
+#include <string_view>
+
+namespace fastedge::cidr_set {
+
+// A parsed IPv4 or IPv6 address in network byte order. IPv4 addresses use
+// the first four bytes of `bytes`.
+struct IpAddress {
+  bool v6;
+  uint8_t bytes[16];
+
+  size_t size() const { return v6 ? 16 : 4; }
+};
+
+// Parse a textual IPv4 / IPv6 address. Surrounding whitespace, `[...]`
+// brackets and an IPv6 zone suffix (`%eth0`) are ignored. IPv4-mapped IPv6
+// addresses (`::ffff:a.b.c.d`) are returned as IPv4. Returns false if
+// `text` isn't an address.
+bool parse_ip(std::string_view text, IpAddress *out);
+
+// A new 4- or 16-byte Uint8Array holding `ip`.
+JSObject *ip_to_bytes(JSContext *cx, const IpAddress &ip);
+
+} // namespace fastedge::cidr_set
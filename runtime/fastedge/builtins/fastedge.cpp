@@ -1,6 +1,11 @@
 #include "fastedge.h"
 
 #include <cstdlib>
+#include <memory>
+#include <new>
+#include <unordered_map>
+
+#include <js/ArrayBuffer.h>
 
 #include "../host-api/include/fastedge_host_api.h"
 
@@ -17,6 +22,171 @@ static void oom_callback(JSContext *cx, void *data) {
   cerr << "Critical Error: out of memory" << endl;
 }
 
+// Environment variables and secrets don't change for the lifetime of an
+// instance, so each name is fetched from the host (and, for secrets,
+// decrypted) at most once. Values are kept as JS strings on null-prototype
+// objects keyed by name; a `null` entry records a name the host doesn't
+// have. A host error is returned as `null` but never cached, so the next
+// call asks the host again.
+//
+// Nothing is cached while wizening: values aren't available then, and must
+// not end up in the snapshot.
+JS::PersistentRooted<JSObject *> *ENV_CACHE;
+JS::PersistentRooted<JSObject *> *SECRET_CACHE;
+
+// Bounds the caches when names come from request data.
+constexpr size_t MAX_CACHED_VALUES = 4096;
+size_t CACHED_VALUES = 0;
+
+// `getSecretEffectiveAt` results also depend on the timestamp, and callers
+// typically pass the current time, so a new timestamp turns up every
+// second. Only the most recently used timestamps keep a cache: each slot
+// holds one timestamp's values, the least recently used slot is reused for
+// a new timestamp, and its values are released (and uncounted) then.
+// Slot `i`'s cache object is element `i` of SECRET_AT_CACHE.
+constexpr size_t SECRET_AT_SLOTS = 8;
+struct SecretAtSlot {
+  int32_t effective_at = -1;
+  uint64_t last_used = 0;
+  size_t cached_values = 0;
+};
+SecretAtSlot SECRET_AT[SECRET_AT_SLOTS];
+uint64_t SECRET_AT_CLOCK = 0;
+JS::PersistentRooted<JSObject *> *SECRET_AT_CACHE;
+
+// `counter`, if given, is incremented alongside CACHED_VALUES for each
+// value stored.
+template <typename Fetch>
+bool cached_host_value(JSContext *cx, JS::HandleObject cache, JS::HandleString name, Fetch fetch,
+                       JS::MutableHandleValue rval, size_t *counter = nullptr) {
+  JS::RootedId id(cx);
+  if (!JS_StringToId(cx, name, &id)) {
+    return false;
+  }
+  bool caching = !isWizening();
+  if (caching) {
+    if (!JS_GetPropertyById(cx, cache, id, rval)) {
+      return false;
+    }
+    if (!rval.isUndefined()) {
+      return true;
+    }
+  }
+
+  JS::UniqueChars name_chars = JS_EncodeStringToUTF8(cx, name);
+  if (!name_chars) {
+    return false;
+  }
+  host_api::HostArenaScope arena;
+  host_api::HostLookup lookup = fetch(name_chars.get());
+  if (!lookup.value.size()) {
+    rval.setNull();
+  } else {
+    JSString *str =
+        JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(lookup.value.begin(), lookup.value.size()));
+    if (!str) {
+      return false;
+    }
+    rval.setString(str);
+  }
+
+  if (caching && !lookup.failed && CACHED_VALUES < MAX_CACHED_VALUES) {
+    if (!JS_DefinePropertyById(cx, cache, id, rval, 0)) {
+      return false;
+    }
+    CACHED_VALUES++;
+    if (counter) {
+      (*counter)++;
+    }
+  }
+  return true;
+}
+
+bool env_value(JSContext *cx, JS::HandleString name, JS::MutableHandleValue rval) {
+  auto fetch = [](std::string_view name) {
+    return host_api::HostLookup{host_api::get_env_vars(name)};
+  };
+  return cached_host_value(cx, *ENV_CACHE, name, fetch, rval);
+}
+
+// The cache object for `effective_at`, claiming the least recently used
+// slot if no slot holds that timestamp yet.
+JSObject *secret_at_cache(JSContext *cx, int32_t effective_at, size_t **counter) {
+  SecretAtSlot *slot = &SECRET_AT[0];
+  for (auto &candidate : SECRET_AT) {
+    if (candidate.effective_at == effective_at) {
+      slot = &candidate;
+      break;
+    }
+    if (candidate.last_used < slot->last_used) {
+      slot = &candidate;
+    }
+  }
+  uint32_t index = static_cast<uint32_t>(slot - SECRET_AT);
+
+  JS::RootedValue cache_val(cx);
+  if (slot->effective_at == effective_at) {
+    if (!JS_GetElement(cx, *SECRET_AT_CACHE, index, &cache_val)) {
+      return nullptr;
+    }
+  } else {
+    JS::RootedObject fresh(cx, JS_NewObjectWithGivenProto(cx, nullptr, nullptr));
+    if (!fresh || !JS_SetElement(cx, *SECRET_AT_CACHE, index, fresh)) {
+      return nullptr;
+    }
+    CACHED_VALUES -= slot->cached_values;
+    slot->cached_values = 0;
+    slot->effective_at = effective_at;
+    cache_val.setObject(*fresh);
+  }
+  slot->last_used = ++SECRET_AT_CLOCK;
+  *counter = &slot->cached_values;
+  return &cache_val.toObject();
+}
+
+// `fastedge.env`: environment variables as properties. The dictionary can
+// only be queried by name, so properties are resolved on first access and
+// then defined as plain data properties; later reads of the same name never
+// leave the engine.
+bool env_object_resolve(JSContext *cx, JS::HandleObject obj, JS::HandleId id, bool *resolvedp) {
+  *resolvedp = false;
+  if (!id.isString() || isWizening()) {
+    return true;
+  }
+  JS::RootedString name(cx, id.toString());
+  JS::RootedValue value(cx);
+  if (!env_value(cx, name, &value)) {
+    return false;
+  }
+  if (value.isNull()) {
+    return true;
+  }
+  if (!JS_DefinePropertyById(cx, obj, id, value, JSPROP_ENUMERATE | JSPROP_READONLY)) {
+    return false;
+  }
+  *resolvedp = true;
+  return true;
+}
+
+bool env_object_may_resolve(const JSAtomState &, jsid id, JSObject *) { return id.isString(); }
+
+const JSClassOps env_object_class_ops = {
+    .resolve = env_object_resolve,
+    .mayResolve = env_object_may_resolve,
+};
+
+const JSClass env_object_class = {"Env", 0, &env_object_class_ops};
+
+// Files read by `readFileSync`, keyed by path. The bytes live outside the
+// GC heap for the lifetime of the instance (they're part of the snapshot's
+// linear memory), and every `readFileSync` result is a view of them rather
+// than a copy, so embedded assets aren't duplicated into the JS heap.
+struct EmbeddedFile {
+  uint8_t *data;
+  size_t size;
+};
+std::unordered_map<std::string, EmbeddedFile> EMBEDDED_FILES;
+
 } // namespace
 
 bool debug_logging_enabled() { return DEBUG_LOGGING_ENABLED; }
@@ -38,22 +208,71 @@ bool FastEdge::getEnv(JSContext* cx, unsigned argc, JS::Value* vp) {
   if (!jsKey) {
     return false;
   }
-  // Encode the JS string to a C++ string
-  JS::UniqueChars keyChars = JS_EncodeStringToUTF8(cx, jsKey);
-  if (!keyChars) {
+  return env_value(cx, jsKey, args.rval());
+}
+
+bool FastEdge::getEnvObject(JSContext* cx, unsigned argc, JS::Value* vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  args.rval().setObject(*env);
+  return true;
+}
+
+
+namespace {
+
+// Read the file at `path` into a new buffer outside the GC heap.
+bool read_file(JSContext *cx, const std::string &path, std::unique_ptr<uint8_t[]> *bytes,
+               size_t *size) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    JS_ReportErrorUTF8(cx, "Error opening file: %s", path.c_str());
     return false;
   }
-  auto envValue = host_api::get_env_vars(keyChars.get());
-  if (!envValue.size()) {
-    args.rval().setNull();
-    return true;
+
+  size_t file_size = file.tellg();
+  file.seekg(0, std::ios::beg);
+
+  bytes->reset(new (std::nothrow) uint8_t[file_size ? file_size : 1]);
+  if (!*bytes) {
+    JS_ReportOutOfMemory(cx);
+    return false;
   }
+  if (!file.read(reinterpret_cast<char *>(bytes->get()), file_size)) {
+    JS_ReportErrorUTF8(cx, "Error reading contents of file: %s", path.c_str());
+    return false;
+  }
+  *size = file_size;
+  return true;
+}
+
+} // namespace
 
-  JS::RootedString envValueStr(cx, JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(envValue.begin(), envValue.size())));
-  args.rval().setString(envValueStr);
+bool read_embedded_file(JSContext *cx, std::string_view path, const uint8_t **data, size_t *size) {
+  std::string key(path);
+  auto entry = EMBEDDED_FILES.find(key);
+  if (entry == EMBEDDED_FILES.end()) {
+    // Read straight into the file's final, never-freed home.
+    std::unique_ptr<uint8_t[]> bytes;
+    size_t file_size;
+    if (!read_file(cx, key, &bytes, &file_size)) {
+      return false;
+    }
+    entry = EMBEDDED_FILES.emplace(std::move(key), EmbeddedFile{bytes.release(), file_size}).first;
+  }
+
+  *data = entry->second.data;
+  *size = entry->second.size;
   return true;
 }
 
+bool read_private_file(JSContext *cx, std::string_view path, const uint8_t **data, size_t *size) {
+  std::unique_ptr<uint8_t[]> bytes;
+  if (!read_file(cx, std::string(path), &bytes, size)) {
+    return false;
+  }
+  *data = bytes.release();
+  return true;
+}
 
 bool FastEdge::readFileSync(JSContext *cx, unsigned argc, JS::Value *vp) {
   JS::CallArgs args = CallArgsFromVp(argc, vp);
@@ -67,32 +286,20 @@ bool FastEdge::readFileSync(JSContext *cx, unsigned argc, JS::Value *vp) {
     return false;
   }
 
-  std::ifstream file(std::string(path), std::ios::binary | std::ios::ate);
-  if (!file) {
-    JS_ReportErrorUTF8(cx, "Error opening file: %s", path.begin());
+  const uint8_t *data;
+  size_t size;
+  if (!read_embedded_file(cx, std::string_view(path.begin(), path.size()), &data, &size)) {
     return false;
   }
 
-  size_t file_size = file.tellg();
-  file.seekg(0, std::ios::beg);
-
-  std::vector<char> buffer(file_size);
-  if (!file.read(buffer.data(), file_size)) {
-    JS_ReportErrorUTF8(cx, "Error reading contents of file: %s", path.begin());
+  JS::RootedObject buffer(cx, JS::NewArrayBufferWithUserOwnedContents(cx, size, const_cast<uint8_t *>(data)));
+  if (!buffer)
     return false;
-  }
 
-  JS::RootedObject byte_array(cx, JS_NewUint8Array(cx, file_size));
+  JS::RootedObject byte_array(cx, JS_NewUint8ArrayWithBuffer(cx, buffer, 0, size));
   if (!byte_array)
     return false;
 
-  {
-    JS::AutoCheckCannotGC noGC(cx);
-    bool is_shared;
-    void *array_buffer = JS_GetArrayBufferViewData(byte_array, &is_shared, noGC);
-    memcpy(array_buffer, buffer.data(), file_size);
-  }
-
   args.rval().setObject(*byte_array);
   return true;
 }
@@ -108,20 +315,7 @@ bool FastEdge::getSecret(JSContext* cx, unsigned argc, JS::Value* vp) {
   if (!jsKey) {
     return false;
   }
-  // Encode the JS string to a C++ string
-  JS::UniqueChars keyChars = JS_EncodeStringToUTF8(cx, jsKey);
-  if (!keyChars) {
-    return false;
-  }
-  auto secretValue = host_api::get_secret_vars(keyChars.get());
-  if (!secretValue.size()) {
-    args.rval().setNull();
-    return true;
-  }
-
-  JS::RootedString secretValueStr(cx, JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(secretValue.begin(), secretValue.size())));
-  args.rval().setString(secretValueStr);
-  return true;
+  return cached_host_value(cx, *SECRET_CACHE, jsKey, host_api::get_secret_vars, args.rval());
 }
 
 bool FastEdge::getSecretEffectiveAt(JSContext* cx, unsigned argc, JS::Value* vp) {
@@ -135,12 +329,6 @@ bool FastEdge::getSecretEffectiveAt(JSContext* cx, unsigned argc, JS::Value* vp)
   if (!jsKey) {
     return false;
   }
-  // Encode the JS string to a C++ string
-  JS::UniqueChars keyChars = JS_EncodeStringToUTF8(cx, jsKey);
-  if (!keyChars) {
-    return false;
-  }
-
   // Convert the second argument to a number
   int32_t effective_at = 0;
   if (args.length() > 1 && !JS::ToInt32(cx, args.get(1), &effective_at)) {
@@ -150,20 +338,28 @@ bool FastEdge::getSecretEffectiveAt(JSContext* cx, unsigned argc, JS::Value* vp)
     effective_at = 0;
   }
 
-  auto secretValue = host_api::get_secret_vars_effective_at(keyChars.get(), effective_at);
-  if (!secretValue.size()) {
-    args.rval().setNull();
-    return true;
+  // Values for one timestamp share a cache object. While wizening nothing
+  // is cached, so a throwaway object stands in.
+  JS::RootedObject cache(cx);
+  size_t *counter = nullptr;
+  if (isWizening()) {
+    cache = JS_NewObjectWithGivenProto(cx, nullptr, nullptr);
+  } else {
+    cache = secret_at_cache(cx, effective_at, &counter);
+  }
+  if (!cache) {
+    return false;
   }
 
-  JS::RootedString secretValueStr(cx, JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(secretValue.begin(), secretValue.size())));
-  args.rval().setString(secretValueStr);
-  return true;
+  auto fetch = [effective_at](std::string_view name) {
+    return host_api::get_secret_vars_effective_at(name, effective_at);
+  };
+  return cached_host_value(cx, cache, jsKey, fetch, args.rval(), counter);
 }
 
 
 const JSPropertySpec FastEdge::properties[] = {
-    JS_PSG("env", getEnv, JSPROP_ENUMERATE),
+    JS_PSG("env", getEnvObject, JSPROP_ENUMERATE),
     JS_PS_END
 };
 
@@ -172,6 +368,22 @@ bool install(api::Engine *engine) {
 
   JS::SetOutOfMemoryCallback(engine->cx(), oom_callback, nullptr);
 
+  ENV_CACHE = new JS::PersistentRooted<JSObject *>(
+      engine->cx(), JS_NewObjectWithGivenProto(engine->cx(), nullptr, nullptr));
+  SECRET_CACHE = new JS::PersistentRooted<JSObject *>(
+      engine->cx(), JS_NewObjectWithGivenProto(engine->cx(), nullptr, nullptr));
+  SECRET_AT_CACHE = new JS::PersistentRooted<JSObject *>(
+      engine->cx(), JS_NewObjectWithGivenProto(engine->cx(), nullptr, nullptr));
+  if (!*ENV_CACHE || !*SECRET_CACHE || !*SECRET_AT_CACHE) {
+    return false;
+  }
+
+  FastEdge::env.init(engine->cx(),
+                     JS_NewObjectWithGivenProto(engine->cx(), &env_object_class, nullptr));
+  if (!FastEdge::env) {
+    return false;
+  }
+
   JS::RootedObject fastedge(engine->cx(), JS_NewPlainObject(engine->cx()));
   if (!fastedge) {
     return false;
@@ -204,6 +416,10 @@ bool install(api::Engine *engine) {
   if (!JS_SetProperty(engine->cx(), env_builtin, "getEnv", get_env_val)) {
     return false;
   }
+  RootedValue env_object_val(engine->cx(), JS::ObjectValue(*FastEdge::env));
+  if (!JS_SetProperty(engine->cx(), env_builtin, "env", env_object_val)) {
+    return false;
+  }
   RootedValue env_builtin_val(engine->cx(), JS::ObjectValue(*env_builtin));
   if (!engine->define_builtin_module("fastedge::env", env_builtin_val)) {
     return false;
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 
 #include "../../StarlingMonkey/runtime/encode.h"
 #include "extension-api.h"
@@ -29,11 +30,22 @@ public:
 
   static bool readFileSync(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool getEnv(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool getEnvObject(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool getSecret(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool getSecretEffectiveAt(JSContext *cx, unsigned argc, JS::Value *vp);
 
 };
 
+// The contents of the file at `path`, read on first use into memory outside
+// the GC heap that lives as long as the instance. Later calls for the same
+// path return the same bytes. Reports an error if the file can't be read.
+bool read_embedded_file(JSContext *cx, std::string_view path, const uint8_t **data, size_t *size);
+
+// Like `read_embedded_file`, but every call reads a fresh copy that is never
+// shared with `readFileSync`, so JS holds no view that can modify it. The
+// copy is never freed.
+bool read_private_file(JSContext *cx, std::string_view path, const uint8_t **data, size_t *size);
+
 } // namespace fastedge::fastedge
 
 #endif
@@ -0,0 +1,515 @@
+#include "builtin.h"
+#include "encode.h"
+
+#include <js/Array.h>
+#include <js/ArrayBuffer.h>
+#include <js/String.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fastedge::ja3_set {
+
+namespace {
+
+// Control bytes of the fingerprint table, Swiss-table style: each slot has
+// one byte that is either EMPTY or the low 7 bits of the key's hash. A probe
+// compares 8 control bytes at once as a 64-bit word, and only slots whose
+// tag matches have their 16-byte key compared.
+constexpr uint8_t EMPTY = 0x80;
+constexpr size_t GROUP_WIDTH = 8;
+constexpr uint64_t LSB = 0x0101010101010101ull;
+constexpr uint64_t MSB = 0x8080808080808080ull;
+
+// Labels are stored per slot as 16-bit indexes.
+constexpr size_t MAX_LABELS = 65535;
+
+struct Fingerprint {
+  uint8_t bytes[16];
+
+  bool operator==(const Fingerprint &other) const {
+    return std::memcmp(bytes, other.bytes, sizeof(bytes)) == 0;
+  }
+
+  // JA3 fingerprints are MD5 digests, so their first bytes are already
+  // uniformly distributed and serve as the hash.
+  uint64_t hash() const {
+    uint64_t h;
+    std::memcpy(&h, bytes, sizeof(h));
+    return h;
+  }
+};
+
+int hex_digit(uint32_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Decode 32 hex digits read through `char_at` into `out`.
+template <typename CharAt> bool decode_hex(size_t len, CharAt char_at, Fingerprint *out) {
+  if (len != 32) return false;
+  for (size_t i = 0; i < 16; i++) {
+    int hi = hex_digit(char_at(2 * i));
+    int lo = hex_digit(char_at(2 * i + 1));
+    if (hi < 0 || lo < 0) return false;
+    out->bytes[i] = static_cast<uint8_t>((hi << 4) | lo);
+  }
+  return true;
+}
+
+bool decode_hex(std::string_view text, Fingerprint *out) {
+  return decode_hex(text.size(), [&](size_t i) { return uint8_t(text[i]); }, out);
+}
+
+// Bitmask with the high bit set in each byte of `group` equal to `tag`.
+// May report a false positive next to a true match; callers compare keys.
+uint64_t match_tag(uint64_t group, uint8_t tag) {
+  uint64_t x = group ^ (LSB * tag);
+  return (x - LSB) & ~x & MSB;
+}
+
+// Open-addressed fingerprint → label table, built once and read-only
+// afterwards. Everything lives in flat vectors in linear memory, so a set
+// compiled during initialization is part of the wizer snapshot.
+class FingerprintTable {
+public:
+  // Grow the table to hold `additional` more keys at a load factor of at
+  // most 7/8.
+  void reserve(size_t additional) {
+    size_t needed = count_ + additional;
+    size_t capacity = std::max(this->capacity(), GROUP_WIDTH);
+    while (capacity * 7 / 8 < needed) capacity *= 2;
+    if (capacity != this->capacity()) rehash(capacity);
+  }
+
+  void insert(const Fingerprint &key, uint16_t label) {
+    if ((count_ + 1) * 8 > capacity() * 7) {
+      rehash(capacity() ? capacity() * 2 : GROUP_WIDTH);
+    }
+    insert_unchecked(key, label);
+  }
+
+  // Label index of `key`, or -1.
+  int find(const Fingerprint &key) const {
+    if (ctrl_.empty()) return -1;
+    uint64_t h = key.hash();
+    uint8_t tag = static_cast<uint8_t>(h & 0x7f);
+    size_t mask = capacity() - 1;
+    size_t pos = (h >> 7) & mask & ~(GROUP_WIDTH - 1);
+
+    for (size_t probe = 0; probe < capacity(); probe += GROUP_WIDTH) {
+      uint64_t group;
+      std::memcpy(&group, ctrl_.data() + pos, sizeof(group));
+
+      for (uint64_t m = match_tag(group, tag); m; m &= m - 1) {
+        size_t slot = pos + (__builtin_ctzll(m) >> 3);
+        if (keys_[slot] == key) return labels_[slot];
+      }
+      if (group & MSB) return -1;  // An empty slot ends the probe chain.
+      pos = (pos + GROUP_WIDTH) & mask;
+    }
+    return -1;
+  }
+
+  size_t size() const { return count_; }
+
+private:
+  size_t capacity() const { return ctrl_.size(); }
+
+  void insert_unchecked(const Fingerprint &key, uint16_t label) {
+    uint64_t h = key.hash();
+    uint8_t tag = static_cast<uint8_t>(h & 0x7f);
+    size_t mask = capacity() - 1;
+    size_t pos = (h >> 7) & mask & ~(GROUP_WIDTH - 1);
+
+    for (;;) {
+      for (size_t i = 0; i < GROUP_WIDTH; i++) {
+        size_t slot = pos + i;
+        if (ctrl_[slot] == EMPTY) {
+          ctrl_[slot] = tag;
+          keys_[slot] = key;
+          labels_[slot] = label;
+          count_++;
+          return;
+        }
+        // Later entries override earlier ones for the same fingerprint.
+        if (ctrl_[slot] == tag && keys_[slot] == key) {
+          labels_[slot] = label;
+          return;
+        }
+      }
+      pos = (pos + GROUP_WIDTH) & mask;
+    }
+  }
+
+  void rehash(size_t capacity) {
+    std::vector<uint8_t> ctrl(capacity, EMPTY);
+    std::vector<Fingerprint> keys(capacity);
+    std::vector<uint16_t> labels(capacity);
+    ctrl.swap(ctrl_);
+    keys.swap(keys_);
+    labels.swap(labels_);
+    count_ = 0;
+    for (size_t i = 0; i < ctrl.size(); i++) {
+      if (ctrl[i] != EMPTY) insert_unchecked(keys[i], labels[i]);
+    }
+  }
+
+  std::vector<uint8_t> ctrl_;
+  std::vector<Fingerprint> keys_;
+  std::vector<uint16_t> labels_;
+  size_t count_ = 0;
+};
+
+// A compiled Ja3Set: the table plus its labels as pinned atoms, so
+// `classify` returns an existing string without allocating.
+struct Ja3Table {
+  FingerprintTable table;
+  std::vector<std::string> label_names;
+  std::vector<JSString *> label_atoms;
+
+  // Index of `name`, adding it if new. -1 once MAX_LABELS is reached.
+  int label_index(std::string_view name) {
+    for (size_t i = 0; i < label_names.size(); i++) {
+      if (label_names[i] == name) return static_cast<int>(i);
+    }
+    if (label_names.size() == MAX_LABELS) return -1;
+    label_names.emplace_back(name);
+    return static_cast<int>(label_names.size() - 1);
+  }
+};
+
+bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && is_space(s.front())) s.remove_prefix(1);
+  while (!s.empty() && is_space(s.back())) s.remove_suffix(1);
+  return s;
+}
+
+// Add every line of `text` to `table`. A line is `<md5 hex>` followed by an
+// optional label (separated by whitespace or a comma); lines without one
+// use `default_label`. `#` starts a comment; blank lines are skipped.
+bool add_lines(JSContext *cx, Ja3Table *table, std::string_view text,
+               std::string_view default_label, uint32_t *entry_index) {
+  size_t pos = 0;
+  while (pos <= text.size()) {
+    size_t end = text.find('\n', pos);
+    if (end == std::string_view::npos) end = text.size();
+    std::string_view line = text.substr(pos, end - pos);
+    pos = end + 1;
+
+    size_t comment = line.find('#');
+    if (comment != std::string_view::npos) line = line.substr(0, comment);
+    line = trim(line);
+    if (line.empty()) continue;
+
+    size_t split = line.find_first_of(" \t,");
+    std::string_view hex = line.substr(0, split);
+    std::string_view label = default_label;
+    if (split != std::string_view::npos) {
+      std::string_view rest = trim(line.substr(split + 1));
+      if (!rest.empty() && rest.front() == ',') rest = trim(rest.substr(1));
+      if (!rest.empty()) label = rest;
+    }
+
+    Fingerprint key;
+    if (!decode_hex(hex, &key)) {
+      std::string shown(hex.substr(0, 64));
+      JS_ReportErrorUTF8(cx, "Ja3Set.compile: invalid fingerprint '%s' (entry %u)",
+                         shown.c_str(), *entry_index);
+      return false;
+    }
+    int index = table->label_index(label);
+    if (index < 0) {
+      JS_ReportErrorUTF8(cx, "Ja3Set.compile: more than %zu distinct labels", MAX_LABELS);
+      return false;
+    }
+    table->table.insert(key, static_cast<uint16_t>(index));
+    (*entry_index)++;
+  }
+  return true;
+}
+
+bool read_bytes_text(JSContext *cx, JS::HandleObject obj, std::string *out) {
+  JS::AutoCheckCannotGC noGC(cx);
+  bool is_shared;
+  if (JS::IsArrayBufferObject(obj)) {
+    size_t len = JS::GetArrayBufferByteLength(obj);
+    if (len > 0) {
+      auto *src = static_cast<const char *>(JS::GetArrayBufferData(obj, &is_shared, noGC));
+      out->assign(src, len);
+    }
+    return true;
+  }
+  if (JS_IsArrayBufferViewObject(obj)) {
+    size_t len = JS_GetArrayBufferViewByteLength(obj);
+    if (len > 0) {
+      auto *src = static_cast<const char *>(JS_GetArrayBufferViewData(obj, &is_shared, noGC));
+      out->assign(src, len);
+    }
+    return true;
+  }
+  return false;
+}
+
+// Add a list in any of the accepted forms: a string, its bytes, or an
+// array of lines. Returns false with `*handled` unset for other values.
+bool add_list(JSContext *cx, Ja3Table *table, JS::HandleValue list,
+              std::string_view default_label, uint32_t *entry_index, bool *handled) {
+  *handled = true;
+
+  if (list.isString()) {
+    auto text = core::encode(cx, list);
+    if (!text) return false;
+    return add_lines(cx, table, std::string_view(text.ptr.get(), text.len), default_label,
+                     entry_index);
+  }
+
+  if (!list.isObject()) {
+    *handled = false;
+    return true;
+  }
+  JS::RootedObject obj(cx, &list.toObject());
+
+  std::string text;
+  if (read_bytes_text(cx, obj, &text)) {
+    return add_lines(cx, table, text, default_label, entry_index);
+  }
+
+  bool is_array = false;
+  if (!JS::IsArrayObject(cx, list, &is_array)) return false;
+  if (!is_array) {
+    *handled = false;
+    return true;
+  }
+
+  uint32_t len;
+  if (!JS::GetArrayLength(cx, obj, &len)) return false;
+  table->table.reserve(len);
+  JS::RootedValue item_val(cx);
+  JS::RootedString item_str(cx);
+  for (uint32_t i = 0; i < len; i++) {
+    if (!JS_GetElement(cx, obj, i, &item_val)) return false;
+    item_str = JS::ToString(cx, item_val);
+    if (!item_str) return false;
+    auto item = core::encode(cx, item_str);
+    if (!item) return false;
+    if (!add_lines(cx, table, std::string_view(item.ptr.get(), item.len), default_label,
+                   entry_index)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Fill `table` from `source`: either a single list (lines carry their own
+// labels) or an object mapping each label to a list of fingerprints.
+bool compile_source(JSContext *cx, JS::HandleValue source, Ja3Table *table) {
+  uint32_t entry_index = 0;
+  bool handled;
+  if (!add_list(cx, table, source, "match", &entry_index, &handled)) return false;
+  if (handled) return true;
+
+  if (source.isObject()) {
+    JS::RootedObject obj(cx, &source.toObject());
+    JS::Rooted<JS::IdVector> ids(cx, JS::IdVector(cx));
+    if (!JS_Enumerate(cx, obj, &ids)) return false;
+
+    JS::RootedValue key_val(cx);
+    JS::RootedValue list(cx);
+    for (size_t i = 0; i < ids.length(); i++) {
+      if (!JS_IdToValue(cx, ids[i], &key_val)) return false;
+      auto label = core::encode(cx, key_val);
+      if (!label) return false;
+      if (!JS_GetPropertyById(cx, obj, ids[i], &list)) return false;
+
+      std::string_view label_view(label.ptr.get(), label.len);
+      if (!add_list(cx, table, list, label_view, &entry_index, &handled)) return false;
+      if (!handled) {
+        JS_ReportErrorUTF8(cx, "Ja3Set.compile: list '%s' must be an array, a string, an "
+                               "ArrayBuffer or an ArrayBufferView",
+                           label.ptr.get());
+        return false;
+      }
+    }
+    return true;
+  }
+
+  JS_ReportErrorUTF8(cx, "Ja3Set.compile: source must be a fingerprint list or an object "
+                         "mapping labels to lists");
+  return false;
+}
+
+JS::PersistentRooted<JSObject *> *JA3_SET_PROTO = nullptr;
+
+// `Ja3Set` instance. Owns its Ja3Table; freed by the finalizer. Label atoms
+// are pinned, so they outlive the table without being traced.
+class Ja3SetObject {
+public:
+  enum class Slot : uint32_t {
+    Table,  // PrivateValue(Ja3Table*)
+    Count
+  };
+
+  static const JSClass class_;
+  static const JSFunctionSpec methods[];
+  static const JSPropertySpec properties[];
+
+  static bool compile(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool classify(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool size_get(JSContext *cx, unsigned argc, JS::Value *vp);
+
+  static void finalize(JS::GCContext *gcx, JSObject *obj);
+};
+
+static const JSClassOps ja3_set_class_ops = {
+    .finalize = Ja3SetObject::finalize,
+};
+
+const JSClass Ja3SetObject::class_ = {
+    "Ja3Set",
+    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(Ja3SetObject::Slot::Count)) |
+        JSCLASS_FOREGROUND_FINALIZE,
+    &ja3_set_class_ops
+};
+
+const JSFunctionSpec Ja3SetObject::methods[] = {
+    JS_FN("classify", Ja3SetObject::classify, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+const JSPropertySpec Ja3SetObject::properties[] = {
+    JS_PSG("size", Ja3SetObject::size_get, JSPROP_ENUMERATE),
+    JS_PS_END,
+};
+
+Ja3Table *ja3_table(JSObject *obj) {
+  if (!obj || JS::GetClass(obj) != &Ja3SetObject::class_) return nullptr;
+  JS::Value v = JS::GetReservedSlot(obj, static_cast<uint32_t>(Ja3SetObject::Slot::Table));
+  if (v.isUndefined()) return nullptr;
+  return static_cast<Ja3Table *>(v.toPrivate());
+}
+
+Ja3Table *this_table(JSContext *cx, JS::CallArgs &args, const char *fn_name) {
+  Ja3Table *table = args.thisv().isObject() ? ja3_table(&args.thisv().toObject()) : nullptr;
+  if (!table) JS_ReportErrorUTF8(cx, "%s: receiver must be a Ja3Set", fn_name);
+  return table;
+}
+
+void Ja3SetObject::finalize(JS::GCContext *gcx, JSObject *obj) {
+  delete ja3_table(obj);
+}
+
+bool Ja3SetObject::compile(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "Ja3Set.compile", 1)) return false;
+
+  auto table = std::make_unique<Ja3Table>();
+  if (!compile_source(cx, args[0], table.get())) return false;
+
+  table->label_atoms.reserve(table->label_names.size());
+  for (const auto &name : table->label_names) {
+    JSString *atom = JS_AtomizeAndPinStringN(cx, name.data(), name.size());
+    if (!atom) return false;
+    table->label_atoms.push_back(atom);
+  }
+
+  JS::RootedObject proto(cx, *JA3_SET_PROTO);
+  JS::RootedObject obj(cx, JS_NewObjectWithGivenProto(cx, &Ja3SetObject::class_, proto));
+  if (!obj) return false;
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(Slot::Table),
+                      JS::PrivateValue(table.release()));
+
+  args.rval().setObject(*obj);
+  return true;
+}
+
+// Decode the fingerprint argument of `classify` without allocating: hex
+// strings are read character by character, 16-byte views are copied.
+// Returns false in `*valid` for anything that isn't a fingerprint.
+bool read_fingerprint(JSContext *cx, JS::HandleValue value, Fingerprint *out, bool *valid) {
+  *valid = false;
+
+  if (value.isString()) {
+    JSLinearString *str = JS_EnsureLinearString(cx, value.toString());
+    if (!str) return false;
+    size_t len = JS::GetLinearStringLength(str);
+    *valid = decode_hex(len, [&](size_t i) { return JS::GetLinearStringCharAt(str, i); }, out);
+    return true;
+  }
+
+  if (value.isObject()) {
+    JS::RootedObject obj(cx, &value.toObject());
+    if (JS_IsArrayBufferViewObject(obj) && JS_GetArrayBufferViewByteLength(obj) == 16) {
+      JS::AutoCheckCannotGC noGC(cx);
+      bool is_shared;
+      std::memcpy(out->bytes, JS_GetArrayBufferViewData(obj, &is_shared, noGC), 16);
+      *valid = true;
+    }
+  }
+  return true;
+}
+
+bool Ja3SetObject::classify(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  Ja3Table *table = this_table(cx, args, "Ja3Set.classify");
+  if (!table) return false;
+
+  Fingerprint key;
+  bool valid;
+  if (!read_fingerprint(cx, args.get(0), &key, &valid)) return false;
+
+  int label = valid ? table->table.find(key) : -1;
+  if (label < 0) {
+    args.rval().setNull();
+  } else {
+    args.rval().setString(table->label_atoms[label]);
+  }
+  return true;
+}
+
+bool Ja3SetObject::size_get(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  Ja3Table *table = this_table(cx, args, "Ja3Set.size");
+  if (!table) return false;
+  args.rval().setNumber(static_cast<double>(table->table.size()));
+  return true;
+}
+
+const JSFunctionSpec ja3_set_static_methods[] = {
+    JS_FN("compile", Ja3SetObject::compile, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+}  // namespace
+
+bool install(api::Engine *engine) {
+  JSContext *cx = engine->cx();
+
+  JS::RootedObject proto(cx, JS_NewPlainObject(cx));
+  if (!proto) return false;
+  if (!JS_DefineFunctions(cx, proto, Ja3SetObject::methods) ||
+      !JS_DefineProperties(cx, proto, Ja3SetObject::properties)) {
+    return false;
+  }
+  JA3_SET_PROTO = new JS::PersistentRooted<JSObject *>(cx, proto);
+
+  JS::RootedObject ja3_set_obj(cx, JS_NewPlainObject(cx));
+  if (!ja3_set_obj) return false;
+  if (!JS_DefineFunctions(cx, ja3_set_obj, ja3_set_static_methods)) return false;
+
+  if (!JS_DefineProperty(cx, engine->global(), "Ja3Set", ja3_set_obj, 0)) {
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace fastedge::ja3_set
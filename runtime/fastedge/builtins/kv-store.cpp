@@ -1,10 +1,20 @@
 #include "kv-store.h"
 #include "encode.h"
+#include "value-decode.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <js/Array.h>
 #include <js/ArrayBuffer.h>
 #include <js/CharacterEncoding.h>
 #include <js/JSON.h>
@@ -14,25 +24,35 @@ using fastedge::kv_store::KvStore;
 
 namespace {
 api::Engine *ENGINE;
+
+// Shared prototype for KvStore instances. Holds the instance methods so
+// `open()` only has to allocate the wrapper object itself. Initialised in
+// `install()` and persistent-rooted for the engine's lifetime.
+JS::PersistentRooted<JSObject *> *KV_STORE_PROTO = nullptr;
+
+// Shared prototype for the async iterators returned by `scanIter` /
+// `zscanIter`. Initialised in `install()`.
+JS::PersistentRooted<JSObject *> *KV_SCAN_ITERATOR_PROTO = nullptr;
+
+// Page size used by `scanIter` / `zscanIter` when no `count` is given.
+constexpr size_t DEFAULT_SCAN_PAGE_SIZE = 100;
 }
 
 namespace fastedge::kv_store {
 
-// JSClassOps for KvStore instances
-static const JSClassOps kv_store_class_ops = {
-    .finalize = KvStore::finalize,
-};
-
-// JSClass definition for KvStore instances
+// JSClass definition for KvStore instances. No finalizer: the reserved slot
+// borrows a pointer owned by `KvStore::open_stores_`.
 const JSClass KvStore::class_ = {
     "KvStore",
-    JSCLASS_HAS_RESERVED_SLOTS(1) | JSCLASS_FOREGROUND_FINALIZE,
-    &kv_store_class_ops
+    JSCLASS_HAS_RESERVED_SLOTS(1)
 };
 
+std::unordered_map<std::string, std::unique_ptr<KvStore>> KvStore::open_stores_;
+
 // Static methods for the KvStore constructor
 const JSFunctionSpec KvStore::static_methods[] = {
     JS_FN("open", KvStore::open, 1, JSPROP_ENUMERATE),
+    JS_FN("openMirrored", KvStore::open_mirrored, 1, JSPROP_ENUMERATE),
     JS_FS_END
 };
 
@@ -40,46 +60,79 @@ const JSFunctionSpec KvStore::static_methods[] = {
 const JSFunctionSpec KvStore::methods[] = {
     JS_FN("get", KvStore::get, 1, JSPROP_ENUMERATE),
     JS_FN("getEntry", KvStore::get_entry, 1, JSPROP_ENUMERATE),
+    JS_FN("getText", KvStore::get_text, 1, JSPROP_ENUMERATE),
+    JS_FN("getJSON", KvStore::get_json, 1, JSPROP_ENUMERATE),
+    JS_FN("getDecoded", KvStore::get_decoded, 2, JSPROP_ENUMERATE),
     JS_FN("scan", KvStore::scan, 1, JSPROP_ENUMERATE),
     JS_FN("zrangeByScore", KvStore::zrange_by_score, 3, JSPROP_ENUMERATE),
     JS_FN("zrangeByScoreEntries", KvStore::zrange_by_score_entries, 3, JSPROP_ENUMERATE),
     JS_FN("zscan", KvStore::zscan, 2, JSPROP_ENUMERATE),
     JS_FN("zscanEntries", KvStore::zscan_entries, 2, JSPROP_ENUMERATE),
+    JS_FN("scanIter", KvStore::scan_iter, 1, JSPROP_ENUMERATE),
+    JS_FN("zscanIter", KvStore::zscan_iter, 2, JSPROP_ENUMERATE),
+    JS_FN("zrangeByScoreColumnar", KvStore::zrange_by_score_columnar, 3, JSPROP_ENUMERATE),
+    JS_FN("zscanColumnar", KvStore::zscan_columnar, 2, JSPROP_ENUMERATE),
+    JS_FN("zmerge", KvStore::zmerge, 3, JSPROP_ENUMERATE),
+    JS_FN("geoNearby", KvStore::geo_nearby, 4, JSPROP_ENUMERATE),
     JS_FN("bfExists", KvStore::bf_exists, 2, JSPROP_ENUMERATE),
+    JS_FN("bfExistsMany", KvStore::bf_exists_many, 2, JSPROP_ENUMERATE),
+    JS_FN("bfExistsCache", KvStore::bf_exists_cache, 1, JSPROP_ENUMERATE),
+    JS_FN("close", KvStore::close, 0, JSPROP_ENUMERATE),
     JS_FS_END
 };
 
 KvStore* KvStore::get_instance(JSContext *cx, JSObject *obj) {
-    return static_cast<KvStore*>(JS::GetReservedSlot(obj, 0).toPrivate());
+    if (!obj || JS::GetClass(obj) != &KvStore::class_) {
+        return nullptr;
+    }
+    JS::Value slot = JS::GetReservedSlot(obj, 0);
+    if (slot.isUndefined()) {
+        return nullptr;
+    }
+    return static_cast<KvStore*>(slot.toPrivate());
 }
 
-void KvStore::finalize(JS::GCContext *gcx, JSObject *obj) {
-    KvStore* store = static_cast<KvStore*>(JS::GetReservedSlot(obj, 0).toPrivate());
-    if (store) {
-        delete store;
+KvStore* KvStore::open_instance(JSContext *cx, JSObject *obj) {
+    KvStore* store = get_instance(cx, obj);
+    if (!store) {
+        JS_ReportErrorUTF8(cx, "Invalid KvStore instance");
+        return nullptr;
     }
+    if (store->closed_) {
+        JS_ReportErrorUTF8(cx, "KvStore is closed; call KvStore.open() again to reopen it");
+        return nullptr;
+    }
+    return store;
 }
 
-bool KvStore::open(JSContext *cx, unsigned argc, JS::Value *vp) {
-    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+KvStore::~KvStore() {
+    release();
+}
 
-    if (!args.requireAtLeast(cx, "KvStore.open", 1)) {
-        return false;
+void KvStore::release() {
+    if (!closed_) {
+        host_api::kv_store_close(store_handle_);
+        closed_ = true;
     }
+}
 
-    // Convert the store name to string
-    JS::RootedString store_name_str(cx, JS::ToString(cx, args[0]));
-    if (!store_name_str) {
-        return false;
+KvStore* KvStore::open_handle(JSContext *cx, std::string name) {
+    auto cached = open_stores_.find(name);
+    if (cached != open_stores_.end() && !cached->second->closed_) {
+        return cached->second.get();
     }
 
-    auto store_name = core::encode(cx, store_name_str);
-    if (!store_name) {
-        return false;
+    // A handle opened while wizening would be baked into the snapshot, where
+    // it names nothing on the host that later serves requests.
+    if (isWizening()) {
+        JS_ReportErrorUTF8(cx, "Store %s can't be opened during build-time initialization; "
+                               "open it while handling a request", name.c_str());
+        return nullptr;
     }
 
     // Call the host API to open the store
-    auto result = host_api::kv_store_open(std::string_view(store_name.ptr.get(), store_name.len));
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_open(name);
 
     // THROW ERRORS...
     if (!result.is_ok()) {
@@ -87,38 +140,78 @@ bool KvStore::open(JSContext *cx, unsigned argc, JS::Value *vp) {
         auto error = result.unwrap_err();
         switch (error.tag) {
             case host_api::KvStoreErrorTag::NO_SUCH_STORE:
-                JS_ReportErrorUTF8(cx, "No such store: %s", store_name.ptr.get());
+                JS_ReportErrorUTF8(cx, "No such store: %s", name.c_str());
                 break;
             case host_api::KvStoreErrorTag::ACCESS_DENIED:
-                JS_ReportErrorUTF8(cx, "Access denied to store: %s", store_name.ptr.get());
+                JS_ReportErrorUTF8(cx, "Access denied to store: %s", name.c_str());
                 break;
             case host_api::KvStoreErrorTag::INTERNAL_ERROR:
-                JS_ReportErrorUTF8(cx, "Internal error opening store: %s", store_name.ptr.get());
+                JS_ReportErrorUTF8(cx, "Internal error opening store: %s", name.c_str());
                 break;
             case host_api::KvStoreErrorTag::OTHER:
-                JS_ReportErrorUTF8(cx, "Error opening store %s: %s", store_name.ptr.get(), error.val.other.ptr);
+                JS_ReportErrorUTF8(cx, "Error opening store %s: %s", name.c_str(), error.val.other.ptr);
                 break;
         }
+        return nullptr;
+    }
+
+    if (cached != open_stores_.end()) {
+        KvStore* reopened = cached->second.get();
+        reopened->store_handle_ = result.unwrap();
+        reopened->closed_ = false;
+        return reopened;
+    }
+
+    std::unique_ptr<KvStore> opened(new KvStore(result.unwrap()));
+    KvStore* store_instance = opened.get();
+    open_stores_.emplace(std::move(name), std::move(opened));
+    return store_instance;
+}
+
+bool KvStore::close(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    KvStore* store = args.thisv().isObject() ? get_instance(cx, &args.thisv().toObject()) : nullptr;
+    if (!store) {
+        JS_ReportErrorUTF8(cx, "Invalid KvStore instance");
         return false;
     }
+    store->release();
+
+    args.rval().setUndefined();
+    return true;
+}
 
-    int32_t store_handle = result.unwrap();
+bool KvStore::open(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
 
-    // Create a new KvStore instance
-    JS::RootedObject store_obj(cx, JS_NewObjectWithGivenProto(cx, &KvStore::class_, nullptr));
-    if (!store_obj) {
+    if (!args.requireAtLeast(cx, "KvStore.open", 1)) {
         return false;
     }
 
-    // Create the C++ instance and store it in the JS object
-    KvStore* store_instance = new KvStore(store_handle);
-    JS::SetReservedSlot(store_obj, 0, JS::PrivateValue(store_instance));
+    // Convert the store name to string
+    JS::RootedString store_name_str(cx, JS::ToString(cx, args[0]));
+    if (!store_name_str) {
+        return false;
+    }
+
+    auto store_name = core::encode(cx, store_name_str);
+    if (!store_name) {
+        return false;
+    }
 
-    // Define the instance methods
-    if (!JS_DefineFunctions(cx, store_obj, KvStore::methods)) {
-        delete store_instance;
+    KvStore* store_instance = open_handle(cx, std::string(store_name.ptr.get(), store_name.len));
+    if (!store_instance) {
+        return false;
+    }
+
+    // Wrap the shared C++ instance; methods come from the shared prototype.
+    JS::RootedObject proto(cx, *KV_STORE_PROTO);
+    JS::RootedObject store_obj(cx, JS_NewObjectWithGivenProto(cx, &KvStore::class_, proto));
+    if (!store_obj) {
         return false;
     }
+    JS::SetReservedSlot(store_obj, 0, JS::PrivateValue(store_instance));
 
     args.rval().setObject(*store_obj);
     return true;
@@ -133,9 +226,8 @@ bool KvStore::get(JSContext *cx, unsigned argc, JS::Value *vp) {
 
     // Get the KvStore instance
     JS::RootedObject this_obj(cx, &args.thisv().toObject());
-    KvStore* store = get_instance(cx, this_obj);
+    KvStore* store = open_instance(cx, this_obj);
     if (!store) {
-        JS_ReportErrorUTF8(cx, "Invalid KvStore instance");
         return false;
     }
 
@@ -151,6 +243,7 @@ bool KvStore::get(JSContext *cx, unsigned argc, JS::Value *vp) {
     }
 
     // Call the host API
+    host_api::HostArenaScope arena;
     auto result = host_api::kv_store_get(store->store_handle_, std::string_view(key.ptr.get(), key.len));
 
     if (!result.is_ok()) {
@@ -184,6 +277,160 @@ bool KvStore::get(JSContext *cx, unsigned argc, JS::Value *vp) {
     return true;
 }
 
+namespace {
+
+bool is_ascii(const uint8_t *bytes, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (bytes[i] & 0x80) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Decode a host value as UTF-8 straight into a JS string. ASCII input is
+// copied as Latin-1, which skips UTF-8 validation and inflation.
+JSString *decode_value_string(JSContext *cx, const uint8_t *bytes, size_t len) {
+  if (is_ascii(bytes, len)) {
+    return JS_NewStringCopyN(cx, reinterpret_cast<const char *>(bytes), len);
+  }
+  return JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(reinterpret_cast<const char *>(bytes), len));
+}
+
+// Parse a host value as JSON. ASCII input is parsed in place from the host
+// buffer; anything else is decoded to a JS string first.
+bool parse_value_json(JSContext *cx, const uint8_t *bytes, size_t len,
+                      JS::MutableHandleValue out) {
+  if (len <= UINT32_MAX && is_ascii(bytes, len)) {
+    return JS_ParseJSON(cx, reinterpret_cast<const JS::Latin1Char *>(bytes),
+                        static_cast<uint32_t>(len), out);
+  }
+  JS::RootedString str(cx, decode_value_string(cx, bytes, len));
+  if (!str) return false;
+  return JS_ParseJSON(cx, str, out);
+}
+
+}  // anonymous namespace
+
+bool KvStore::get_text(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "getText", 1)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    JS::RootedString key_str(cx, JS::ToString(cx, args[0]));
+    if (!key_str) return false;
+
+    auto key = core::encode(cx, key_str);
+    if (!key) return false;
+
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_get(store->store_handle_, std::string_view(key.ptr.get(), key.len));
+    if (!result.is_ok()) {
+        JS_ReportErrorUTF8(cx, "Error getting key: %s", key.ptr.get());
+        return false;
+    }
+
+    auto value_option = result.unwrap();
+    if (!value_option.is_some()) {
+        args.rval().setNull();
+        return true;
+    }
+
+    auto value = value_option.unwrap();
+    JSString *str = decode_value_string(cx, value.ptr, value.len);
+    if (!str) return false;
+
+    args.rval().setString(str);
+    return true;
+}
+
+bool KvStore::get_json(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "getJSON", 1)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    JS::RootedString key_str(cx, JS::ToString(cx, args[0]));
+    if (!key_str) return false;
+
+    auto key = core::encode(cx, key_str);
+    if (!key) return false;
+
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_get(store->store_handle_, std::string_view(key.ptr.get(), key.len));
+    if (!result.is_ok()) {
+        JS_ReportErrorUTF8(cx, "Error getting key: %s", key.ptr.get());
+        return false;
+    }
+
+    auto value_option = result.unwrap();
+    if (!value_option.is_some()) {
+        args.rval().setNull();
+        return true;
+    }
+
+    auto value = value_option.unwrap();
+    return parse_value_json(cx, value.ptr, value.len, args.rval());
+}
+
+bool KvStore::get_decoded(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "getDecoded", 2)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    JS::RootedString key_str(cx, JS::ToString(cx, args[0]));
+    if (!key_str) return false;
+
+    auto key = core::encode(cx, key_str);
+    if (!key) return false;
+
+    value_decode::Format format;
+    if (!value_decode::read_format(cx, args[1], "getDecoded", &format)) {
+        return false;
+    }
+
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_get(store->store_handle_, std::string_view(key.ptr.get(), key.len));
+    if (!result.is_ok()) {
+        JS_ReportErrorUTF8(cx, "Error getting key: %s", key.ptr.get());
+        return false;
+    }
+
+    auto value_option = result.unwrap();
+    if (!value_option.is_some()) {
+        args.rval().setNull();
+        return true;
+    }
+
+    // The host buffer is not GC-managed, so the decoder can read it in place
+    // while it allocates the result objects.
+    auto value = value_option.unwrap();
+    return value_decode::decode(cx, format, value.ptr, value.len, args.rval());
+}
+
 bool KvStore::scan(JSContext *cx, unsigned argc, JS::Value *vp) {
     JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
 
@@ -192,9 +439,8 @@ bool KvStore::scan(JSContext *cx, unsigned argc, JS::Value *vp) {
     }
 
     JS::RootedObject this_obj(cx, &args.thisv().toObject());
-    KvStore* store = get_instance(cx, this_obj);
+    KvStore* store = open_instance(cx, this_obj);
     if (!store) {
-        JS_ReportErrorUTF8(cx, "Invalid KvStore instance");
         return false;
     }
 
@@ -208,6 +454,7 @@ bool KvStore::scan(JSContext *cx, unsigned argc, JS::Value *vp) {
         return false;
     }
 
+    host_api::HostArenaScope arena;
     auto result = host_api::kv_store_scan(store->store_handle_, std::string_view(pattern.ptr.get(), pattern.len));
 
     if (!result.is_ok()) {
@@ -240,6 +487,61 @@ bool KvStore::scan(JSContext *cx, unsigned argc, JS::Value *vp) {
     return true;
 }
 
+namespace {
+
+// Read an optional non-negative integer field off an options object.
+bool read_index_option(JSContext *cx, JS::HandleObject options, const char *name,
+                       const char *fn_name, std::optional<size_t> *out) {
+  JS::RootedValue val(cx);
+  if (!JS_GetProperty(cx, options, name, &val)) return false;
+  if (val.isUndefined()) return true;
+
+  double n;
+  if (!JS::ToNumber(cx, val, &n)) return false;
+  if (!std::isfinite(n) || std::trunc(n) != n || n < 0 ||
+      n > static_cast<double>(UINT32_MAX)) {
+    JS_ReportErrorUTF8(cx, "%s: %s must be a non-negative integer", fn_name, name);
+    return false;
+  }
+  *out = static_cast<size_t>(n);
+  return true;
+}
+
+// Read an optional boolean field off an options object.
+bool read_flag_option(JSContext *cx, JS::HandleObject options, const char *name,
+                      bool *out) {
+  JS::RootedValue val(cx);
+  if (!JS_GetProperty(cx, options, name, &val)) return false;
+  *out = JS::ToBoolean(val);
+  return true;
+}
+
+// Parse the `{ offset, count, reverse, minExclusive, maxExclusive }` options
+// bag accepted by the zrangeByScore family.
+bool read_zrange_options(JSContext *cx, JS::HandleValue options_val,
+                         const char *fn_name,
+                         host_api::KvStoreZRangeOptions *out) {
+  if (options_val.isNullOrUndefined()) return true;
+  if (!options_val.isObject()) {
+    JS_ReportErrorUTF8(cx, "%s: options must be an object", fn_name);
+    return false;
+  }
+
+  JS::RootedObject options(cx, &options_val.toObject());
+  std::optional<size_t> offset;
+  if (!read_index_option(cx, options, "offset", fn_name, &offset) ||
+      !read_index_option(cx, options, "count", fn_name, &out->count) ||
+      !read_flag_option(cx, options, "reverse", &out->reverse) ||
+      !read_flag_option(cx, options, "minExclusive", &out->min_exclusive) ||
+      !read_flag_option(cx, options, "maxExclusive", &out->max_exclusive)) {
+    return false;
+  }
+  out->offset = offset.value_or(0);
+  return true;
+}
+
+}  // anonymous namespace
+
 bool KvStore::zrange_by_score(JSContext *cx, unsigned argc, JS::Value *vp) {
     JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
 
@@ -248,9 +550,8 @@ bool KvStore::zrange_by_score(JSContext *cx, unsigned argc, JS::Value *vp) {
     }
 
     JS::RootedObject this_obj(cx, &args.thisv().toObject());
-    KvStore* store = get_instance(cx, this_obj);
+    KvStore* store = open_instance(cx, this_obj);
     if (!store) {
-        JS_ReportErrorUTF8(cx, "Invalid KvStore instance");
         return false;
     }
 
@@ -270,7 +571,13 @@ bool KvStore::zrange_by_score(JSContext *cx, unsigned argc, JS::Value *vp) {
         return false;
     }
 
-    auto result = host_api::kv_store_zrange_by_score(store->store_handle_, std::string_view(key.ptr.get(), key.len), min, max);
+    host_api::KvStoreZRangeOptions options;
+    if (!read_zrange_options(cx, args.get(3), "zrangeByScore", &options)) {
+        return false;
+    }
+
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_zrange_by_score(store->store_handle_, std::string_view(key.ptr.get(), key.len), min, max, options);
 
     if (!result.is_ok()) {
         JS_ReportErrorUTF8(cx, "Error in zrangeByScore for key: %s", key.ptr.get());
@@ -331,9 +638,8 @@ bool KvStore::zscan(JSContext *cx, unsigned argc, JS::Value *vp) {
     }
 
     JS::RootedObject this_obj(cx, &args.thisv().toObject());
-    KvStore* store = get_instance(cx, this_obj);
+    KvStore* store = open_instance(cx, this_obj);
     if (!store) {
-        JS_ReportErrorUTF8(cx, "Invalid KvStore instance");
         return false;
     }
 
@@ -357,6 +663,7 @@ bool KvStore::zscan(JSContext *cx, unsigned argc, JS::Value *vp) {
         return false;
     }
 
+    host_api::HostArenaScope arena;
     auto result = host_api::kv_store_zscan(store->store_handle_, std::string_view(key.ptr.get(), key.len), std::string_view(pattern.ptr.get(), pattern.len));
 
     if (!result.is_ok()) {
@@ -418,9 +725,8 @@ bool KvStore::bf_exists(JSContext *cx, unsigned argc, JS::Value *vp) {
     }
 
     JS::RootedObject this_obj(cx, &args.thisv().toObject());
-    KvStore* store = get_instance(cx, this_obj);
+    KvStore* store = open_instance(cx, this_obj);
     if (!store) {
-        JS_ReportErrorUTF8(cx, "Invalid KvStore instance");
         return false;
     }
 
@@ -444,6 +750,7 @@ bool KvStore::bf_exists(JSContext *cx, unsigned argc, JS::Value *vp) {
         return false;
     }
 
+    host_api::HostArenaScope arena;
     auto result = host_api::kv_store_bf_exists(store->store_handle_, std::string_view(key.ptr.get(), key.len), std::string_view(item.ptr.get(), item.len));
 
     if (!result.is_ok()) {
@@ -457,55 +764,370 @@ bool KvStore::bf_exists(JSContext *cx, unsigned argc, JS::Value *vp) {
 
 namespace {
 
-// Resolve `args.rval()` with a fresh Promise resolved to `value`.
-bool resolve_with(JSContext *cx, JS::HandleValue value, JS::CallArgs &args) {
-  JS::RootedObject promise(cx, JS::CallOriginalPromiseResolve(cx, value));
-  if (!promise) return false;
-  args.rval().setObject(*promise);
+// Default lifetime of a Bloom filter exists cache, in seconds.
+constexpr double DEFAULT_BLOOM_EXISTS_CACHE_TTL_SECS = 60;
+
+// Upper bound on memoised items per cache. Reaching it starts a fresh
+// generation early rather than growing without bound.
+constexpr size_t MAX_BLOOM_EXISTS_CACHE_ITEMS = 65536;
+
+// Instance-memory cache of `bf_exists` answers for one Bloom filter. It is
+// not a copy of the filter: the key-value WIT interface has no call that
+// returns the bit array, so answers are memoised per item and the whole set is dropped when the TTL lapses, so
+// a hot item costs one host call per TTL window instead of one per
+// request. Owned by BLOOM_EXISTS_CACHES for the lifetime of the instance.
+struct BloomExistsCache {
+  // Borrowed from the KvStore handle table, which never frees entries.
+  KvStore *store;
+  std::string key;
+  std::chrono::steady_clock::duration ttl;
+  std::chrono::steady_clock::time_point expires_at;
+  std::unordered_map<std::string, bool> members;
+
+  void refresh_if_stale() {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= expires_at || members.size() >= MAX_BLOOM_EXISTS_CACHE_ITEMS) {
+      members.clear();
+      expires_at = now + ttl;
+    }
+  }
+};
+
+// Caches keyed by store and filter key, shared by every
+// `bfExistsCache()` call for the same filter.
+std::unordered_map<std::string, std::unique_ptr<BloomExistsCache>> BLOOM_EXISTS_CACHES;
+
+// Shared prototype for BloomExistsCache wrappers. Initialised in `install()`.
+JS::PersistentRooted<JSObject *> *KV_BLOOM_EXISTS_CACHE_PROTO = nullptr;
+
+// Read `items` as an array of strings, for bfExistsMany / hasMany.
+bool read_string_items(JSContext *cx, JS::HandleValue items_val, const char *fn_name,
+                       std::vector<std::string> *out) {
+  bool is_array = false;
+  if (!JS::IsArrayObject(cx, items_val, &is_array)) return false;
+  if (!is_array) {
+    JS_ReportErrorUTF8(cx, "%s: items must be an array of strings", fn_name);
+    return false;
+  }
+
+  JS::RootedObject items(cx, &items_val.toObject());
+  uint32_t len;
+  if (!JS::GetArrayLength(cx, items, &len)) return false;
+
+  out->reserve(len);
+  JS::RootedValue item_val(cx);
+  JS::RootedString item_str(cx);
+  for (uint32_t i = 0; i < len; i++) {
+    if (!JS_GetElement(cx, items, i, &item_val)) return false;
+    item_str = JS::ToString(cx, item_val);
+    if (!item_str) return false;
+    auto item = core::encode(cx, item_str);
+    if (!item) return false;
+    out->emplace_back(item.ptr.get(), item.len);
+  }
   return true;
 }
 
-// Decode the bytes of a Uint8Array as UTF-8 into a fresh JS string.
-JSString *decode_utf8_string(JSContext *cx, JS::HandleObject bytes_array) {
-  size_t len = JS_GetTypedArrayLength(bytes_array);
-  std::vector<char> buf(len);
-  if (len > 0) {
-    JS::AutoCheckCannotGC noGC(cx);
-    bool is_shared;
-    void *data = JS_GetArrayBufferViewData(bytes_array, &is_shared, noGC);
-    memcpy(buf.data(), data, len);
+JSObject *booleans_array(JSContext *cx, const std::vector<bool> &values) {
+  JS::RootedObject arr(cx, JS::NewArrayObject(cx, values.size()));
+  if (!arr) return nullptr;
+
+  JS::RootedValue val(cx);
+  for (size_t i = 0; i < values.size(); i++) {
+    val.setBoolean(values[i]);
+    if (!JS_DefineElement(cx, arr, static_cast<uint32_t>(i), val, JSPROP_ENUMERATE)) {
+      return nullptr;
+    }
   }
-  return JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(buf.data(), buf.size()));
+  return arr;
 }
 
-class KvStoreEntry {
+// Answer `items` from `cache`, fetching only the misses from the host
+// in a single batch.
+bool exists_cache_lookup(JSContext *cx, BloomExistsCache *cache, const std::vector<std::string> &items,
+                     std::vector<bool> *out) {
+  cache->refresh_if_stale();
+
+  std::vector<std::string_view> misses;
+  for (const auto &item : items) {
+    if (cache->members.find(item) == cache->members.end()) {
+      misses.push_back(item);
+    }
+  }
+
+  if (!misses.empty()) {
+    if (cache->store->closed()) {
+      JS_ReportErrorUTF8(cx, "KvStore is closed; call KvStore.open() again to reopen it");
+      return false;
+    }
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_bf_exists_many(cache->store->handle(), cache->key, misses);
+    if (!result.is_ok()) {
+      JS_ReportErrorUTF8(cx, "Error checking bloom filter for key: %s", cache->key.c_str());
+      return false;
+    }
+    const auto &found = result.unwrap();
+    for (size_t i = 0; i < misses.size(); i++) {
+      cache->members.emplace(std::string(misses[i]), found[i]);
+    }
+  }
+
+  out->reserve(items.size());
+  for (const auto &item : items) {
+    out->push_back(cache->members.at(item));
+  }
+  return true;
+}
+
+class KvBloomExistsCache {
 public:
   enum class Slot : uint32_t {
-    Bytes = 0,
+    Cache = 0,
     Count
   };
 
   static const JSClass class_;
   static const JSFunctionSpec methods[];
 
-  static bool arrayBuffer(JSContext *cx, unsigned argc, JS::Value *vp);
-  static bool text(JSContext *cx, unsigned argc, JS::Value *vp);
-  static bool json(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool has(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool has_many(JSContext *cx, unsigned argc, JS::Value *vp);
 
-  // Allocates a Uint8Array, copies `bytes` into it, and wraps it in a
-  // freshly-created KvStoreEntry. Returns nullptr on allocation failure
-  // (with a pending JS exception).
-  static JSObject *create(JSContext *cx, const uint8_t *bytes, size_t len);
+  static JSObject *create(JSContext *cx, BloomExistsCache *cache);
 };
 
-const JSClass KvStoreEntry::class_ = {
-    "KvStoreEntry",
-    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(KvStoreEntry::Slot::Count))
+// No finalizer: the slot borrows a pointer owned by BLOOM_EXISTS_CACHES.
+const JSClass KvBloomExistsCache::class_ = {
+    "BloomExistsCache",
+    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(KvBloomExistsCache::Slot::Count))
 };
 
-// Get the Uint8Array stored in a KvStoreEntry's reserved slot.
-JSObject *kv_store_entry_bytes(JSContext *cx, JS::HandleObject self) {
-  JS::Value v = JS::GetReservedSlot(
+BloomExistsCache *bf_exists_cache_instance(JSContext *cx, const JS::CallArgs &args) {
+  if (!args.thisv().isObject() || JS::GetClass(&args.thisv().toObject()) != &KvBloomExistsCache::class_) {
+    JS_ReportErrorUTF8(cx, "Invalid BloomExistsCache instance");
+    return nullptr;
+  }
+  JS::Value slot = JS::GetReservedSlot(&args.thisv().toObject(),
+                                       static_cast<uint32_t>(KvBloomExistsCache::Slot::Cache));
+  return static_cast<BloomExistsCache *>(slot.toPrivate());
+}
+
+JSObject *KvBloomExistsCache::create(JSContext *cx, BloomExistsCache *cache) {
+  JS::RootedObject proto(cx, *KV_BLOOM_EXISTS_CACHE_PROTO);
+  JSObject *obj = JS_NewObjectWithGivenProto(cx, &KvBloomExistsCache::class_, proto);
+  if (!obj) return nullptr;
+
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(Slot::Cache), JS::PrivateValue(cache));
+  return obj;
+}
+
+bool KvBloomExistsCache::has(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "has", 1)) return false;
+
+  BloomExistsCache *cache = bf_exists_cache_instance(cx, args);
+  if (!cache) return false;
+
+  JS::RootedString item_str(cx, JS::ToString(cx, args[0]));
+  if (!item_str) return false;
+  auto item = core::encode(cx, item_str);
+  if (!item) return false;
+
+  std::vector<std::string> items;
+  items.emplace_back(item.ptr.get(), item.len);
+  std::vector<bool> found;
+  if (!exists_cache_lookup(cx, cache, items, &found)) return false;
+
+  args.rval().setBoolean(found[0]);
+  return true;
+}
+
+bool KvBloomExistsCache::has_many(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "hasMany", 1)) return false;
+
+  BloomExistsCache *cache = bf_exists_cache_instance(cx, args);
+  if (!cache) return false;
+
+  std::vector<std::string> items;
+  if (!read_string_items(cx, args[0], "hasMany", &items)) return false;
+
+  std::vector<bool> found;
+  if (!exists_cache_lookup(cx, cache, items, &found)) return false;
+
+  JSObject *arr = booleans_array(cx, found);
+  if (!arr) return false;
+  args.rval().setObject(*arr);
+  return true;
+}
+
+const JSFunctionSpec KvBloomExistsCache::methods[] = {
+    JS_FN("has", KvBloomExistsCache::has, 1, JSPROP_ENUMERATE),
+    JS_FN("hasMany", KvBloomExistsCache::has_many, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+bool read_exists_cache_ttl(JSContext *cx, JS::HandleValue options_val, double *out) {
+  *out = DEFAULT_BLOOM_EXISTS_CACHE_TTL_SECS;
+  if (options_val.isNullOrUndefined()) return true;
+  if (!options_val.isObject()) {
+    JS_ReportErrorUTF8(cx, "bfExistsCache: options must be an object");
+    return false;
+  }
+
+  JS::RootedObject options(cx, &options_val.toObject());
+  JS::RootedValue ttl_val(cx);
+  if (!JS_GetProperty(cx, options, "ttl", &ttl_val)) return false;
+  if (ttl_val.isUndefined()) return true;
+
+  double ttl;
+  if (!JS::ToNumber(cx, ttl_val, &ttl)) return false;
+  if (!std::isfinite(ttl) || ttl <= 0) {
+    JS_ReportErrorUTF8(cx, "bfExistsCache: ttl must be a positive number of seconds");
+    return false;
+  }
+  *out = ttl;
+  return true;
+}
+
+}  // anonymous namespace
+
+bool KvStore::bf_exists_many(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "bfExistsMany", 2)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    JS::RootedString key_str(cx, JS::ToString(cx, args[0]));
+    if (!key_str) return false;
+
+    auto key = core::encode(cx, key_str);
+    if (!key) return false;
+
+    std::vector<std::string> items;
+    if (!read_string_items(cx, args[1], "bfExistsMany", &items)) {
+        return false;
+    }
+    std::vector<std::string_view> item_views(items.begin(), items.end());
+
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_bf_exists_many(store->store_handle_, std::string_view(key.ptr.get(), key.len), item_views);
+    if (!result.is_ok()) {
+        JS_ReportErrorUTF8(cx, "Error checking bloom filter for key: %s", key.ptr.get());
+        return false;
+    }
+
+    JSObject *found = booleans_array(cx, result.unwrap());
+    if (!found) return false;
+
+    args.rval().setObject(*found);
+    return true;
+}
+
+bool KvStore::bf_exists_cache(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "bfExistsCache", 1)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    JS::RootedString key_str(cx, JS::ToString(cx, args[0]));
+    if (!key_str) return false;
+
+    auto key = core::encode(cx, key_str);
+    if (!key) return false;
+
+    double ttl_secs;
+    if (!read_exists_cache_ttl(cx, args.get(1), &ttl_secs)) {
+        return false;
+    }
+    auto ttl = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(ttl_secs));
+
+    std::string filter_key(key.ptr.get(), key.len);
+    std::string table_key = std::to_string(reinterpret_cast<uintptr_t>(store)) + ':' + filter_key;
+
+    auto &slot = BLOOM_EXISTS_CACHES[table_key];
+    if (!slot) {
+        slot = std::make_unique<BloomExistsCache>();
+        slot->store = store;
+        slot->key = std::move(filter_key);
+        slot->expires_at = std::chrono::steady_clock::now() + ttl;
+    } else if (slot->ttl != ttl) {
+        slot->expires_at = std::min(slot->expires_at, std::chrono::steady_clock::now() + ttl);
+    }
+    slot->ttl = ttl;
+
+    JSObject *cache = KvBloomExistsCache::create(cx, slot.get());
+    if (!cache) return false;
+
+    args.rval().setObject(*cache);
+    return true;
+}
+
+namespace {
+
+// Resolve `args.rval()` with a fresh Promise resolved to `value`.
+bool resolve_with(JSContext *cx, JS::HandleValue value, JS::CallArgs &args) {
+  JS::RootedObject promise(cx, JS::CallOriginalPromiseResolve(cx, value));
+  if (!promise) return false;
+  args.rval().setObject(*promise);
+  return true;
+}
+
+// Decode the bytes of a Uint8Array as UTF-8 into a fresh JS string.
+JSString *decode_utf8_string(JSContext *cx, JS::HandleObject bytes_array) {
+  size_t len = JS_GetTypedArrayLength(bytes_array);
+  std::vector<char> buf(len);
+  if (len > 0) {
+    JS::AutoCheckCannotGC noGC(cx);
+    bool is_shared;
+    void *data = JS_GetArrayBufferViewData(bytes_array, &is_shared, noGC);
+    memcpy(buf.data(), data, len);
+  }
+  return JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(buf.data(), buf.size()));
+}
+
+class KvStoreEntry {
+public:
+  enum class Slot : uint32_t {
+    Bytes = 0,
+    Count
+  };
+
+  static const JSClass class_;
+  static const JSFunctionSpec methods[];
+
+  static bool arrayBuffer(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool text(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool json(JSContext *cx, unsigned argc, JS::Value *vp);
+
+  // Allocates a Uint8Array, copies `bytes` into it, and wraps it in a
+  // freshly-created KvStoreEntry. Returns nullptr on allocation failure
+  // (with a pending JS exception).
+  static JSObject *create(JSContext *cx, const uint8_t *bytes, size_t len);
+};
+
+const JSClass KvStoreEntry::class_ = {
+    "KvStoreEntry",
+    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(KvStoreEntry::Slot::Count))
+};
+
+// Get the Uint8Array stored in a KvStoreEntry's reserved slot.
+JSObject *kv_store_entry_bytes(JSContext *cx, JS::HandleObject self) {
+  JS::Value v = JS::GetReservedSlot(
       self, static_cast<uint32_t>(KvStoreEntry::Slot::Bytes));
   if (!v.isObject()) {
     JS_ReportErrorUTF8(cx, "Invalid KvStoreEntry");
@@ -638,9 +1260,8 @@ bool KvStore::get_entry(JSContext *cx, unsigned argc, JS::Value *vp) {
     }
 
     JS::RootedObject this_obj(cx, &args.thisv().toObject());
-    KvStore* store = get_instance(cx, this_obj);
+    KvStore* store = open_instance(cx, this_obj);
     if (!store) {
-        JS_ReportErrorUTF8(cx, "Invalid KvStore instance");
         return false;
     }
 
@@ -650,6 +1271,7 @@ bool KvStore::get_entry(JSContext *cx, unsigned argc, JS::Value *vp) {
     auto key = core::encode(cx, key_str);
     if (!key) return false;
 
+    host_api::HostArenaScope arena;
     auto result = host_api::kv_store_get(store->store_handle_, std::string_view(key.ptr.get(), key.len));
     if (!result.is_ok()) {
         JS_ReportErrorUTF8(cx, "Error getting key: %s", key.ptr.get());
@@ -678,9 +1300,8 @@ bool KvStore::zrange_by_score_entries(JSContext *cx, unsigned argc, JS::Value *v
     }
 
     JS::RootedObject this_obj(cx, &args.thisv().toObject());
-    KvStore* store = get_instance(cx, this_obj);
+    KvStore* store = open_instance(cx, this_obj);
     if (!store) {
-        JS_ReportErrorUTF8(cx, "Invalid KvStore instance");
         return false;
     }
 
@@ -695,7 +1316,13 @@ bool KvStore::zrange_by_score_entries(JSContext *cx, unsigned argc, JS::Value *v
         return false;
     }
 
-    auto result = host_api::kv_store_zrange_by_score(store->store_handle_, std::string_view(key.ptr.get(), key.len), min, max);
+    host_api::KvStoreZRangeOptions options;
+    if (!read_zrange_options(cx, args.get(3), "zrangeByScoreEntries", &options)) {
+        return false;
+    }
+
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_zrange_by_score(store->store_handle_, std::string_view(key.ptr.get(), key.len), min, max, options);
     if (!result.is_ok()) {
         JS_ReportErrorUTF8(cx, "Error in zrangeByScoreEntries for key: %s", key.ptr.get());
         return ReturnPromiseRejectedWithPendingError(cx, args);
@@ -738,9 +1365,8 @@ bool KvStore::zscan_entries(JSContext *cx, unsigned argc, JS::Value *vp) {
     }
 
     JS::RootedObject this_obj(cx, &args.thisv().toObject());
-    KvStore* store = get_instance(cx, this_obj);
+    KvStore* store = open_instance(cx, this_obj);
     if (!store) {
-        JS_ReportErrorUTF8(cx, "Invalid KvStore instance");
         return false;
     }
 
@@ -756,6 +1382,7 @@ bool KvStore::zscan_entries(JSContext *cx, unsigned argc, JS::Value *vp) {
     auto pattern = core::encode(cx, pattern_str);
     if (!pattern) return false;
 
+    host_api::HostArenaScope arena;
     auto result = host_api::kv_store_zscan(store->store_handle_, std::string_view(key.ptr.get(), key.len), std::string_view(pattern.ptr.get(), pattern.len));
     if (!result.is_ok()) {
         JS_ReportErrorUTF8(cx, "Error in zscanEntries for key: %s", key.ptr.get());
@@ -791,8 +1418,1518 @@ bool KvStore::zscan_entries(JSContext *cx, unsigned argc, JS::Value *vp) {
     return resolve_with(cx, arr_val, args);
 }
 
-bool install(api::Engine *engine) {
-    ENGINE = engine;
+namespace {
+
+// Native state behind a `scanIter` / `zscanIter` iterator. Owns the
+// host-allocated result list and hands it to JS one page at a time, so at
+// most `page_size` JS values are created per step no matter how wide the
+// match is. The list is released as soon as the last page is handed out,
+// on `return()`, or when the iterator is collected — whichever comes first.
+//
+// Only JS materialisation is paged. The key-value WIT interface has no
+// cursor-based scan, so `scanIter` / `zscanIter` fetch the full match list
+// from the host before the first page and hold it in the wasm heap until
+// the cursor releases it.
+struct ScanCursor {
+  enum class Kind : uint8_t { Keys, ZEntries };
+
+  Kind kind;
+  size_t page_size;
+  size_t pos = 0;
+  host_api::KvStoreStringList keys{};
+  host_api::KvStoreZList zentries{};
+
+  ScanCursor(Kind kind, size_t page_size) : kind(kind), page_size(page_size) {}
+  ~ScanCursor() { release(); }
+
+  size_t len() const { return kind == Kind::Keys ? keys.len : zentries.len; }
+
+  void release() {
+    if (keys.ptr) host_api::kv_store_free_string_list(keys);
+    if (zentries.ptr) host_api::kv_store_free_zlist(zentries);
+    pos = 0;
+  }
+};
+
+// Parse the `{ count }` options bag of `scanIter` / `zscanIter`.
+bool read_scan_page_size(JSContext *cx, JS::HandleValue options_val,
+                         const char *fn_name, size_t *out) {
+  *out = DEFAULT_SCAN_PAGE_SIZE;
+  if (options_val.isNullOrUndefined()) return true;
+  if (!options_val.isObject()) {
+    JS_ReportErrorUTF8(cx, "%s: options must be an object", fn_name);
+    return false;
+  }
+
+  JS::RootedObject options(cx, &options_val.toObject());
+  JS::RootedValue count_val(cx);
+  if (!JS_GetProperty(cx, options, "count", &count_val)) return false;
+  if (count_val.isUndefined()) return true;
+
+  double count;
+  if (!JS::ToNumber(cx, count_val, &count)) return false;
+  if (!std::isfinite(count) || std::trunc(count) != count || count < 1 ||
+      count > static_cast<double>(UINT32_MAX)) {
+    JS_ReportErrorUTF8(cx, "%s: count must be a positive integer", fn_name);
+    return false;
+  }
+  *out = static_cast<size_t>(count);
+  return true;
+}
+
+// Build a JS array of keys from `keys[start, start + n)`.
+JSObject *keys_page(JSContext *cx, HostString *keys, size_t start, size_t n) {
+  JS::RootedObject page(cx, JS::NewArrayObject(cx, n));
+  if (!page) return nullptr;
+
+  JS::RootedString key_str(cx);
+  JS::RootedValue key_val(cx);
+  for (size_t i = 0; i < n; i++) {
+    HostString &key = keys[start + i];
+    key_str = JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(key.begin(), key.size()));
+    if (!key_str) return nullptr;
+    key_val.setString(key_str);
+    if (!JS_SetElement(cx, page, i, key_val)) return nullptr;
+  }
+  return page;
+}
+
+// Build a JS array of [Uint8Array, score] tuples from `tuples[start, start + n)`.
+JSObject *zentries_page(JSContext *cx, const host_api::KvStoreTuple *tuples,
+                        size_t start, size_t n) {
+  JS::RootedObject page(cx, JS::NewArrayObject(cx, n));
+  if (!page) return nullptr;
+
+  JS::RootedObject byte_array(cx);
+  JS::RootedObject tuple(cx);
+  JS::RootedValue value_val(cx);
+  JS::RootedValue score_val(cx);
+  JS::RootedValue tuple_val(cx);
+  for (size_t i = 0; i < n; i++) {
+    const host_api::KvStoreTuple &entry = tuples[start + i];
+    byte_array = JS_NewUint8Array(cx, entry.f0.len);
+    if (!byte_array) return nullptr;
+
+    if (entry.f0.len > 0) {
+      JS::AutoCheckCannotGC noGC(cx);
+      bool is_shared;
+      void *dst = JS_GetArrayBufferViewData(byte_array, &is_shared, noGC);
+      memcpy(dst, entry.f0.ptr, entry.f0.len);
+    }
+
+    tuple = JS::NewArrayObject(cx, 2);
+    if (!tuple) return nullptr;
+
+    value_val.setObject(*byte_array);
+    score_val.setDouble(entry.f1);
+    if (!JS_SetElement(cx, tuple, 0, value_val) ||
+        !JS_SetElement(cx, tuple, 1, score_val)) {
+      return nullptr;
+    }
+
+    tuple_val.setObject(*tuple);
+    if (!JS_SetElement(cx, page, i, tuple_val)) return nullptr;
+  }
+  return page;
+}
+
+class KvScanIterator {
+public:
+  enum class Slot : uint32_t {
+    Cursor = 0,
+    Count
+  };
+
+  static const JSClass class_;
+  static const JSFunctionSpec methods[];
+
+  static bool next(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool return_(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool async_iterator(JSContext *cx, unsigned argc, JS::Value *vp);
+
+  static void finalize(JS::GCContext *gcx, JSObject *obj);
+
+  // Wraps `cursor` in a fresh iterator object, taking ownership of it.
+  // Returns nullptr on allocation failure (with a pending JS exception).
+  static JSObject *create(JSContext *cx, std::unique_ptr<ScanCursor> cursor);
+};
+
+static const JSClassOps kv_scan_iterator_class_ops = {
+    .finalize = KvScanIterator::finalize,
+};
+
+const JSClass KvScanIterator::class_ = {
+    "KvScanIterator",
+    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(KvScanIterator::Slot::Count)) |
+        JSCLASS_FOREGROUND_FINALIZE,
+    &kv_scan_iterator_class_ops
+};
+
+ScanCursor *scan_cursor(JSObject *obj) {
+  if (!obj || JS::GetClass(obj) != &KvScanIterator::class_) return nullptr;
+  JS::Value v = JS::GetReservedSlot(
+      obj, static_cast<uint32_t>(KvScanIterator::Slot::Cursor));
+  if (v.isUndefined()) return nullptr;
+  return static_cast<ScanCursor *>(v.toPrivate());
+}
+
+void KvScanIterator::finalize(JS::GCContext *gcx, JSObject *obj) {
+  delete scan_cursor(obj);
+}
+
+JSObject *KvScanIterator::create(JSContext *cx, std::unique_ptr<ScanCursor> cursor) {
+  JS::RootedObject proto(cx, *KV_SCAN_ITERATOR_PROTO);
+  JS::RootedObject iter(cx,
+      JS_NewObjectWithGivenProto(cx, &KvScanIterator::class_, proto));
+  if (!iter) return nullptr;
+
+  JS::SetReservedSlot(iter, static_cast<uint32_t>(Slot::Cursor),
+                      JS::PrivateValue(cursor.release()));
+  return iter;
+}
+
+// Resolve `args.rval()` with a fresh `{ value, done }` iterator result.
+bool resolve_iter_result(JSContext *cx, JS::HandleValue value, bool done,
+                         JS::CallArgs &args) {
+  JS::RootedObject result(cx, JS_NewPlainObject(cx));
+  if (!result) return false;
+  JS::RootedValue done_val(cx, JS::BooleanValue(done));
+  if (!JS_DefineProperty(cx, result, "value", value, JSPROP_ENUMERATE) ||
+      !JS_DefineProperty(cx, result, "done", done_val, JSPROP_ENUMERATE)) {
+    return false;
+  }
+  JS::RootedValue result_val(cx, JS::ObjectValue(*result));
+  return resolve_with(cx, result_val, args);
+}
+
+bool KvScanIterator::next(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  ScanCursor *cursor =
+      args.thisv().isObject() ? scan_cursor(&args.thisv().toObject()) : nullptr;
+  if (!cursor) {
+    JS_ReportErrorUTF8(cx, "Invalid KvScanIterator");
+    return ReturnPromiseRejectedWithPendingError(cx, args);
+  }
+
+  JS::RootedValue undef(cx, JS::UndefinedValue());
+  size_t len = cursor->len();
+  if (cursor->pos >= len) {
+    cursor->release();
+    return resolve_iter_result(cx, undef, true, args);
+  }
+
+  size_t n = std::min(cursor->page_size, len - cursor->pos);
+  JS::RootedObject page(cx,
+      cursor->kind == ScanCursor::Kind::Keys
+          ? keys_page(cx, cursor->keys.ptr, cursor->pos, n)
+          : zentries_page(cx, cursor->zentries.ptr, cursor->pos, n));
+  if (!page) return ReturnPromiseRejectedWithPendingError(cx, args);
+
+  cursor->pos += n;
+  if (cursor->pos >= len) {
+    // Last page handed out — give the host buffer back now rather than
+    // waiting for the final `next()` or for GC.
+    cursor->release();
+  }
+
+  JS::RootedValue page_val(cx, JS::ObjectValue(*page));
+  return resolve_iter_result(cx, page_val, false, args);
+}
+
+// Called by `for await` on early exit (`break`, `throw`); frees the
+// remaining result list immediately.
+bool KvScanIterator::return_(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  ScanCursor *cursor =
+      args.thisv().isObject() ? scan_cursor(&args.thisv().toObject()) : nullptr;
+  if (!cursor) {
+    JS_ReportErrorUTF8(cx, "Invalid KvScanIterator");
+    return ReturnPromiseRejectedWithPendingError(cx, args);
+  }
+
+  cursor->release();
+  return resolve_iter_result(cx, args.get(0), true, args);
+}
+
+bool KvScanIterator::async_iterator(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  args.rval().set(args.thisv());
+  return true;
+}
+
+const JSFunctionSpec KvScanIterator::methods[] = {
+    JS_FN("next",   KvScanIterator::next,    0, JSPROP_ENUMERATE),
+    JS_FN("return", KvScanIterator::return_, 1, JSPROP_ENUMERATE),
+    JS_SYM_FN(asyncIterator, KvScanIterator::async_iterator, 0, 0),
+    JS_FS_END,
+};
+
+}  // anonymous namespace
+
+bool KvStore::scan_iter(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "scanIter", 1)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    JS::RootedString pattern_str(cx, JS::ToString(cx, args[0]));
+    if (!pattern_str) return false;
+
+    auto pattern = core::encode(cx, pattern_str);
+    if (!pattern) return false;
+
+    size_t page_size;
+    if (!read_scan_page_size(cx, args.get(1), "scanIter", &page_size)) {
+        return false;
+    }
+
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_scan(store->store_handle_, std::string_view(pattern.ptr.get(), pattern.len));
+    if (!result.is_ok()) {
+        JS_ReportErrorUTF8(cx, "Error scanning with pattern: %s (Only prefix matching is supported. e.g. 'foo*')", pattern.ptr.get());
+        return false;
+    }
+
+    auto cursor = std::make_unique<ScanCursor>(ScanCursor::Kind::Keys, page_size);
+    cursor->keys = result.unwrap();
+    host_api::host_arena_detach(cursor->keys.ptr);
+
+    JSObject *iter = KvScanIterator::create(cx, std::move(cursor));
+    if (!iter) return false;
+
+    args.rval().setObject(*iter);
+    return true;
+}
+
+bool KvStore::zscan_iter(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "zscanIter", 2)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    JS::RootedString key_str(cx, JS::ToString(cx, args[0]));
+    if (!key_str) return false;
+
+    auto key = core::encode(cx, key_str);
+    if (!key) return false;
+
+    JS::RootedString pattern_str(cx, JS::ToString(cx, args[1]));
+    if (!pattern_str) return false;
+
+    auto pattern = core::encode(cx, pattern_str);
+    if (!pattern) return false;
+
+    size_t page_size;
+    if (!read_scan_page_size(cx, args.get(2), "zscanIter", &page_size)) {
+        return false;
+    }
+
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_zscan(store->store_handle_, std::string_view(key.ptr.get(), key.len), std::string_view(pattern.ptr.get(), pattern.len));
+    if (!result.is_ok()) {
+        JS_ReportErrorUTF8(cx, "Error in zscanIter for key: %s", key.ptr.get());
+        return false;
+    }
+
+    auto cursor = std::make_unique<ScanCursor>(ScanCursor::Kind::ZEntries, page_size);
+    cursor->zentries = result.unwrap();
+    host_api::host_arena_detach(cursor->zentries.ptr);
+
+    JSObject *iter = KvScanIterator::create(cx, std::move(cursor));
+    if (!iter) return false;
+
+    args.rval().setObject(*iter);
+    return true;
+}
+
+namespace {
+
+// Pack a host sorted-set result into `{ values, offsets, scores }`:
+//   values  — Uint8Array holding every member's bytes back to back
+//   offsets — Uint32Array of length n + 1; member i is
+//             values.subarray(offsets[i], offsets[i + 1])
+//   scores  — Float64Array of length n
+// Four allocations regardless of n, instead of three per member.
+JSObject *zlist_columnar(JSContext *cx, const host_api::KvStoreZList &tuples) {
+  size_t total = 0;
+  for (size_t i = 0; i < tuples.len; i++) {
+    total += tuples.ptr[i].f0.len;
+  }
+  if (total > UINT32_MAX) {
+    JS_ReportErrorUTF8(cx, "Sorted set result too large for columnar layout");
+    return nullptr;
+  }
+
+  JS::RootedObject values(cx, JS_NewUint8Array(cx, total));
+  if (!values) return nullptr;
+  JS::RootedObject offsets(cx, JS_NewUint32Array(cx, tuples.len + 1));
+  if (!offsets) return nullptr;
+  JS::RootedObject scores(cx, JS_NewFloat64Array(cx, tuples.len));
+  if (!scores) return nullptr;
+
+  {
+    JS::AutoCheckCannotGC noGC(cx);
+    bool is_shared;
+    auto *values_data = static_cast<uint8_t *>(
+        JS_GetArrayBufferViewData(values, &is_shared, noGC));
+    auto *offsets_data = static_cast<uint32_t *>(
+        JS_GetArrayBufferViewData(offsets, &is_shared, noGC));
+    auto *scores_data = static_cast<double *>(
+        JS_GetArrayBufferViewData(scores, &is_shared, noGC));
+
+    uint32_t offset = 0;
+    for (size_t i = 0; i < tuples.len; i++) {
+      const host_api::KvStoreTuple &entry = tuples.ptr[i];
+      offsets_data[i] = offset;
+      if (entry.f0.len > 0) {
+        memcpy(values_data + offset, entry.f0.ptr, entry.f0.len);
+      }
+      offset += static_cast<uint32_t>(entry.f0.len);
+      scores_data[i] = entry.f1;
+    }
+    offsets_data[tuples.len] = offset;
+  }
+
+  JS::RootedObject result(cx, JS_NewPlainObject(cx));
+  if (!result) return nullptr;
+  JS::RootedValue values_val(cx, JS::ObjectValue(*values));
+  JS::RootedValue offsets_val(cx, JS::ObjectValue(*offsets));
+  JS::RootedValue scores_val(cx, JS::ObjectValue(*scores));
+  if (!JS_DefineProperty(cx, result, "values", values_val, JSPROP_ENUMERATE) ||
+      !JS_DefineProperty(cx, result, "offsets", offsets_val, JSPROP_ENUMERATE) ||
+      !JS_DefineProperty(cx, result, "scores", scores_val, JSPROP_ENUMERATE)) {
+    return nullptr;
+  }
+  return result;
+}
+
+}  // anonymous namespace
+
+bool KvStore::zrange_by_score_columnar(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "zrangeByScoreColumnar", 3)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    JS::RootedString key_str(cx, JS::ToString(cx, args[0]));
+    if (!key_str) return false;
+
+    auto key = core::encode(cx, key_str);
+    if (!key) return false;
+
+    double min, max;
+    if (!JS::ToNumber(cx, args[1], &min) || !JS::ToNumber(cx, args[2], &max)) {
+        return false;
+    }
+
+    host_api::KvStoreZRangeOptions options;
+    if (!read_zrange_options(cx, args.get(3), "zrangeByScoreColumnar", &options)) {
+        return false;
+    }
+
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_zrange_by_score(store->store_handle_, std::string_view(key.ptr.get(), key.len), min, max, options);
+    if (!result.is_ok()) {
+        JS_ReportErrorUTF8(cx, "Error in zrangeByScoreColumnar for key: %s", key.ptr.get());
+        return false;
+    }
+
+    JSObject *columns = zlist_columnar(cx, result.unwrap());
+    if (!columns) return false;
+
+    args.rval().setObject(*columns);
+    return true;
+}
+
+bool KvStore::zscan_columnar(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "zscanColumnar", 2)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    JS::RootedString key_str(cx, JS::ToString(cx, args[0]));
+    if (!key_str) return false;
+
+    auto key = core::encode(cx, key_str);
+    if (!key) return false;
+
+    JS::RootedString pattern_str(cx, JS::ToString(cx, args[1]));
+    if (!pattern_str) return false;
+
+    auto pattern = core::encode(cx, pattern_str);
+    if (!pattern) return false;
+
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_zscan(store->store_handle_, std::string_view(key.ptr.get(), key.len), std::string_view(pattern.ptr.get(), pattern.len));
+    if (!result.is_ok()) {
+        JS_ReportErrorUTF8(cx, "Error in zscanColumnar for key: %s", key.ptr.get());
+        return false;
+    }
+
+    JSObject *columns = zlist_columnar(cx, result.unwrap());
+    if (!columns) return false;
+
+    args.rval().setObject(*columns);
+    return true;
+}
+
+namespace {
+
+// Cursor into one shard's result list during a k-way merge.
+struct MergeCursor {
+  const host_api::KvStoreTuple *entries;
+  size_t len;
+  size_t pos;
+  size_t shard;
+};
+
+}  // anonymous namespace
+
+bool KvStore::zmerge(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "zmerge", 3)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    std::vector<std::string> keys;
+    if (!read_string_items(cx, args[0], "zmerge", &keys)) {
+        return false;
+    }
+
+    double min, max;
+    if (!JS::ToNumber(cx, args[1], &min) || !JS::ToNumber(cx, args[2], &max)) {
+        return false;
+    }
+
+    // `limit` is the documented name here; `count` is accepted for parity
+    // with zrangeByScore.
+    host_api::KvStoreZRangeOptions options;
+    if (!read_zrange_options(cx, args.get(3), "zmerge", &options)) {
+        return false;
+    }
+    if (args.get(3).isObject()) {
+        JS::RootedObject options_obj(cx, &args.get(3).toObject());
+        std::optional<size_t> limit;
+        if (!read_index_option(cx, options_obj, "limit", "zmerge", &limit)) {
+            return false;
+        }
+        if (limit) {
+            options.count = limit;
+        }
+    }
+
+    // No shard can contribute more than `offset + limit` members to the
+    // merged window, so each one is trimmed to that before it is copied.
+    host_api::KvStoreZRangeOptions shard_options = options;
+    shard_options.offset = 0;
+    if (options.count) {
+        shard_options.count = options.offset + *options.count;
+    }
+
+    std::vector<std::string_view> key_views(keys.begin(), keys.end());
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_zrange_by_score_many(store->store_handle_, key_views, min, max, shard_options);
+    if (!result.is_ok()) {
+        JS_ReportErrorUTF8(cx, "Error in zmerge for %zu keys", keys.size());
+        return false;
+    }
+    const auto &lists = result.unwrap();
+
+    // Each list is already ordered in the merge direction, so a heap over
+    // the list heads yields the merged order. Ties go to the earlier key.
+    bool reverse = options.reverse;
+    auto after = [reverse](const MergeCursor &a, const MergeCursor &b) {
+        double sa = a.entries[a.pos].f1;
+        double sb = b.entries[b.pos].f1;
+        if (sa != sb) {
+            return reverse ? sa < sb : sa > sb;
+        }
+        return a.shard > b.shard;
+    };
+    std::vector<MergeCursor> heap;
+    heap.reserve(lists.size());
+    size_t total = 0;
+    for (size_t i = 0; i < lists.size(); i++) {
+        if (lists[i].len > 0) {
+            heap.push_back({lists[i].ptr, lists[i].len, 0, i});
+            total += lists[i].len;
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), after);
+
+    size_t skip = std::min(options.offset, total);
+    size_t take = std::min(options.count.value_or(total), total - skip);
+
+    JS::RootedObject tuples_array(cx, JS::NewArrayObject(cx, take));
+    if (!tuples_array) {
+        return false;
+    }
+
+    JS::RootedObject byte_array(cx);
+    JS::RootedObject tuple(cx);
+    JS::RootedValue elem(cx);
+    for (size_t emitted = 0; emitted < skip + take; emitted++) {
+        std::pop_heap(heap.begin(), heap.end(), after);
+        MergeCursor &top = heap.back();
+        const host_api::KvStoreTuple &entry = top.entries[top.pos];
+
+        if (emitted >= skip) {
+            byte_array = JS_NewUint8Array(cx, entry.f0.len);
+            if (!byte_array) {
+                return false;
+            }
+            if (entry.f0.len > 0) {
+                JS::AutoCheckCannotGC noGC(cx);
+                bool is_shared;
+                void *dst = JS_GetArrayBufferViewData(byte_array, &is_shared, noGC);
+                memcpy(dst, entry.f0.ptr, entry.f0.len);
+            }
+
+            tuple = JS::NewArrayObject(cx, 2);
+            if (!tuple) {
+                return false;
+            }
+            elem.setObject(*byte_array);
+            if (!JS_SetElement(cx, tuple, 0, elem)) {
+                return false;
+            }
+            elem.setDouble(entry.f1);
+            if (!JS_SetElement(cx, tuple, 1, elem)) {
+                return false;
+            }
+
+            elem.setObject(*tuple);
+            if (!JS_SetElement(cx, tuples_array, static_cast<uint32_t>(emitted - skip), elem)) {
+                return false;
+            }
+        }
+
+        if (++top.pos < top.len) {
+            std::push_heap(heap.begin(), heap.end(), after);
+        } else {
+            heap.pop_back();
+        }
+    }
+
+    args.rval().setObject(*tuples_array);
+    return true;
+}
+
+namespace {
+
+// Geohash parameters used by Redis GEOADD: 26 bits per axis interleaved
+// into a 52-bit integer that is stored exactly as the sorted-set score.
+constexpr int GEO_STEP_MAX = 26;
+constexpr double GEO_LAT_MIN = -85.05112878;
+constexpr double GEO_LAT_MAX = 85.05112878;
+constexpr double GEO_LON_MIN = -180;
+constexpr double GEO_LON_MAX = 180;
+constexpr double EARTH_RADIUS_KM = 6372.797560856;
+constexpr double KM_PER_DEGREE = EARTH_RADIUS_KM * M_PI / 180;
+
+// Spread the low 32 bits of `v` over the even bits of the result.
+uint64_t spread_bits(uint32_t v) {
+  uint64_t x = v;
+  x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x << 2)) & 0x3333333333333333ULL;
+  x = (x | (x << 1)) & 0x5555555555555555ULL;
+  return x;
+}
+
+// Inverse of spread_bits: gather the even bits of `x`.
+uint32_t squash_bits(uint64_t x) {
+  x &= 0x5555555555555555ULL;
+  x = (x | (x >> 1)) & 0x3333333333333333ULL;
+  x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+  return static_cast<uint32_t>(x);
+}
+
+// Latitude occupies the even bits, longitude the odd bits.
+uint64_t geo_interleave(uint32_t lat_idx, uint32_t lon_idx) {
+  return spread_bits(lat_idx) | (spread_bits(lon_idx) << 1);
+}
+
+uint32_t geo_cell_index(double v, double lo, double hi, int step) {
+  double cells = static_cast<double>(uint64_t(1) << step);
+  double idx = std::floor((v - lo) / (hi - lo) * cells);
+  return static_cast<uint32_t>(std::clamp(idx, 0.0, cells - 1));
+}
+
+// Centre of the full-precision cell encoded in a GEOADD score.
+void geo_decode(double score, double *lat, double *lon) {
+  uint64_t bits = static_cast<uint64_t>(score);
+  double cells = static_cast<double>(uint64_t(1) << GEO_STEP_MAX);
+  double lat_idx = squash_bits(bits);
+  double lon_idx = squash_bits(bits >> 1);
+  *lat = GEO_LAT_MIN + (lat_idx + 0.5) / cells * (GEO_LAT_MAX - GEO_LAT_MIN);
+  *lon = GEO_LON_MIN + (lon_idx + 0.5) / cells * (GEO_LON_MAX - GEO_LON_MIN);
+}
+
+double haversine_km(double lat1, double lon1, double lat2, double lon2) {
+  constexpr double rad = M_PI / 180;
+  double u = std::sin((lat2 - lat1) * rad / 2);
+  double v = std::sin((lon2 - lon1) * rad / 2);
+  double a = u * u + std::cos(lat1 * rad) * std::cos(lat2 * rad) * v * v;
+  return 2 * EARTH_RADIUS_KM * std::asin(std::sqrt(a));
+}
+
+// Finest geohash step whose cells are at least `radius_km` tall and wide
+// around `lat`, so the 3x3 block of cells around the centre covers the
+// whole search circle.
+int geo_search_step(double lat, double radius_km) {
+  double lat_delta = radius_km / KM_PER_DEGREE;
+  double cos_lat = std::cos(lat * M_PI / 180);
+  double lon_delta = cos_lat > 1e-6 ? radius_km / (KM_PER_DEGREE * cos_lat) : GEO_LON_MAX;
+
+  int step = GEO_STEP_MAX;
+  while (step > 1) {
+    double cells = static_cast<double>(uint64_t(1) << step);
+    if ((GEO_LAT_MAX - GEO_LAT_MIN) / cells >= lat_delta &&
+        (GEO_LON_MAX - GEO_LON_MIN) / cells >= lon_delta) {
+      break;
+    }
+    step--;
+  }
+  return step;
+}
+
+// Score ranges [min, max) covering the 3x3 cells around (lat, lon) at
+// `step`, sorted and with adjacent ranges coalesced.
+std::vector<std::pair<double, double>> geo_search_ranges(double lat, double lon, int step) {
+  int64_t cells = int64_t(1) << step;
+  int64_t lat_idx = geo_cell_index(lat, GEO_LAT_MIN, GEO_LAT_MAX, step);
+  int64_t lon_idx = geo_cell_index(lon, GEO_LON_MIN, GEO_LON_MAX, step);
+  int shift = 2 * (GEO_STEP_MAX - step);
+
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  for (int64_t dlat = -1; dlat <= 1; dlat++) {
+    int64_t la = lat_idx + dlat;
+    if (la < 0 || la >= cells) continue;
+    for (int64_t dlon = -1; dlon <= 1; dlon++) {
+      // Longitude wraps at the antimeridian.
+      int64_t lo = ((lon_idx + dlon) % cells + cells) % cells;
+      uint64_t bits = geo_interleave(static_cast<uint32_t>(la), static_cast<uint32_t>(lo));
+      ranges.emplace_back(bits << shift, (bits + 1) << shift);
+    }
+  }
+
+  std::sort(ranges.begin(), ranges.end());
+  std::vector<std::pair<double, double>> merged;
+  for (const auto &range : ranges) {
+    if (!merged.empty() && static_cast<uint64_t>(merged.back().second) >= range.first) {
+      merged.back().second = std::max(merged.back().second, static_cast<double>(range.second));
+    } else {
+      merged.emplace_back(static_cast<double>(range.first), static_cast<double>(range.second));
+    }
+  }
+  return merged;
+}
+
+struct GeoMatch {
+  const host_api::KvStoreTuple *entry;
+  double lat;
+  double lon;
+  double distance_km;
+};
+
+bool read_geo_coordinate(JSContext *cx, JS::HandleValue val, const char *name,
+                         double lo, double hi, double *out) {
+  if (!JS::ToNumber(cx, val, out)) return false;
+  if (val.isNullOrUndefined() || !std::isfinite(*out) || *out < lo || *out > hi) {
+    JS_ReportErrorUTF8(cx, "geoNearby: %s must be a number between %g and %g", name, lo, hi);
+    return false;
+  }
+  return true;
+}
+
+}  // anonymous namespace
+
+bool KvStore::geo_nearby(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "geoNearby", 4)) {
+        return false;
+    }
+
+    JS::RootedObject this_obj(cx, &args.thisv().toObject());
+    KvStore* store = open_instance(cx, this_obj);
+    if (!store) {
+        return false;
+    }
+
+    JS::RootedString key_str(cx, JS::ToString(cx, args[0]));
+    if (!key_str) return false;
+
+    auto key = core::encode(cx, key_str);
+    if (!key) return false;
+
+    double lat, lon, radius_km;
+    if (!read_geo_coordinate(cx, args[1], "latitude", GEO_LAT_MIN, GEO_LAT_MAX, &lat) ||
+        !read_geo_coordinate(cx, args[2], "longitude", GEO_LON_MIN, GEO_LON_MAX, &lon)) {
+        return false;
+    }
+    if (!JS::ToNumber(cx, args[3], &radius_km)) return false;
+    if (!std::isfinite(radius_km) || radius_km <= 0) {
+        JS_ReportErrorUTF8(cx, "geoNearby: radiusKm must be a positive number");
+        return false;
+    }
+
+    std::optional<size_t> limit;
+    if (!args.get(4).isNullOrUndefined()) {
+        if (!args.get(4).isObject()) {
+            JS_ReportErrorUTF8(cx, "geoNearby: options must be an object");
+            return false;
+        }
+        JS::RootedObject options(cx, &args.get(4).toObject());
+        if (!read_index_option(cx, options, "limit", "geoNearby", &limit)) {
+            return false;
+        }
+    }
+
+    int step = geo_search_step(lat, radius_km);
+    auto ranges = geo_search_ranges(lat, lon, step);
+
+    host_api::KvStoreZRangeOptions range_options;
+    range_options.max_exclusive = true;
+
+    // All range results stay alive in the arena until the matches have
+    // been copied out below.
+    host_api::HostArenaScope arena;
+    std::vector<GeoMatch> matches;
+    std::string_view key_view(key.ptr.get(), key.len);
+    for (const auto &range : ranges) {
+        auto result = host_api::kv_store_zrange_by_score(store->store_handle_, key_view,
+                                                         range.first, range.second, range_options);
+        if (!result.is_ok()) {
+            JS_ReportErrorUTF8(cx, "Error in geoNearby for key: %s", key.ptr.get());
+            return false;
+        }
+
+        auto list = result.unwrap();
+        for (size_t i = 0; i < list.len; i++) {
+            GeoMatch match{&list.ptr[i], 0, 0, 0};
+            geo_decode(list.ptr[i].f1, &match.lat, &match.lon);
+            match.distance_km = haversine_km(lat, lon, match.lat, match.lon);
+            if (match.distance_km <= radius_km) {
+                matches.push_back(match);
+            }
+        }
+    }
+
+    size_t take = std::min(limit.value_or(matches.size()), matches.size());
+    auto by_distance = [](const GeoMatch &a, const GeoMatch &b) {
+        return a.distance_km < b.distance_km;
+    };
+    std::partial_sort(matches.begin(), matches.begin() + take, matches.end(), by_distance);
+
+    JS::RootedObject results(cx, JS::NewArrayObject(cx, take));
+    if (!results) return false;
+
+    JS::RootedObject item(cx);
+    JS::RootedString member(cx);
+    JS::RootedValue val(cx);
+    for (size_t i = 0; i < take; i++) {
+        const GeoMatch &match = matches[i];
+
+        item = JS_NewPlainObject(cx);
+        if (!item) return false;
+
+        member = JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(
+            reinterpret_cast<const char *>(match.entry->f0.ptr), match.entry->f0.len));
+        if (!member) return false;
+        val.setString(member);
+        if (!JS_DefineProperty(cx, item, "member", val, JSPROP_ENUMERATE)) return false;
+
+        val.setDouble(match.distance_km);
+        if (!JS_DefineProperty(cx, item, "distanceKm", val, JSPROP_ENUMERATE)) return false;
+        val.setDouble(match.lat);
+        if (!JS_DefineProperty(cx, item, "latitude", val, JSPROP_ENUMERATE)) return false;
+        val.setDouble(match.lon);
+        if (!JS_DefineProperty(cx, item, "longitude", val, JSPROP_ENUMERATE)) return false;
+
+        val.setObject(*item);
+        if (!JS_SetElement(cx, results, static_cast<uint32_t>(i), val)) return false;
+    }
+
+    args.rval().setObject(*results);
+    return true;
+}
+
+namespace {
+
+// Refuse to mirror stores whose values add up to more than this. Mirrors
+// are meant for small, hot stores (redirects, tenant config, allow-lists).
+constexpr size_t MAX_MIRROR_BYTES = 16 * 1024 * 1024;
+
+// Default interval between mirror refreshes, in milliseconds.
+constexpr double DEFAULT_MIRROR_REFRESH_MS = 60000;
+
+struct MirrorMember {
+  std::vector<uint8_t> value;
+  double score;
+};
+
+// Read-only copy of a whole store, shared by every `openMirrored(name)`
+// in the instance and owned by MIRRORS. String values are loaded eagerly;
+// sorted sets are pulled in full on first use, since `scan` cannot tell
+// them apart from string keys.
+struct MirrorState {
+  // Borrowed from the KvStore handle table, which never frees entries.
+  KvStore *store;
+  std::string name;
+  std::chrono::steady_clock::duration refresh_interval;
+  std::chrono::steady_clock::time_point loaded_at;
+  bool refresh_pending = false;
+  size_t bytes = 0;
+  std::map<std::string, std::vector<uint8_t>> entries;
+  // Members sorted by ascending score.
+  std::unordered_map<std::string, std::vector<MirrorMember>> zsets;
+
+  bool stale() const {
+    return std::chrono::steady_clock::now() - loaded_at >= refresh_interval;
+  }
+};
+
+std::unordered_map<std::string, std::unique_ptr<MirrorState>> MIRRORS;
+
+// Shared prototype for KvMirror wrappers. Initialised in `install()`.
+JS::PersistentRooted<JSObject *> *KV_MIRROR_PROTO = nullptr;
+
+// Whether `c` is in the `[...]` class whose `[` is at `pattern[p]`. Sets
+// `*next` just past the closing `]`; like Redis, an unterminated class runs
+// to the end of the pattern. Supports `^` negation, `a-z` ranges and `\`
+// escapes.
+bool glob_class_match(std::string_view pattern, size_t p, char c, size_t *next) {
+  auto byte = [](char ch) { return static_cast<unsigned char>(ch); };
+  size_t i = p + 1;
+  bool negate = i < pattern.size() && pattern[i] == '^';
+  if (negate) i++;
+  bool matched = false;
+  while (i < pattern.size() && pattern[i] != ']') {
+    if (pattern[i] == '\\' && i + 1 < pattern.size()) {
+      matched |= pattern[i + 1] == c;
+      i += 2;
+    } else if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+      unsigned char lo = byte(pattern[i]);
+      unsigned char hi = byte(pattern[i + 2]);
+      if (lo > hi) std::swap(lo, hi);
+      matched |= byte(c) >= lo && byte(c) <= hi;
+      i += 3;
+    } else {
+      matched |= pattern[i] == c;
+      i++;
+    }
+  }
+  *next = i < pattern.size() ? i + 1 : i;
+  return matched != negate;
+}
+
+// Redis-style glob match supporting `*`, `?`, `[...]` classes and `\`
+// escapes.
+bool glob_match(std::string_view pattern, std::string_view str) {
+  size_t p = 0, s = 0;
+  size_t star_p = std::string_view::npos, star_s = 0;
+  while (s < str.size()) {
+    size_t next = p + 1;
+    bool step = false;
+    if (p < pattern.size()) {
+      switch (pattern[p]) {
+        case '*':
+          star_p = p++;
+          star_s = s;
+          continue;
+        case '?':
+          step = true;
+          break;
+        case '[':
+          step = glob_class_match(pattern, p, str[s], &next);
+          break;
+        case '\\':
+          next = p + 2;
+          step = p + 1 < pattern.size() && pattern[p + 1] == str[s];
+          break;
+        default:
+          step = pattern[p] == str[s];
+          break;
+      }
+    }
+    if (step) {
+      p = next;
+      s++;
+    } else if (star_p != std::string_view::npos) {
+      p = star_p + 1;
+      s = ++star_s;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') p++;
+  return p == pattern.size();
+}
+
+// Literal prefix of a glob pattern, up to its first wildcard, class or
+// escape.
+std::string_view glob_prefix(std::string_view pattern) {
+  size_t end = pattern.find_first_of("*?[\\");
+  return end == std::string_view::npos ? pattern : pattern.substr(0, end);
+}
+
+// Replace the contents of `state` with a fresh copy of the store. Leaves
+// `state` untouched and reports an error if any host call fails.
+bool mirror_load(JSContext *cx, MirrorState *state) {
+  if (state->store->closed()) {
+    JS_ReportErrorUTF8(cx, "Error mirroring store %s: store is closed", state->name.c_str());
+    return false;
+  }
+
+  std::vector<std::string> keys;
+  {
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_scan(state->store->handle(), "*");
+    if (!result.is_ok()) {
+      JS_ReportErrorUTF8(cx, "Error mirroring store %s: scan failed", state->name.c_str());
+      return false;
+    }
+    auto list = result.unwrap();
+    keys.reserve(list.len);
+    for (size_t i = 0; i < list.len; i++) {
+      keys.emplace_back(list.ptr[i].begin(), list.ptr[i].size());
+    }
+  }
+
+  // The key-value WIT interface has no multi-get, so values are fetched
+  // one key at a time. Keys deleted since the scan are skipped. Any `get`
+  // error fails the load: the host contract doesn't say how a key of
+  // another type (a sorted set or Bloom filter) is reported, so no error
+  // can safely be read as "skip this key".
+  std::map<std::string, std::vector<uint8_t>> entries;
+  size_t bytes = 0;
+  for (auto &key : keys) {
+    host_api::HostArenaScope arena;
+    auto result = host_api::kv_store_get(state->store->handle(), key);
+    if (!result.is_ok()) {
+      JS_ReportErrorUTF8(cx, "Error mirroring store %s: get failed for key %s",
+                         state->name.c_str(), key.c_str());
+      return false;
+    }
+    if (!result.unwrap().is_some()) {
+      continue;
+    }
+    auto value = result.unwrap().unwrap();
+    bytes += key.size() + value.len;
+    if (bytes > MAX_MIRROR_BYTES) {
+      JS_ReportErrorUTF8(cx, "Error mirroring store %s: store exceeds %zu bytes",
+                         state->name.c_str(), MAX_MIRROR_BYTES);
+      return false;
+    }
+    entries.emplace(std::move(key), std::vector<uint8_t>(value.ptr, value.ptr + value.len));
+  }
+
+  state->entries = std::move(entries);
+  state->zsets.clear();
+  state->bytes = bytes;
+  state->loaded_at = std::chrono::steady_clock::now();
+  return true;
+}
+
+// Sorted set `key` from the mirror, pulling it from the host on first use.
+const std::vector<MirrorMember> *mirror_zset(JSContext *cx, MirrorState *state, const std::string &key) {
+  auto cached = state->zsets.find(key);
+  if (cached != state->zsets.end()) {
+    return &cached->second;
+  }
+
+  if (state->store->closed()) {
+    JS_ReportErrorUTF8(cx, "KvStore is closed; call KvStore.open() again to reopen it");
+    return nullptr;
+  }
+
+  host_api::HostArenaScope arena;
+  auto result = host_api::kv_store_zrange_by_score(state->store->handle(), key, -INFINITY, INFINITY);
+  if (!result.is_ok()) {
+    JS_ReportErrorUTF8(cx, "Error in zrangeByScore for key: %s", key.c_str());
+    return nullptr;
+  }
+
+  auto list = result.unwrap();
+  size_t bytes = state->bytes;
+  std::vector<MirrorMember> members;
+  members.reserve(list.len);
+  for (size_t i = 0; i < list.len; i++) {
+    const host_api::KvStoreTuple &entry = list.ptr[i];
+    bytes += entry.f0.len + sizeof(double);
+    members.push_back({std::vector<uint8_t>(entry.f0.ptr, entry.f0.ptr + entry.f0.len), entry.f1});
+  }
+  if (bytes > MAX_MIRROR_BYTES) {
+    JS_ReportErrorUTF8(cx, "Error mirroring store %s: store exceeds %zu bytes",
+                       state->name.c_str(), MAX_MIRROR_BYTES);
+    return nullptr;
+  }
+
+  state->bytes = bytes;
+  return &state->zsets.emplace(key, std::move(members)).first->second;
+}
+
+class KvMirror {
+public:
+  enum class Slot : uint32_t {
+    State = 0,
+    Count
+  };
+
+  static const JSClass class_;
+  static const JSFunctionSpec methods[];
+
+  static bool get(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool get_text(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool get_json(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool scan(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool zrange_by_score(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool refresh(JSContext *cx, unsigned argc, JS::Value *vp);
+
+  static JSObject *create(JSContext *cx, MirrorState *state);
+};
+
+// No finalizer: the slot borrows a pointer owned by MIRRORS.
+const JSClass KvMirror::class_ = {
+    "KvMirror",
+    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(KvMirror::Slot::Count))
+};
+
+JSObject *KvMirror::create(JSContext *cx, MirrorState *state) {
+  JS::RootedObject proto(cx, *KV_MIRROR_PROTO);
+  JSObject *obj = JS_NewObjectWithGivenProto(cx, &KvMirror::class_, proto);
+  if (!obj) return nullptr;
+
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(Slot::State), JS::PrivateValue(state));
+  return obj;
+}
+
+// Queue a refresh of `state` as a promise job once it has gone stale, so
+// the lookup in progress is answered from the current copy and the reload
+// runs after the calling code yields.
+//
+// This is not a background refresh. The job runs synchronously on the
+// first request after the mirror goes stale, making one `scan` plus one
+// `get` per key back to back, and that request's response waits for it.
+bool schedule_refresh(JSContext *cx, JS::HandleObject mirror, MirrorState *state) {
+  if (state->refresh_pending || !state->stale()) {
+    return true;
+  }
+
+  JS::RootedObject ready(cx, JS::CallOriginalPromiseResolve(cx, JS::UndefinedHandleValue));
+  if (!ready) return false;
+  JS::RootedObject then_handler(cx, create_internal_method<KvStore::mirror_refresh_then>(cx, mirror));
+  if (!then_handler) return false;
+  if (!JS::AddPromiseReactions(cx, ready, then_handler, nullptr)) return false;
+
+  state->refresh_pending = true;
+  return true;
+}
+
+// Resolve `this` to its MirrorState and kick off a refresh if it is due.
+MirrorState *mirror_instance(JSContext *cx, const JS::CallArgs &args) {
+  if (!args.thisv().isObject() || JS::GetClass(&args.thisv().toObject()) != &KvMirror::class_) {
+    JS_ReportErrorUTF8(cx, "Invalid KvMirror instance");
+    return nullptr;
+  }
+  JS::RootedObject self(cx, &args.thisv().toObject());
+  auto *state = static_cast<MirrorState *>(
+      JS::GetReservedSlot(self, static_cast<uint32_t>(KvMirror::Slot::State)).toPrivate());
+  if (!schedule_refresh(cx, self, state)) return nullptr;
+  return state;
+}
+
+// Mirror entry for the key in `key_val`, or nullptr if absent.
+bool mirror_lookup(JSContext *cx, const MirrorState *state, JS::HandleValue key_val,
+                   const std::vector<uint8_t> **out) {
+  JS::RootedString key_str(cx, JS::ToString(cx, key_val));
+  if (!key_str) return false;
+  auto key = core::encode(cx, key_str);
+  if (!key) return false;
+
+  auto it = state->entries.find(std::string(key.ptr.get(), key.len));
+  *out = it == state->entries.end() ? nullptr : &it->second;
+  return true;
+}
+
+bool KvMirror::get(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "get", 1)) return false;
+
+  MirrorState *state = mirror_instance(cx, args);
+  if (!state) return false;
+
+  const std::vector<uint8_t> *value;
+  if (!mirror_lookup(cx, state, args[0], &value)) return false;
+  if (!value) {
+    args.rval().setNull();
+    return true;
+  }
+
+  JS::RootedObject byte_array(cx, JS_NewUint8Array(cx, value->size()));
+  if (!byte_array) return false;
+  if (!value->empty()) {
+    JS::AutoCheckCannotGC noGC(cx);
+    bool is_shared;
+    void *dst = JS_GetArrayBufferViewData(byte_array, &is_shared, noGC);
+    memcpy(dst, value->data(), value->size());
+  }
+
+  args.rval().setObject(*byte_array);
+  return true;
+}
+
+bool KvMirror::get_text(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "getText", 1)) return false;
+
+  MirrorState *state = mirror_instance(cx, args);
+  if (!state) return false;
+
+  const std::vector<uint8_t> *value;
+  if (!mirror_lookup(cx, state, args[0], &value)) return false;
+  if (!value) {
+    args.rval().setNull();
+    return true;
+  }
+
+  JSString *str = decode_value_string(cx, value->data(), value->size());
+  if (!str) return false;
+  args.rval().setString(str);
+  return true;
+}
+
+bool KvMirror::get_json(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "getJSON", 1)) return false;
+
+  MirrorState *state = mirror_instance(cx, args);
+  if (!state) return false;
+
+  const std::vector<uint8_t> *value;
+  if (!mirror_lookup(cx, state, args[0], &value)) return false;
+  if (!value) {
+    args.rval().setNull();
+    return true;
+  }
+
+  return parse_value_json(cx, value->data(), value->size(), args.rval());
+}
+
+bool KvMirror::scan(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "scan", 1)) return false;
+
+  MirrorState *state = mirror_instance(cx, args);
+  if (!state) return false;
+
+  JS::RootedString pattern_str(cx, JS::ToString(cx, args[0]));
+  if (!pattern_str) return false;
+  auto pattern_chars = core::encode(cx, pattern_str);
+  if (!pattern_chars) return false;
+  std::string_view pattern(pattern_chars.ptr.get(), pattern_chars.len);
+
+  // Only keys sharing the pattern's literal prefix can match, and the map
+  // keeps them contiguous.
+  std::string_view prefix = glob_prefix(pattern);
+  bool prefix_only = prefix.size() + 1 == pattern.size() && pattern.back() == '*';
+
+  JS::RootedObject keys_array(cx, JS::NewArrayObject(cx, 0));
+  if (!keys_array) return false;
+
+  JS::RootedString key_str(cx);
+  JS::RootedValue key_val(cx);
+  uint32_t n = 0;
+  for (auto it = state->entries.lower_bound(std::string(prefix)); it != state->entries.end(); ++it) {
+    std::string_view key = it->first;
+    if (key.substr(0, prefix.size()) != prefix) break;
+    if (!prefix_only && !glob_match(pattern, key)) continue;
+
+    key_str = JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(key.data(), key.size()));
+    if (!key_str) return false;
+    key_val.setString(key_str);
+    if (!JS_SetElement(cx, keys_array, n++, key_val)) return false;
+  }
+
+  args.rval().setObject(*keys_array);
+  return true;
+}
+
+bool KvMirror::zrange_by_score(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "zrangeByScore", 3)) return false;
+
+  MirrorState *state = mirror_instance(cx, args);
+  if (!state) return false;
+
+  JS::RootedString key_str(cx, JS::ToString(cx, args[0]));
+  if (!key_str) return false;
+  auto key = core::encode(cx, key_str);
+  if (!key) return false;
+
+  double min, max;
+  if (!JS::ToNumber(cx, args[1], &min) || !JS::ToNumber(cx, args[2], &max)) {
+    return false;
+  }
+
+  host_api::KvStoreZRangeOptions options;
+  if (!read_zrange_options(cx, args.get(3), "zrangeByScore", &options)) {
+    return false;
+  }
+
+  const std::vector<MirrorMember> *members =
+      mirror_zset(cx, state, std::string(key.ptr.get(), key.len));
+  if (!members) return false;
+
+  auto score_less = [](const MirrorMember &m, double s) { return m.score < s; };
+  auto score_leq = [](const MirrorMember &m, double s) { return m.score <= s; };
+  auto lo = options.min_exclusive
+      ? std::lower_bound(members->begin(), members->end(), min, score_leq)
+      : std::lower_bound(members->begin(), members->end(), min, score_less);
+  auto hi = options.max_exclusive
+      ? std::lower_bound(lo, members->end(), max, score_less)
+      : std::lower_bound(lo, members->end(), max, score_leq);
+
+  size_t in_range = hi > lo ? static_cast<size_t>(hi - lo) : 0;
+  size_t skip = std::min(options.offset, in_range);
+  size_t take = std::min(options.count.value_or(in_range), in_range - skip);
+
+  JS::RootedObject tuples_array(cx, JS::NewArrayObject(cx, take));
+  if (!tuples_array) return false;
+
+  JS::RootedObject byte_array(cx);
+  JS::RootedObject tuple(cx);
+  JS::RootedValue elem(cx);
+  for (size_t i = 0; i < take; i++) {
+    const MirrorMember &member = options.reverse ? *(hi - 1 - skip - i) : *(lo + skip + i);
+
+    byte_array = JS_NewUint8Array(cx, member.value.size());
+    if (!byte_array) return false;
+    if (!member.value.empty()) {
+      JS::AutoCheckCannotGC noGC(cx);
+      bool is_shared;
+      void *dst = JS_GetArrayBufferViewData(byte_array, &is_shared, noGC);
+      memcpy(dst, member.value.data(), member.value.size());
+    }
+
+    tuple = JS::NewArrayObject(cx, 2);
+    if (!tuple) return false;
+    elem.setObject(*byte_array);
+    if (!JS_SetElement(cx, tuple, 0, elem)) return false;
+    elem.setDouble(member.score);
+    if (!JS_SetElement(cx, tuple, 1, elem)) return false;
+
+    elem.setObject(*tuple);
+    if (!JS_SetElement(cx, tuples_array, static_cast<uint32_t>(i), elem)) return false;
+  }
+
+  args.rval().setObject(*tuples_array);
+  return true;
+}
+
+bool KvMirror::refresh(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.thisv().isObject() || JS::GetClass(&args.thisv().toObject()) != &KvMirror::class_) {
+    JS_ReportErrorUTF8(cx, "Invalid KvMirror instance");
+    return false;
+  }
+  auto *state = static_cast<MirrorState *>(
+      JS::GetReservedSlot(&args.thisv().toObject(), static_cast<uint32_t>(Slot::State)).toPrivate());
+
+  if (!mirror_load(cx, state)) return false;
+  args.rval().setUndefined();
+  return true;
+}
+
+const JSFunctionSpec KvMirror::methods[] = {
+    JS_FN("get", KvMirror::get, 1, JSPROP_ENUMERATE),
+    JS_FN("getText", KvMirror::get_text, 1, JSPROP_ENUMERATE),
+    JS_FN("getJSON", KvMirror::get_json, 1, JSPROP_ENUMERATE),
+    JS_FN("scan", KvMirror::scan, 1, JSPROP_ENUMERATE),
+    JS_FN("zrangeByScore", KvMirror::zrange_by_score, 3, JSPROP_ENUMERATE),
+    JS_FN("refresh", KvMirror::refresh, 0, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+bool read_mirror_refresh_ms(JSContext *cx, JS::HandleValue options_val, double *out) {
+  *out = DEFAULT_MIRROR_REFRESH_MS;
+  if (options_val.isNullOrUndefined()) return true;
+  if (!options_val.isObject()) {
+    JS_ReportErrorUTF8(cx, "KvStore.openMirrored: options must be an object");
+    return false;
+  }
+
+  JS::RootedObject options(cx, &options_val.toObject());
+  JS::RootedValue refresh_val(cx);
+  if (!JS_GetProperty(cx, options, "refreshMs", &refresh_val)) return false;
+  if (refresh_val.isUndefined()) return true;
+
+  double refresh_ms;
+  if (!JS::ToNumber(cx, refresh_val, &refresh_ms)) return false;
+  if (!std::isfinite(refresh_ms) || refresh_ms <= 0) {
+    JS_ReportErrorUTF8(cx, "KvStore.openMirrored: refreshMs must be a positive number");
+    return false;
+  }
+  *out = refresh_ms;
+  return true;
+}
+
+}  // anonymous namespace
+
+bool KvStore::open_mirrored(JSContext *cx, unsigned argc, JS::Value *vp) {
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    if (!args.requireAtLeast(cx, "KvStore.openMirrored", 1)) {
+        return false;
+    }
+
+    JS::RootedString store_name_str(cx, JS::ToString(cx, args[0]));
+    if (!store_name_str) {
+        return false;
+    }
+
+    auto store_name = core::encode(cx, store_name_str);
+    if (!store_name) {
+        return false;
+    }
+
+    double refresh_ms;
+    if (!read_mirror_refresh_ms(cx, args.get(1), &refresh_ms)) {
+        return false;
+    }
+    auto refresh_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(refresh_ms));
+
+    std::string name(store_name.ptr.get(), store_name.len);
+    auto &slot = MIRRORS[name];
+    if (!slot) {
+        KvStore* store_instance = open_handle(cx, name);
+        if (!store_instance) {
+            MIRRORS.erase(name);
+            return false;
+        }
+
+        auto state = std::make_unique<MirrorState>();
+        state->store = store_instance;
+        state->name = name;
+        state->refresh_interval = refresh_interval;
+        if (!mirror_load(cx, state.get())) {
+            MIRRORS.erase(name);
+            return false;
+        }
+        slot = std::move(state);
+    } else if (slot->store->closed() && !open_handle(cx, name)) {
+        // Reopen a store closed since the mirror was built so its
+        // refreshes can reach the host again.
+        return false;
+    }
+    slot->refresh_interval = refresh_interval;
+
+    JSObject *mirror = KvMirror::create(cx, slot.get());
+    if (!mirror) return false;
+
+    args.rval().setObject(*mirror);
+    return true;
+}
+
+bool KvStore::mirror_refresh_then(JSContext *cx, JS::HandleObject receiver,
+                                  JS::HandleValue extra, JS::CallArgs args) {
+    auto *state = static_cast<MirrorState *>(
+        JS::GetReservedSlot(receiver, static_cast<uint32_t>(KvMirror::Slot::State)).toPrivate());
+    state->refresh_pending = false;
+
+    // A failed refresh keeps serving the previous copy; the next stale
+    // lookup schedules another attempt.
+    if (!mirror_load(cx, state)) {
+        JS_ClearPendingException(cx);
+        state->loaded_at = std::chrono::steady_clock::now();
+    }
+
+    args.rval().setUndefined();
+    return true;
+}
+
+bool install(api::Engine *engine) {
+    ENGINE = engine;
+
+    // Shared prototype carrying the instance methods.
+    JS::RootedObject proto(engine->cx(), JS_NewPlainObject(engine->cx()));
+    if (!proto) {
+        return false;
+    }
+    if (!JS_DefineFunctions(engine->cx(), proto, KvStore::methods)) {
+        return false;
+    }
+    KV_STORE_PROTO = new JS::PersistentRooted<JSObject *>(engine->cx(), proto);
+
+    // Shared prototype for scanIter / zscanIter iterators.
+    JS::RootedObject iter_proto(engine->cx(), JS_NewPlainObject(engine->cx()));
+    if (!iter_proto) {
+        return false;
+    }
+    if (!JS_DefineFunctions(engine->cx(), iter_proto, KvScanIterator::methods)) {
+        return false;
+    }
+    KV_SCAN_ITERATOR_PROTO = new JS::PersistentRooted<JSObject *>(engine->cx(), iter_proto);
+
+    JS::RootedObject bloom_proto(engine->cx(), JS_NewPlainObject(engine->cx()));
+    if (!bloom_proto) {
+        return false;
+    }
+    if (!JS_DefineFunctions(engine->cx(), bloom_proto, KvBloomExistsCache::methods)) {
+        return false;
+    }
+    KV_BLOOM_EXISTS_CACHE_PROTO = new JS::PersistentRooted<JSObject *>(engine->cx(), bloom_proto);
+
+    JS::RootedObject mirror_proto(engine->cx(), JS_NewPlainObject(engine->cx()));
+    if (!mirror_proto) {
+        return false;
+    }
+    if (!JS_DefineFunctions(engine->cx(), mirror_proto, KvMirror::methods)) {
+        return false;
+    }
+    KV_MIRROR_PROTO = new JS::PersistentRooted<JSObject *>(engine->cx(), mirror_proto);
 
     // Create the KvStore constructor function
     JS::RootedObject kv_store_ctor(engine->cx(),
@@ -3,6 +3,10 @@
 #include "builtin.h"
 #include "../host-api/include/fastedge_host_api.h"
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 namespace fastedge::kv_store {
 
 class KvStore : public builtins::BuiltinNoConstructor<KvStore> {
@@ -10,27 +14,76 @@ public:
   static constexpr const char *class_name = "KvStore";
 
   static bool open(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool open_mirrored(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool get(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool get_entry(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool get_text(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool get_json(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool get_decoded(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool scan(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool scan_iter(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool zrange_by_score(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool zrange_by_score_entries(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool zrange_by_score_columnar(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool zscan(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool zscan_entries(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool zscan_iter(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool zscan_columnar(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool zmerge(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool geo_nearby(JSContext *cx, unsigned argc, JS::Value *vp);
   static bool bf_exists(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool bf_exists_many(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool bf_exists_cache(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool close(JSContext *cx, unsigned argc, JS::Value *vp);
 
-  static void finalize(JS::GCContext *gcx, JSObject *obj);
+  // Promise reaction that reloads a KvMirror once it has gone stale.
+  // Static (not in the anon namespace) so its address can be passed as a
+  // template argument to `create_internal_method<...>`. `receiver` is the
+  // KvMirror wrapper.
+  static bool mirror_refresh_then(JSContext *cx, JS::HandleObject receiver,
+                                  JS::HandleValue extra, JS::CallArgs args);
 
   static const JSClass class_;
   static const JSFunctionSpec static_methods[];
   static const JSFunctionSpec methods[];
 
+  // Drops the host `store` resource unless `close()` already has. Only
+  // the handle table destroys KvStore instances.
+  ~KvStore();
+
+  // Host handle of the store; only valid while `!closed()`.
+  int32_t handle() const { return store_handle_; }
+  bool closed() const { return closed_; }
+
 private:
   int32_t store_handle_;
+  bool closed_ = false;
 
   explicit KvStore(int32_t handle) : store_handle_(handle) {}
 
+  // Releases the host handle now. Every wrapper for the store name shares
+  // this instance, so all of them see the store as closed until the next
+  // `open(name)` reopens it. Idempotent.
+  void release();
+
+  // Process-wide table of stores, keyed by store name. The first
+  // successful `open(name)` is reused by every later call, so repeated
+  // opens make no host call. `close()` releases the host handle but keeps
+  // the entry, so wrappers' borrowed pointers stay valid and table size is
+  // bounded by the number of distinct store names; a later `open(name)`
+  // reopens the handle in place. Nothing is added while wizening.
+  static std::unordered_map<std::string, std::unique_ptr<KvStore>> open_stores_;
+
   static KvStore* get_instance(JSContext *cx, JSObject *obj);
+
+  // `get_instance`, reporting a JS error if `obj` isn't a KvStore wrapper
+  // or its store has been closed.
+  static KvStore* open_instance(JSContext *cx, JSObject *obj);
+
+  // Look `name` up in `open_stores_`, opening (or reopening) it on the host
+  // when there is no open handle. Reports a JS error and returns nullptr if
+  // the host refuses, or if called while wizening.
+  static KvStore* open_handle(JSContext *cx, std::string name);
 };
 
 } // namespace fastedge::kv_store
@@ -0,0 +1,479 @@
+#include "builtin.h"
+#include "encode.h"
+
+#include <js/Array.h>
+#include <js/ArrayBuffer.h>
+
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fastedge::pattern_set {
+
+namespace {
+
+// Largest transition table a set may compile to (states × byte classes).
+// 4M entries is 16 MB, far beyond a few hundred WAF rules.
+constexpr size_t MAX_TRANSITIONS = 4 * 1024 * 1024;
+
+constexpr uint32_t NO_STATE = UINT32_MAX;
+
+uint8_t fold_ascii(uint8_t b) { return (b >= 'A' && b <= 'Z') ? b - 'A' + 'a' : b; }
+
+// Aho-Corasick automaton compiled to a full DFA over byte classes.
+//
+// Bytes that occur in no pattern share class 0, so the transition table is
+// states × (distinct pattern bytes + 1) rather than states × 256. Every
+// state has a transition for every class, so scanning is one table lookup
+// per input byte with no failure-link walking. Everything lives in flat
+// vectors in linear memory; a set compiled at module scope is part of the
+// wizer snapshot.
+class Automaton {
+public:
+  bool build(const std::vector<std::string> &patterns, bool case_insensitive) {
+    uint8_t used[256] = {0};
+    for (const auto &p : patterns) {
+      for (unsigned char b : p) used[case_insensitive ? fold_ascii(b) : b] = 1;
+    }
+    classes_ = 1;
+    uint16_t class_of_byte[256] = {0};
+    for (size_t b = 0; b < 256; b++) {
+      if (used[b]) class_of_byte[b] = static_cast<uint16_t>(classes_++);
+    }
+    for (size_t b = 0; b < 256; b++) {
+      uint8_t byte = static_cast<uint8_t>(b);
+      byte_class_[b] = class_of_byte[case_insensitive ? fold_ascii(byte) : byte];
+    }
+
+    // Trie.
+    std::vector<std::vector<uint32_t>> own(1);
+    delta_.assign(classes_, NO_STATE);
+    for (uint32_t rule = 0; rule < patterns.size(); rule++) {
+      uint32_t state = 0;
+      for (unsigned char b : patterns[rule]) {
+        size_t slot = state * classes_ + byte_class_[b];
+        if (delta_[slot] == NO_STATE) {
+          if (delta_.size() + classes_ > MAX_TRANSITIONS) return false;
+          uint32_t next = static_cast<uint32_t>(own.size());
+          own.emplace_back();
+          delta_.resize(delta_.size() + classes_, NO_STATE);
+          delta_[slot] = next;
+        }
+        state = delta_[slot];
+      }
+      own[state].push_back(rule);
+    }
+
+    // Failure links in BFS order, folded into the transition table so
+    // every state has a complete row.
+    size_t states = own.size();
+    std::vector<uint32_t> fail(states, 0);
+    dict_link_.assign(states, NO_STATE);
+    std::deque<uint32_t> queue;
+    for (size_t c = 0; c < classes_; c++) {
+      uint32_t &next = delta_[c];
+      if (next == NO_STATE) {
+        next = 0;
+      } else {
+        queue.push_back(next);
+      }
+    }
+    while (!queue.empty()) {
+      uint32_t s = queue.front();
+      queue.pop_front();
+      for (size_t c = 0; c < classes_; c++) {
+        uint32_t &next = delta_[s * classes_ + c];
+        uint32_t via_fail = delta_[fail[s] * classes_ + c];
+        if (next == NO_STATE) {
+          next = via_fail;
+          continue;
+        }
+        fail[next] = via_fail;
+        dict_link_[next] = own[via_fail].empty() ? dict_link_[via_fail] : via_fail;
+        queue.push_back(next);
+      }
+    }
+
+    // Flatten per-state rule lists.
+    out_begin_.resize(states + 1);
+    for (size_t s = 0; s < states; s++) {
+      out_begin_[s] = static_cast<uint32_t>(out_rules_.size());
+      out_rules_.insert(out_rules_.end(), own[s].begin(), own[s].end());
+    }
+    out_begin_[states] = static_cast<uint32_t>(out_rules_.size());
+    has_output_.resize(states);
+    for (size_t s = 0; s < states; s++) {
+      has_output_[s] = out_begin_[s] != out_begin_[s + 1] || dict_link_[s] != NO_STATE;
+    }
+
+    for (size_t b = 0; b < 256; b++) starts_[b] = delta_[byte_class_[b]] != 0;
+    return true;
+  }
+
+  // Scan `input`, calling `on_match(rule)` for every pattern occurrence
+  // until it returns false.
+  template <typename OnMatch> void scan(const uint8_t *input, size_t len, OnMatch on_match) const {
+    uint32_t state = 0;
+    size_t i = 0;
+    while (i < len) {
+      // Prefilter: at the root, skip bytes that can't start any pattern.
+      if (state == 0) {
+        while (i < len && !starts_[input[i]]) i++;
+        if (i == len) return;
+      }
+      state = delta_[state * classes_ + byte_class_[input[i++]]];
+      if (!has_output_[state]) continue;
+
+      for (uint32_t s = state; s != NO_STATE; s = dict_link_[s]) {
+        for (uint32_t k = out_begin_[s]; k < out_begin_[s + 1]; k++) {
+          if (!on_match(out_rules_[k])) return;
+        }
+      }
+    }
+  }
+
+private:
+  size_t classes_ = 0;
+  uint16_t byte_class_[256] = {0};
+  bool starts_[256] = {false};
+  std::vector<uint32_t> delta_;
+  std::vector<uint32_t> dict_link_;  // Nearest suffix state with its own rules.
+  std::vector<uint32_t> out_begin_;
+  std::vector<uint32_t> out_rules_;
+  std::vector<bool> has_output_;
+};
+
+struct PatternTable {
+  Automaton automaton;
+  size_t rules = 0;
+};
+
+// Bytes of a scan input: a string (as UTF-8, like the patterns) or the
+// contents of an ArrayBuffer / ArrayBufferView, copied out so no GC can
+// move them mid-scan.
+bool read_input(JSContext *cx, JS::HandleValue value, const char *fn_name,
+                std::string *out) {
+  if (value.isString()) {
+    auto text = core::encode(cx, value);
+    if (!text) return false;
+    out->assign(text.ptr.get(), text.len);
+    return true;
+  }
+
+  if (value.isObject()) {
+    JS::RootedObject obj(cx, &value.toObject());
+    JS::AutoCheckCannotGC noGC(cx);
+    bool is_shared;
+    if (JS::IsArrayBufferObject(obj)) {
+      size_t len = JS::GetArrayBufferByteLength(obj);
+      if (len > 0) {
+        out->assign(static_cast<const char *>(JS::GetArrayBufferData(obj, &is_shared, noGC)), len);
+      }
+      return true;
+    }
+    if (JS_IsArrayBufferViewObject(obj)) {
+      size_t len = JS_GetArrayBufferViewByteLength(obj);
+      if (len > 0) {
+        out->assign(static_cast<const char *>(JS_GetArrayBufferViewData(obj, &is_shared, noGC)),
+                    len);
+      }
+      return true;
+    }
+  }
+
+  JS_ReportErrorUTF8(cx, "%s: input must be a string, an ArrayBuffer or an ArrayBufferView",
+                     fn_name);
+  return false;
+}
+
+// The first regular-expression construct in `pattern`, or an empty view if
+// there is none. Patterns are matched as literal text, so a rule written as
+// a regex would silently never match; these constructs almost never occur
+// literally in the URLs, headers and bodies PatternSet screens.
+std::string_view regex_syntax(std::string_view pattern) {
+  if (pattern.size() > 1 && pattern.front() == '^') return pattern.substr(0, 1);
+  if (pattern.size() > 1 && pattern.back() == '$') return pattern.substr(pattern.size() - 1);
+  auto quantifier = [](char c) { return c == '*' || c == '+' || c == '?' || c == '{'; };
+  for (size_t i = 0; i + 1 < pattern.size(); i++) {
+    char c = pattern[i];
+    char next = pattern[i + 1];
+    if ((c == '.' && quantifier(next)) || (c == '(' && next == '?')) {
+      return pattern.substr(i, 2);
+    }
+    // Only a quantified class escape such as `\d+`: a bare `\W` is more
+    // likely part of a Windows path.
+    if (c == '\\' && next != '\0' && std::strchr("dDwWsS", next) &&
+        i + 2 < pattern.size() && quantifier(pattern[i + 2])) {
+      return pattern.substr(i, 3);
+    }
+  }
+  return {};
+}
+
+// Read the rule list: an array whose items are pattern strings (the rule ID
+// is the index) or `{ id, pattern }` objects. Fills `patterns` and the JS
+// array `ids` with each rule's ID. Unless `allow_regex_syntax` is set,
+// rejects patterns that look like regular expressions.
+bool read_rules(JSContext *cx, JS::HandleValue rules_val, bool allow_regex_syntax,
+                std::vector<std::string> *patterns, JS::HandleObject ids) {
+  bool is_array = false;
+  if (!JS::IsArrayObject(cx, rules_val, &is_array)) return false;
+  if (!is_array) {
+    JS_ReportErrorUTF8(cx, "PatternSet.compile: rules must be an array");
+    return false;
+  }
+
+  JS::RootedObject rules(cx, &rules_val.toObject());
+  uint32_t len;
+  if (!JS::GetArrayLength(cx, rules, &len)) return false;
+
+  JS::RootedValue rule(cx);
+  JS::RootedValue id(cx);
+  JS::RootedValue pattern(cx);
+  for (uint32_t i = 0; i < len; i++) {
+    if (!JS_GetElement(cx, rules, i, &rule)) return false;
+
+    if (rule.isString()) {
+      pattern = rule;
+      id.setNumber(i);
+    } else if (rule.isObject()) {
+      JS::RootedObject rule_obj(cx, &rule.toObject());
+      if (!JS_GetProperty(cx, rule_obj, "id", &id) ||
+          !JS_GetProperty(cx, rule_obj, "pattern", &pattern)) {
+        return false;
+      }
+      if (id.isUndefined()) id.setNumber(i);
+    } else {
+      pattern.setUndefined();
+    }
+
+    if (!pattern.isString()) {
+      JS_ReportErrorUTF8(cx, "PatternSet.compile: rule %u must be a string or "
+                             "{ id, pattern } with a string pattern", i);
+      return false;
+    }
+    auto text = core::encode(cx, pattern);
+    if (!text) return false;
+    if (text.len == 0) {
+      JS_ReportErrorUTF8(cx, "PatternSet.compile: rule %u has an empty pattern", i);
+      return false;
+    }
+    std::string_view syntax;
+    if (!allow_regex_syntax) syntax = regex_syntax({text.ptr.get(), text.len});
+    if (!syntax.empty()) {
+      JS_ReportErrorUTF8(cx, "PatternSet.compile: rule %u uses regular-expression syntax (%.*s), "
+                             "but patterns are literal text. Pass { allowRegexSyntax: true } "
+                             "to match it literally", i, static_cast<int>(syntax.size()),
+                         syntax.data());
+      return false;
+    }
+    patterns->emplace_back(text.ptr.get(), text.len);
+    if (!JS_DefineElement(cx, ids, i, id, JSPROP_ENUMERATE)) return false;
+  }
+  return true;
+}
+
+JS::PersistentRooted<JSObject *> *PATTERN_SET_PROTO = nullptr;
+
+// `PatternSet` instance. Owns its PatternTable (freed by the finalizer) and
+// keeps the rule IDs in a JS array slot so they're traced.
+class PatternSetObject {
+public:
+  enum class Slot : uint32_t {
+    Table,  // PrivateValue(PatternTable*)
+    Ids,    // Array of rule IDs, indexed by rule.
+    Count
+  };
+
+  static const JSClass class_;
+  static const JSFunctionSpec methods[];
+  static const JSPropertySpec properties[];
+
+  static bool compile(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool scan(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool test(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool size_get(JSContext *cx, unsigned argc, JS::Value *vp);
+
+  static void finalize(JS::GCContext *gcx, JSObject *obj);
+};
+
+static const JSClassOps pattern_set_class_ops = {
+    .finalize = PatternSetObject::finalize,
+};
+
+const JSClass PatternSetObject::class_ = {
+    "PatternSet",
+    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(PatternSetObject::Slot::Count)) |
+        JSCLASS_FOREGROUND_FINALIZE,
+    &pattern_set_class_ops
+};
+
+const JSFunctionSpec PatternSetObject::methods[] = {
+    JS_FN("scan", PatternSetObject::scan, 1, JSPROP_ENUMERATE),
+    JS_FN("test", PatternSetObject::test, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+const JSPropertySpec PatternSetObject::properties[] = {
+    JS_PSG("size", PatternSetObject::size_get, JSPROP_ENUMERATE),
+    JS_PS_END,
+};
+
+PatternTable *pattern_table(JSObject *obj) {
+  if (!obj || JS::GetClass(obj) != &PatternSetObject::class_) return nullptr;
+  JS::Value v = JS::GetReservedSlot(obj, static_cast<uint32_t>(PatternSetObject::Slot::Table));
+  if (v.isUndefined()) return nullptr;
+  return static_cast<PatternTable *>(v.toPrivate());
+}
+
+PatternTable *this_table(JSContext *cx, JS::CallArgs &args, const char *fn_name) {
+  PatternTable *table =
+      args.thisv().isObject() ? pattern_table(&args.thisv().toObject()) : nullptr;
+  if (!table) JS_ReportErrorUTF8(cx, "%s: receiver must be a PatternSet", fn_name);
+  return table;
+}
+
+void PatternSetObject::finalize(JS::GCContext *gcx, JSObject *obj) {
+  delete pattern_table(obj);
+}
+
+bool PatternSetObject::compile(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "PatternSet.compile", 1)) return false;
+
+  bool case_insensitive = false;
+  bool allow_regex_syntax = false;
+  if (args.get(1).isObject()) {
+    JS::RootedObject opts(cx, &args[1].toObject());
+    JS::RootedValue val(cx);
+    if (!JS_GetProperty(cx, opts, "caseInsensitive", &val)) return false;
+    case_insensitive = JS::ToBoolean(val);
+    if (!JS_GetProperty(cx, opts, "allowRegexSyntax", &val)) return false;
+    allow_regex_syntax = JS::ToBoolean(val);
+  } else if (!args.get(1).isUndefined()) {
+    JS_ReportErrorUTF8(cx, "PatternSet.compile: options must be an object");
+    return false;
+  }
+
+  std::vector<std::string> patterns;
+  JS::RootedObject ids(cx, JS::NewArrayObject(cx, 0));
+  if (!ids) return false;
+  if (!read_rules(cx, args[0], allow_regex_syntax, &patterns, ids)) return false;
+
+  auto table = std::make_unique<PatternTable>();
+  table->rules = patterns.size();
+  if (!table->automaton.build(patterns, case_insensitive)) {
+    JS_ReportErrorUTF8(cx, "PatternSet.compile: rules are too large to compile");
+    return false;
+  }
+
+  JS::RootedObject proto(cx, *PATTERN_SET_PROTO);
+  JS::RootedObject obj(cx, JS_NewObjectWithGivenProto(cx, &PatternSetObject::class_, proto));
+  if (!obj) return false;
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(Slot::Table),
+                      JS::PrivateValue(table.release()));
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(Slot::Ids), JS::ObjectValue(*ids));
+
+  args.rval().setObject(*obj);
+  return true;
+}
+
+bool PatternSetObject::scan(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  PatternTable *table = this_table(cx, args, "PatternSet.scan");
+  if (!table) return false;
+  if (!args.requireAtLeast(cx, "PatternSet.scan", 1)) return false;
+
+  std::string input;
+  if (!read_input(cx, args[0], "PatternSet.scan", &input)) return false;
+
+  std::vector<bool> matched(table->rules, false);
+  size_t remaining = table->rules;
+  table->automaton.scan(reinterpret_cast<const uint8_t *>(input.data()), input.size(),
+                        [&](uint32_t rule) {
+                          if (!matched[rule]) {
+                            matched[rule] = true;
+                            remaining--;
+                          }
+                          return remaining > 0;
+                        });
+
+  JS::RootedObject self(cx, &args.thisv().toObject());
+  JS::RootedObject ids(cx, &JS::GetReservedSlot(self, static_cast<uint32_t>(Slot::Ids)).toObject());
+  JS::RootedObject result(cx, JS::NewArrayObject(cx, 0));
+  if (!result) return false;
+
+  JS::RootedValue id(cx);
+  uint32_t n = 0;
+  for (uint32_t rule = 0; rule < table->rules; rule++) {
+    if (!matched[rule]) continue;
+    if (!JS_GetElement(cx, ids, rule, &id) ||
+        !JS_DefineElement(cx, result, n++, id, JSPROP_ENUMERATE)) {
+      return false;
+    }
+  }
+
+  args.rval().setObject(*result);
+  return true;
+}
+
+bool PatternSetObject::test(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  PatternTable *table = this_table(cx, args, "PatternSet.test");
+  if (!table) return false;
+  if (!args.requireAtLeast(cx, "PatternSet.test", 1)) return false;
+
+  std::string input;
+  if (!read_input(cx, args[0], "PatternSet.test", &input)) return false;
+
+  bool found = false;
+  table->automaton.scan(reinterpret_cast<const uint8_t *>(input.data()), input.size(),
+                        [&](uint32_t) {
+                          found = true;
+                          return false;
+                        });
+  args.rval().setBoolean(found);
+  return true;
+}
+
+bool PatternSetObject::size_get(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  PatternTable *table = this_table(cx, args, "PatternSet.size");
+  if (!table) return false;
+  args.rval().setNumber(static_cast<double>(table->rules));
+  return true;
+}
+
+const JSFunctionSpec pattern_set_static_methods[] = {
+    JS_FN("compile", PatternSetObject::compile, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+}  // namespace
+
+bool install(api::Engine *engine) {
+  JSContext *cx = engine->cx();
+
+  JS::RootedObject proto(cx, JS_NewPlainObject(cx));
+  if (!proto) return false;
+  if (!JS_DefineFunctions(cx, proto, PatternSetObject::methods) ||
+      !JS_DefineProperties(cx, proto, PatternSetObject::properties)) {
+    return false;
+  }
+  PATTERN_SET_PROTO = new JS::PersistentRooted<JSObject *>(cx, proto);
+
+  JS::RootedObject pattern_set_obj(cx, JS_NewPlainObject(cx));
+  if (!pattern_set_obj) return false;
+  if (!JS_DefineFunctions(cx, pattern_set_obj, pattern_set_static_methods)) return false;
+
+  if (!JS_DefineProperty(cx, engine->global(), "PatternSet", pattern_set_obj, 0)) {
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace fastedge::pattern_set
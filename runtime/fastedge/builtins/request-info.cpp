@@ -1,4 +1,5 @@
 #include "request-info.h"
+#include "cidr-set.h"
 
 #include "builtin.h"
 
@@ -6,13 +7,20 @@
 #include "../../StarlingMonkey/builtins/web/fetch/headers.h"
 #include "../../StarlingMonkey/builtins/web/fetch/request-response.h"
 
+#include <js/CharacterEncoding.h>
+#include <js/String.h>
+
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <unordered_map>
 
 namespace fastedge::request_info {
 
@@ -22,74 +30,447 @@ using builtins::web::fetch::RequestOrResponse;
 
 namespace {
 
-// Read a single header value off the FetchEvent's incoming Request.
-// Returns "" if the header isn't present.
-std::string read_header(JSContext *cx, JS::HandleObject fetch_event,
-                        std::string_view name) {
+// Incoming headers that feed event.client / event.server / geo / pop.
+// Order matches INFO_HEADER_NAMES.
+enum class InfoHeader : uint8_t {
+  RealIp,
+  ForwardedFor,
+  Ja3,
+  ForwardedProto,
+  GeoAsn,
+  GeoLat,
+  GeoLong,
+  GeoReg,
+  GeoContinent,
+  GeoCountryCode,
+  GeoCountryName,
+  GeoCity,
+  ServerAddr,
+  ServerName,
+  PopLat,
+  PopLong,
+  PopReg,
+  PopContinent,
+  PopCountryCode,
+  PopCountryName,
+  PopCity,
+  Cookie,
+  Count,
+};
+
+constexpr size_t INFO_HEADER_COUNT = static_cast<size_t>(InfoHeader::Count);
+
+constexpr std::string_view INFO_HEADER_NAMES[INFO_HEADER_COUNT] = {
+    "x-real-ip",        "x-forwarded-for",    "x-ja3",
+    "x-forwarded-proto", "geoip-asn",         "geoip-lat",
+    "geoip-long",       "geoip-reg",          "geoip-continent",
+    "geoip-country-code", "geoip-country-name", "geoip-city",
+    "server_addr",      "server_name",        "pop-lat",
+    "pop-long",         "pop-reg",            "pop-continent",
+    "pop-country-code", "pop-country-name",   "pop-city",
+    "cookie",
+};
+
+// Perfect hash over INFO_HEADER_NAMES: seeded FNV-1a of the lower-cased
+// name, reduced modulo INFO_HASH_SIZE. The seed was chosen so no two names
+// share a bucket; the static_assert below keeps it that way if the list
+// changes.
+constexpr uint32_t INFO_HASH_SEED = 15;
+constexpr size_t INFO_HASH_SIZE = 128;
+
+constexpr char ascii_lower(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+constexpr size_t info_hash(std::string_view name) {
+  uint32_t h = 2166136261u ^ INFO_HASH_SEED;
+  for (char c : name) {
+    h ^= static_cast<uint8_t>(ascii_lower(c));
+    h *= 16777619u;
+  }
+  return h % INFO_HASH_SIZE;
+}
+
+struct InfoHashTable {
+  InfoHeader buckets[INFO_HASH_SIZE];
+  bool perfect;
+};
+
+constexpr InfoHashTable build_info_hash_table() {
+  InfoHashTable table{};
+  for (auto &bucket : table.buckets) bucket = InfoHeader::Count;
+  table.perfect = true;
+  for (size_t i = 0; i < INFO_HEADER_COUNT; i++) {
+    size_t slot = info_hash(INFO_HEADER_NAMES[i]);
+    if (table.buckets[slot] != InfoHeader::Count) table.perfect = false;
+    table.buckets[slot] = static_cast<InfoHeader>(i);
+  }
+  return table;
+}
+
+constexpr InfoHashTable INFO_HASH_TABLE = build_info_hash_table();
+static_assert(INFO_HASH_TABLE.perfect,
+              "request-info header names collide; pick a new INFO_HASH_SEED");
+
+bool equals_ignore_case(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (ascii_lower(a[i]) != b[i]) return false;
+  }
+  return true;
+}
+
+// Values of every InfoHeader for one FetchEvent, captured in a single pass
+// over the incoming header list. Values are packed into `buf`, each one
+// NUL-terminated so numeric fields can be parsed in place. Cookie headers
+// may be repeated (HTTP/2 sends one per cookie), so they are joined into
+// `cookies` instead.
+struct InfoHeaderSnapshot {
+  std::string buf;
+  std::string cookies;
+  uint32_t offset[INFO_HEADER_COUNT];
+  uint32_t len[INFO_HEADER_COUNT];
+  bool present[INFO_HEADER_COUNT];
+
+  // "" if the header isn't present.
+  std::string_view get(InfoHeader h) const {
+    size_t i = static_cast<size_t>(h);
+    if (!present[i]) return {};
+    return std::string_view(buf.data() + offset[i], len[i]);
+  }
+
+  // The first non-empty value among `headers`, in order.
+  std::string_view first_of(std::initializer_list<InfoHeader> headers) const {
+    for (auto h : headers) {
+      auto val = get(h);
+      if (!val.empty()) return val;
+    }
+    return {};
+  }
+};
+
+// Info objects and header snapshot for one FetchEvent. Held as the value
+// of that event's entry in EVENT_INFO, a WeakMap keyed by the event, so it
+// lives exactly as long as the event: each event keeps its own `client` /
+// `server` / `cookies` identity however requests interleave, and a
+// finished event isn't kept alive by the cache. Keeping them here rather
+// than as data properties on the event leaves the FetchEvent's shape
+// untouched.
+class EventInfo {
+public:
+  enum class Slot : uint32_t {
+    Client,   // ClientInfo, or undefined until first accessed.
+    Server,   // ServerInfo, or undefined until first accessed.
+    Cookies,  // CookieJar, or undefined until first accessed.
+    Headers,  // PrivateValue(InfoHeaderSnapshot*), owned and freed by finalize.
+    Count
+  };
+
+  static const JSClass class_;
+
+  static void finalize(JS::GCContext *gcx, JSObject *obj) {
+    JS::Value headers = JS::GetReservedSlot(obj, static_cast<uint32_t>(Slot::Headers));
+    if (!headers.isUndefined()) delete static_cast<InfoHeaderSnapshot *>(headers.toPrivate());
+  }
+};
+
+static const JSClassOps event_info_class_ops = {
+    .finalize = EventInfo::finalize,
+};
+
+const JSClass EventInfo::class_ = {
+    "EventInfo",
+    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(EventInfo::Slot::Count)) |
+        JSCLASS_FOREGROUND_FINALIZE,
+    &event_info_class_ops
+};
+
+// WeakMap from FetchEvent to its EventInfo holder. Created in `install()`.
+JS::PersistentRooted<JSObject *> *EVENT_INFO = nullptr;
+
+void capture_info_headers(JSContext *cx, JS::HandleObject fetch_event,
+                          InfoHeaderSnapshot *out) {
+  out->buf.clear();
+  out->cookies.clear();
+  std::fill(std::begin(out->present), std::end(out->present), false);
+
   JS::Value request_val = JS::GetReservedSlot(
       fetch_event, static_cast<uint32_t>(FetchEvent::Slots::Request));
-  if (!request_val.isObject()) return "";
+  if (!request_val.isObject()) return;
   JS::RootedObject request(cx, &request_val.toObject());
   JS::RootedObject headers(cx, RequestOrResponse::headers(cx, request));
-  if (!headers) return "";
-  auto idx = Headers::lookup(cx, headers, name);
-  if (!idx.has_value()) return "";
-  auto entry = Headers::get_index(cx, headers, *idx);
-  if (!entry) return "";
-  const auto &value = std::get<1>(*entry);
-  return std::string(value.ptr.get(), value.len);
-}
-
-// Try several header names in order; return the first non-empty value.
-// Used for client.address: x-real-ip is the trusted source, x-forwarded-for
-// is the fallback when the platform omits x-real-ip on a given pathway.
-std::string read_header_fallback(JSContext *cx, JS::HandleObject fetch_event,
-                                 std::initializer_list<std::string_view> names) {
-  for (auto name : names) {
-    auto val = read_header(cx, fetch_event, name);
-    if (!val.empty()) return val;
-  }
-  return "";
-}
-
-// Define a read-only string data property on `obj`.
-bool define_str(JSContext *cx, JS::HandleObject obj, const char *name,
-                std::string_view value) {
-  JS::RootedString js_str(cx, JS_NewStringCopyN(cx, value.data(), value.length()));
-  if (!js_str) return false;
-  JS::RootedValue val(cx, JS::StringValue(js_str));
-  return JS_DefineProperty(cx, obj, name, val,
-                           JSPROP_READONLY | JSPROP_PERMANENT | JSPROP_ENUMERATE);
-}
-
-// Define a `number | null` data property on `obj`.
+  if (!headers) return;
+  auto *list = Headers::get_list(cx, headers);
+  if (!list) return;
+
+  for (const auto &entry : *list) {
+    const auto &name = std::get<0>(entry);
+    std::string_view name_view(name.ptr.get(), name.len);
+    InfoHeader h = INFO_HASH_TABLE.buckets[info_hash(name_view)];
+    if (h == InfoHeader::Count) continue;
+
+    size_t i = static_cast<size_t>(h);
+    if (!equals_ignore_case(name_view, INFO_HEADER_NAMES[i])) continue;
+
+    const auto &value = std::get<1>(entry);
+    if (h == InfoHeader::Cookie) {
+      if (!out->cookies.empty()) out->cookies.append("; ");
+      out->cookies.append(value.ptr.get(), value.len);
+      continue;
+    }
+    if (out->present[i]) continue;
+
+    out->offset[i] = static_cast<uint32_t>(out->buf.size());
+    out->len[i] = static_cast<uint32_t>(value.len);
+    out->present[i] = true;
+    out->buf.append(value.ptr.get(), value.len);
+    out->buf.push_back('\0');
+  }
+}
+
+// EventInfo holder for `fetch_event`, created with its headers captured on
+// first use. Returns nullptr with a pending exception on failure.
+JSObject *event_info(JSContext *cx, JS::HandleObject fetch_event) {
+  JS::RootedObject map(cx, *EVENT_INFO);
+  JS::RootedValue key(cx, JS::ObjectValue(*fetch_event));
+  JS::RootedValue entry(cx);
+  if (!JS::GetWeakMapEntry(cx, map, key, &entry)) return nullptr;
+  if (entry.isObject()) return &entry.toObject();
+
+  JS::RootedObject info(cx, JS_NewObject(cx, &EventInfo::class_));
+  if (!info) return nullptr;
+  auto *headers = new InfoHeaderSnapshot();
+  JS::SetReservedSlot(info, static_cast<uint32_t>(EventInfo::Slot::Headers),
+                      JS::PrivateValue(headers));
+  capture_info_headers(cx, fetch_event, headers);
+
+  entry.setObject(*info);
+  if (!JS::SetWeakMapEntry(cx, map, key, entry)) return nullptr;
+  return info;
+}
+
+// Header snapshot for `fetch_event`. It stays valid while the event is
+// alive, since the event's WeakMap entry keeps its holder alive.
+const InfoHeaderSnapshot *event_headers(JSContext *cx, JS::HandleObject fetch_event) {
+  JSObject *info = event_info(cx, fetch_event);
+  if (!info) return nullptr;
+  return static_cast<InfoHeaderSnapshot *>(
+      JS::GetReservedSlot(info, static_cast<uint32_t>(EventInfo::Slot::Headers)).toPrivate());
+}
+
+// Store a fresh JS string holding `value` in `slot` of `obj`.
+template <typename Slot>
+bool store_str(JSContext *cx, JS::HandleObject obj, Slot slot, std::string_view value) {
+  JSString *str = JS_NewStringCopyN(cx, value.data(), value.length());
+  if (!str) return false;
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(slot), JS::StringValue(str));
+  return true;
+}
+
+// Values of the low-cardinality fields (protocol, country / continent codes,
+// regions, PoP location) repeat on nearly every request. They are interned:
+// the first occurrence is atomized and pinned, and later requests reuse the
+// same JSString instead of allocating a new one. Atoms also compare by
+// pointer inside SpiderMonkey.
+//
+// Pinned atoms live for the whole instance, so the table is capped; past
+// the cap values fall back to ordinary per-request strings. That keeps a
+// stream of unexpected header values from growing the atoms zone without
+// bound.
+constexpr size_t MAX_INTERNED_STRINGS = 2048;
+
+std::unordered_map<std::string, std::unique_ptr<JS::PersistentRooted<JSString *>>>
+    INTERNED_STRINGS;
+
+// ISO 3166-1 alpha-2 country codes, two characters each.
+constexpr std::string_view ISO_COUNTRY_CODES =
+    "ADAEAFAGAIALAMAOAQARASATAUAWAXAZ"
+    "BABBBDBEBFBGBHBIBJBLBMBNBOBQBRBS"
+    "BTBVBWBYBZCACCCDCFCGCHCICKCLCMCN"
+    "COCRCUCVCWCXCYCZDEDJDKDMDODZECEE"
+    "EGEHERESETFIFJFKFMFOFRGAGBGDGEGF"
+    "GGGHGIGLGMGNGPGQGRGSGTGUGWGYHKHM"
+    "HNHRHTHUIDIEILIMINIOIQIRISITJEJM"
+    "JOJPKEKGKHKIKMKNKPKRKWKYKZLALBLC"
+    "LILKLRLSLTLULVLYMAMCMDMEMFMGMHMK"
+    "MLMMMNMOMPMQMRMSMTMUMVMWMXMYMZNA"
+    "NCNENFNGNINLNONPNRNUNZOMPAPEPFPG"
+    "PHPKPLPMPNPRPSPTPWPYQARERORSRURW"
+    "SASBSCSDSESGSHSISJSKSLSMSNSOSRSS"
+    "STSVSXSYSZTCTDTFTGTHTJTKTLTMTNTO"
+    "TRTTTVTWTZUAUGUMUSUYUZVAVCVEVGVI"
+    "VNVUWFWSYEYTZAZMZW";
+
+constexpr std::string_view SEED_STRINGS[] = {
+    // Continent codes and names.
+    "AF", "AN", "AS", "EU", "NA", "OC", "SA",
+    "Africa", "Antarctica", "Asia", "Europe", "North America", "Oceania",
+    "South America",
+    // x-forwarded-proto.
+    "http", "https",
+};
+
+// The interned JSString for `value`, creating and pinning it on first use.
+// Returns a fresh, unshared string once the table is full.
+JSString *intern_string(JSContext *cx, std::string_view value) {
+  auto it = INTERNED_STRINGS.find(std::string(value));
+  if (it != INTERNED_STRINGS.end()) return it->second->get();
+
+  if (INTERNED_STRINGS.size() >= MAX_INTERNED_STRINGS) {
+    return JS_NewStringCopyN(cx, value.data(), value.length());
+  }
+
+  JSString *atom = JS_AtomizeAndPinStringN(cx, value.data(), value.length());
+  if (!atom) return nullptr;
+  INTERNED_STRINGS.emplace(std::string(value),
+                           std::make_unique<JS::PersistentRooted<JSString *>>(cx, atom));
+  return atom;
+}
+
+// Intern the ISO country codes and the other well-known values up front.
+// install() runs before the wizer snapshot is taken, so the atoms are part
+// of the snapshot and no request pays for creating them.
+bool seed_interned_strings(JSContext *cx) {
+  for (size_t i = 0; i + 2 <= ISO_COUNTRY_CODES.size(); i += 2) {
+    if (!intern_string(cx, ISO_COUNTRY_CODES.substr(i, 2))) return false;
+  }
+  for (auto value : SEED_STRINGS) {
+    if (!intern_string(cx, value)) return false;
+  }
+  return true;
+}
+
+// Like store_str, but for low-cardinality values: the slot holds the
+// interned string for `value`.
+template <typename Slot>
+bool store_interned_str(JSContext *cx, JS::HandleObject obj, Slot slot,
+                        std::string_view value) {
+  JSString *str = intern_string(cx, value);
+  if (!str) return false;
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(slot), JS::StringValue(str));
+  return true;
+}
+
+// Store the parsed form of `address` in `slot`: a Uint8Array of 4 or 16
+// bytes, or null if it isn't an IP address. x-forwarded-for may carry a
+// list; its first entry is the client.
+template <typename Slot>
+bool store_ip(JSContext *cx, JS::HandleObject obj, Slot slot, std::string_view address) {
+  address = address.substr(0, address.find(','));
+  cidr_set::IpAddress ip;
+  JS::Value val = JS::NullValue();
+  if (cidr_set::parse_ip(address, &ip)) {
+    JSObject *bytes = cidr_set::ip_to_bytes(cx, ip);
+    if (!bytes) return false;
+    val = JS::ObjectValue(*bytes);
+  }
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(slot), val);
+  return true;
+}
+
+// Store a `number | null` in `slot` of `obj`.
 // Empty / non-finite / unparseable input → null. Otherwise the parsed double.
-bool define_decimal_or_null(JSContext *cx, JS::HandleObject obj, const char *name,
-                            std::string_view raw) {
-  JS::RootedValue val(cx);
-  if (raw.empty()) {
-    val.setNull();
-  } else {
+// `raw` must be NUL-terminated, as InfoHeaderSnapshot values are.
+template <typename Slot>
+void store_decimal_or_null(JS::HandleObject obj, Slot slot, std::string_view raw) {
+  JS::Value val = JS::NullValue();
+  if (!raw.empty()) {
     char *end = nullptr;
-    std::string buf(raw);  // strtod needs NUL-terminated input
-    double n = std::strtod(buf.c_str(), &end);
-    if (end == buf.c_str() || !std::isfinite(n)) {
-      val.setNull();
-    } else {
-      val.setNumber(n);
+    double n = std::strtod(raw.data(), &end);
+    if (end != raw.data() && std::isfinite(n)) {
+      val = JS::NumberValue(n);
     }
   }
-  return JS_DefineProperty(cx, obj, name, val,
-                           JSPROP_READONLY | JSPROP_PERMANENT | JSPROP_ENUMERATE);
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(slot), val);
+}
+
+// Property names of each info class, indexed by slot. nullptr marks
+// internal slots that aren't exposed.
+template <typename Info> struct InfoFields;
+
+template <> struct InfoFields<ClientInfo> {
+  static constexpr const char *names[] = {nullptr,    "address",  "ip",
+                                          "tlsJA3MD5", "protocol", "geo"};
+};
+
+template <> struct InfoFields<GeoInfo> {
+  static constexpr const char *names[] = {"asn",         "latitude",    "longitude",
+                                          "region",      "continent",   "countryCode",
+                                          "countryName", "city"};
+};
+
+template <> struct InfoFields<ServerInfo> {
+  static constexpr const char *names[] = {nullptr, "address", "name", "pop"};
+};
+
+template <> struct InfoFields<PopInfo> {
+  static constexpr const char *names[] = {"latitude",    "longitude",   "region",
+                                          "continent",   "countryCode", "countryName",
+                                          "city"};
+};
+
+static_assert(std::size(InfoFields<ClientInfo>::names) ==
+              static_cast<size_t>(ClientInfo::Slots::Count));
+static_assert(std::size(InfoFields<GeoInfo>::names) ==
+              static_cast<size_t>(GeoInfo::Slots::Count));
+static_assert(std::size(InfoFields<ServerInfo>::names) ==
+              static_cast<size_t>(ServerInfo::Slots::Count));
+static_assert(std::size(InfoFields<PopInfo>::names) ==
+              static_cast<size_t>(PopInfo::Slots::Count));
+
+// Prototype getter returning the value stored in `slot`.
+template <typename Info, typename Info::Slots slot>
+bool slot_get(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  constexpr const char *name = InfoFields<Info>::names[static_cast<size_t>(slot)];
+  if (!Info::check_receiver(cx, args.thisv(), name)) return false;
+  args.rval().set(JS::GetReservedSlot(&args.thisv().toObject(),
+                                      static_cast<uint32_t>(slot)));
+  return true;
 }
 
-// Replace this lazy getter with a data property holding `value` on `instance`.
-// Subsequent accesses on this instance hit the data property without
-// dispatching through the prototype getter.
-bool cache_on_instance(JSContext *cx, JS::HandleObject instance,
-                       const char *name, JS::HandleValue value) {
-  return JS_DefineProperty(cx, instance, name, value,
-                           JSPROP_READONLY | JSPROP_PERMANENT | JSPROP_ENUMERATE);
+// `toJSON()` — the fields live on the prototype as accessors, so
+// JSON.stringify would otherwise see an empty object. Nested namespaces are
+// included only once they have been built, as before.
+template <typename Info>
+bool info_to_json(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!Info::check_receiver(cx, args.thisv(), "toJSON")) return false;
+  JS::RootedObject self(cx, &args.thisv().toObject());
+
+  JS::RootedObject out(cx, JS_NewPlainObject(cx));
+  if (!out) return false;
+  JS::RootedValue val(cx);
+  const auto &names = InfoFields<Info>::names;
+  for (size_t i = 0; i < std::size(names); i++) {
+    if (!names[i]) continue;
+    val = JS::GetReservedSlot(self, static_cast<uint32_t>(i));
+    if (val.isUndefined()) continue;
+    if (!JS_DefineProperty(cx, out, names[i], val, JSPROP_ENUMERATE)) return false;
+  }
+  args.rval().setObject(*out);
+  return true;
+}
+
+// Info object built by `create` and held in `slot` of the event's
+// EventInfo.
+template <typename Info>
+bool cached_info(JSContext *cx, JS::HandleObject fetch_event, EventInfo::Slot slot,
+                 JS::MutableHandleValue rval) {
+  JS::RootedObject holder(cx, event_info(cx, fetch_event));
+  if (!holder) return false;
+
+  JS::Value cached = JS::GetReservedSlot(holder, static_cast<uint32_t>(slot));
+  if (cached.isObject()) {
+    rval.set(cached);
+    return true;
+  }
+
+  JS::RootedObject info(cx, Info::create(cx, fetch_event));
+  if (!info) return false;
+  JS::SetReservedSlot(holder, static_cast<uint32_t>(slot), JS::ObjectValue(*info));
+  rval.setObject(*info);
+  return true;
 }
 
 // `event.client` getter — installed on FetchEvent.prototype.
@@ -100,12 +481,7 @@ bool fetch_event_client_get(JSContext *cx, unsigned argc, JS::Value *vp) {
     return false;
   }
   JS::RootedObject self(cx, &args.thisv().toObject());
-  JS::RootedObject info(cx, ClientInfo::create(cx, self));
-  if (!info) return false;
-  JS::RootedValue value(cx, JS::ObjectValue(*info));
-  if (!cache_on_instance(cx, self, "client", value)) return false;
-  args.rval().set(value);
-  return true;
+  return cached_info<ClientInfo>(cx, self, EventInfo::Slot::Client, args.rval());
 }
 
 // `event.server` getter — installed on FetchEvent.prototype.
@@ -116,63 +492,148 @@ bool fetch_event_server_get(JSContext *cx, unsigned argc, JS::Value *vp) {
     return false;
   }
   JS::RootedObject self(cx, &args.thisv().toObject());
-  JS::RootedObject info(cx, ServerInfo::create(cx, self));
-  if (!info) return false;
-  JS::RootedValue value(cx, JS::ObjectValue(*info));
-  if (!cache_on_instance(cx, self, "server", value)) return false;
-  args.rval().set(value);
-  return true;
+  return cached_info<ServerInfo>(cx, self, EventInfo::Slot::Server, args.rval());
 }
 
-// `clientInfo.geo` getter — installed on ClientInfo.prototype.
-bool client_info_geo_get(JSContext *cx, unsigned argc, JS::Value *vp) {
+// `event.cookies` getter — installed on FetchEvent.prototype.
+bool fetch_event_cookies_get(JSContext *cx, unsigned argc, JS::Value *vp) {
   JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
-  if (!ClientInfo::check_receiver(cx, args.thisv(), "geo")) return false;
+  if (!args.thisv().isObject()) {
+    JS_ReportErrorUTF8(cx, "cookies: receiver must be a FetchEvent");
+    return false;
+  }
   JS::RootedObject self(cx, &args.thisv().toObject());
+  return cached_info<CookieJar>(cx, self, EventInfo::Slot::Cookies, args.rval());
+}
+
+// Getter for a nested namespace (`client.geo`, `server.pop`): built from
+// the FetchEvent back-reference on first access, then kept in `slot`.
+template <typename Info, typename Nested, typename Info::Slots slot>
+bool nested_info_get(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  constexpr const char *name = InfoFields<Info>::names[static_cast<size_t>(slot)];
+  if (!Info::check_receiver(cx, args.thisv(), name)) return false;
+  JS::RootedObject self(cx, &args.thisv().toObject());
+
+  JS::Value cached = JS::GetReservedSlot(self, static_cast<uint32_t>(slot));
+  if (cached.isObject()) {
+    args.rval().set(cached);
+    return true;
+  }
 
-  JS::Value fe_val = JS::GetReservedSlot(
-      self, static_cast<uint32_t>(ClientInfo::Slots::FetchEvent));
+  JS::Value fe_val = JS::GetReservedSlot(self, static_cast<uint32_t>(Info::Slots::FetchEvent));
   if (!fe_val.isObject()) {
-    JS_ReportErrorUTF8(cx, "ClientInfo.geo: missing FetchEvent reference");
+    JS_ReportErrorUTF8(cx, "%s.%s: missing FetchEvent reference", Info::class_name, name);
     return false;
   }
   JS::RootedObject fe(cx, &fe_val.toObject());
-  JS::RootedObject geo(cx, GeoInfo::create(cx, fe));
-  if (!geo) return false;
-  JS::RootedValue value(cx, JS::ObjectValue(*geo));
-  if (!cache_on_instance(cx, self, "geo", value)) return false;
-  args.rval().set(value);
+  JS::RootedObject nested(cx, Nested::create(cx, fe));
+  if (!nested) return false;
+  JS::SetReservedSlot(self, static_cast<uint32_t>(slot), JS::ObjectValue(*nested));
+  args.rval().setObject(*nested);
   return true;
 }
 
-// `serverInfo.pop` getter — installed on ServerInfo.prototype.
-bool server_info_pop_get(JSContext *cx, unsigned argc, JS::Value *vp) {
-  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
-  if (!ServerInfo::check_receiver(cx, args.thisv(), "pop")) return false;
+bool is_ows(char c) { return c == ' ' || c == '\t'; }
+
+std::string_view trim_ows(std::string_view s) {
+  while (!s.empty() && is_ows(s.front())) s.remove_prefix(1);
+  while (!s.empty() && is_ows(s.back())) s.remove_suffix(1);
+  return s;
+}
+
+// Call `fn(name, value)` for each `name=value` pair of a Cookie header, in
+// order, until it returns false. Works on views into `header`; nothing is
+// copied. Pairs without `=` or with an empty name are skipped, and a
+// double-quoted value is unquoted.
+template <typename Fn> void for_each_cookie(std::string_view header, Fn fn) {
+  size_t pos = 0;
+  while (pos < header.size()) {
+    size_t end = header.find(';', pos);
+    if (end == std::string_view::npos) end = header.size();
+    std::string_view pair = header.substr(pos, end - pos);
+    pos = end + 1;
+
+    size_t eq = pair.find('=');
+    if (eq == std::string_view::npos) continue;
+    std::string_view name = trim_ows(pair.substr(0, eq));
+    std::string_view value = trim_ows(pair.substr(eq + 1));
+    if (name.empty()) continue;
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+      value = value.substr(1, value.size() - 2);
+    }
+    if (!fn(name, value)) return;
+  }
+}
+
+// Whether `name` equals `bytes`, compared code unit by byte without
+// copying the JS string.
+bool linear_equals(JSLinearString *name, std::string_view bytes) {
+  if (JS::GetLinearStringLength(name) != bytes.size()) return false;
+  for (size_t i = 0; i < bytes.size(); i++) {
+    if (JS::GetLinearStringCharAt(name, i) != static_cast<uint8_t>(bytes[i])) return false;
+  }
+  return true;
+}
+
+// A JS string for cookie text; ASCII skips UTF-8 decoding. Cookie values
+// may carry obs-text that isn't valid UTF-8 (RFC 6265), so such text is
+// read as Latin-1, the way `headers.get("cookie")` exposes it, rather than
+// letting a client-supplied header make the lookup throw.
+JSString *new_cookie_string(JSContext *cx, std::string_view text) {
+  for (char c : text) {
+    if (static_cast<uint8_t>(c) & 0x80) {
+      if (!JS::StringIsUTF8(mozilla::Span(text.data(), text.size()))) break;
+      return JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(text.data(), text.size()));
+    }
+  }
+  return JS_NewStringCopyN(cx, text.data(), text.size());
+}
+
+// The Cookie header of the jar in `args.thisv()`, and the requested cookie
+// name as a linear string.
+bool cookie_args(JSContext *cx, JS::CallArgs &args, const char *method,
+                 std::string_view *header, JS::MutableHandleString name) {
+  if (!CookieJar::check_receiver(cx, args.thisv(), method)) return false;
   JS::RootedObject self(cx, &args.thisv().toObject());
 
-  JS::Value fe_val = JS::GetReservedSlot(
-      self, static_cast<uint32_t>(ServerInfo::Slots::FetchEvent));
+  JS::RootedString name_str(cx, JS::ToString(cx, args.get(0)));
+  if (!name_str) return false;
+  JSLinearString *linear = JS_EnsureLinearString(cx, name_str);
+  if (!linear) return false;
+  name.set(JS_FORGET_STRING_LINEARNESS(linear));
+
+  JS::Value fe_val = JS::GetReservedSlot(self, static_cast<uint32_t>(CookieJar::Slots::FetchEvent));
   if (!fe_val.isObject()) {
-    JS_ReportErrorUTF8(cx, "ServerInfo.pop: missing FetchEvent reference");
+    JS_ReportErrorUTF8(cx, "CookieJar.%s: missing FetchEvent reference", method);
     return false;
   }
   JS::RootedObject fe(cx, &fe_val.toObject());
-  JS::RootedObject pop(cx, PopInfo::create(cx, fe));
-  if (!pop) return false;
-  JS::RootedValue value(cx, JS::ObjectValue(*pop));
-  if (!cache_on_instance(cx, self, "pop", value)) return false;
-  args.rval().set(value);
+  const InfoHeaderSnapshot *headers = event_headers(cx, fe);
+  if (!headers) return false;
+  *header = headers->cookies;
   return true;
 }
 
 }  // namespace
 
+// Each class exposes its fields as enumerable prototype getters over
+// reserved slots, so `create` is one allocation plus slot stores and every
+// instance shares the prototype's shape.
+
 // === ClientInfo ===
 
-const JSFunctionSpec ClientInfo::methods[] = {JS_FS_END};
+const JSFunctionSpec ClientInfo::methods[] = {
+    JS_FN("toJSON", info_to_json<ClientInfo>, 0, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
 const JSPropertySpec ClientInfo::properties[] = {
-    JS_PSG("geo", client_info_geo_get, JSPROP_ENUMERATE),
+    JS_PSG("address", (slot_get<ClientInfo, ClientInfo::Slots::Address>), JSPROP_ENUMERATE),
+    JS_PSG("ip", (slot_get<ClientInfo, ClientInfo::Slots::Ip>), JSPROP_ENUMERATE),
+    JS_PSG("tlsJA3MD5", (slot_get<ClientInfo, ClientInfo::Slots::TlsJA3MD5>), JSPROP_ENUMERATE),
+    JS_PSG("protocol", (slot_get<ClientInfo, ClientInfo::Slots::Protocol>), JSPROP_ENUMERATE),
+    JS_PSG("geo", (nested_info_get<ClientInfo, GeoInfo, ClientInfo::Slots::Geo>),
+           JSPROP_ENUMERATE),
     JS_PS_END,
 };
 const JSFunctionSpec ClientInfo::static_methods[] = {JS_FS_END};
@@ -186,17 +647,20 @@ JSObject *ClientInfo::create(JSContext *cx, JS::HandleObject fetch_event) {
   JS::SetReservedSlot(self, static_cast<uint32_t>(Slots::FetchEvent),
                       JS::ObjectValue(*fetch_event));
 
+  const InfoHeaderSnapshot *headers = event_headers(cx, fetch_event);
+  if (!headers) return nullptr;
+
   // Direct fields — eager. Fallback chain on address: x-real-ip is the
   // trusted edge-set value; x-forwarded-for is the fallback if the platform
   // ever stops setting x-real-ip on a given path.
-  std::string address =
-      read_header_fallback(cx, fetch_event, {"x-real-ip", "x-forwarded-for"});
-  if (!define_str(cx, self, "address", address)) return nullptr;
-  if (!define_str(cx, self, "tlsJA3MD5", read_header(cx, fetch_event, "x-ja3"))) {
+  auto address = headers->first_of({InfoHeader::RealIp, InfoHeader::ForwardedFor});
+  if (!store_str(cx, self, Slots::Address, address)) return nullptr;
+  if (!store_ip(cx, self, Slots::Ip, address)) return nullptr;
+  if (!store_str(cx, self, Slots::TlsJA3MD5, headers->get(InfoHeader::Ja3))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "protocol",
-                  read_header(cx, fetch_event, "x-forwarded-proto"))) {
+  if (!store_interned_str(cx, self, Slots::Protocol,
+                          headers->get(InfoHeader::ForwardedProto))) {
     return nullptr;
   }
 
@@ -205,8 +669,21 @@ JSObject *ClientInfo::create(JSContext *cx, JS::HandleObject fetch_event) {
 
 // === GeoInfo ===
 
-const JSFunctionSpec GeoInfo::methods[] = {JS_FS_END};
-const JSPropertySpec GeoInfo::properties[] = {JS_PS_END};
+const JSFunctionSpec GeoInfo::methods[] = {
+    JS_FN("toJSON", info_to_json<GeoInfo>, 0, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+const JSPropertySpec GeoInfo::properties[] = {
+    JS_PSG("asn", (slot_get<GeoInfo, GeoInfo::Slots::Asn>), JSPROP_ENUMERATE),
+    JS_PSG("latitude", (slot_get<GeoInfo, GeoInfo::Slots::Latitude>), JSPROP_ENUMERATE),
+    JS_PSG("longitude", (slot_get<GeoInfo, GeoInfo::Slots::Longitude>), JSPROP_ENUMERATE),
+    JS_PSG("region", (slot_get<GeoInfo, GeoInfo::Slots::Region>), JSPROP_ENUMERATE),
+    JS_PSG("continent", (slot_get<GeoInfo, GeoInfo::Slots::Continent>), JSPROP_ENUMERATE),
+    JS_PSG("countryCode", (slot_get<GeoInfo, GeoInfo::Slots::CountryCode>), JSPROP_ENUMERATE),
+    JS_PSG("countryName", (slot_get<GeoInfo, GeoInfo::Slots::CountryName>), JSPROP_ENUMERATE),
+    JS_PSG("city", (slot_get<GeoInfo, GeoInfo::Slots::City>), JSPROP_ENUMERATE),
+    JS_PS_END,
+};
 const JSFunctionSpec GeoInfo::static_methods[] = {JS_FS_END};
 const JSPropertySpec GeoInfo::static_properties[] = {JS_PS_END};
 
@@ -214,33 +691,30 @@ JSObject *GeoInfo::create(JSContext *cx, JS::HandleObject fetch_event) {
   JS::RootedObject self(cx, JS_NewObjectWithGivenProto(cx, &class_, proto_obj));
   if (!self) return nullptr;
 
-  if (!define_str(cx, self, "asn", read_header(cx, fetch_event, "geoip-asn"))) {
-    return nullptr;
-  }
-  if (!define_decimal_or_null(cx, self, "latitude",
-                              read_header(cx, fetch_event, "geoip-lat"))) {
-    return nullptr;
-  }
-  if (!define_decimal_or_null(cx, self, "longitude",
-                              read_header(cx, fetch_event, "geoip-long"))) {
+  const InfoHeaderSnapshot *headers = event_headers(cx, fetch_event);
+  if (!headers) return nullptr;
+
+  if (!store_str(cx, self, Slots::Asn, headers->get(InfoHeader::GeoAsn))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "region", read_header(cx, fetch_event, "geoip-reg"))) {
+  store_decimal_or_null(self, Slots::Latitude, headers->get(InfoHeader::GeoLat));
+  store_decimal_or_null(self, Slots::Longitude, headers->get(InfoHeader::GeoLong));
+  if (!store_interned_str(cx, self, Slots::Region, headers->get(InfoHeader::GeoReg))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "continent",
-                  read_header(cx, fetch_event, "geoip-continent"))) {
+  if (!store_interned_str(cx, self, Slots::Continent,
+                          headers->get(InfoHeader::GeoContinent))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "countryCode",
-                  read_header(cx, fetch_event, "geoip-country-code"))) {
+  if (!store_interned_str(cx, self, Slots::CountryCode,
+                          headers->get(InfoHeader::GeoCountryCode))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "countryName",
-                  read_header(cx, fetch_event, "geoip-country-name"))) {
+  if (!store_interned_str(cx, self, Slots::CountryName,
+                          headers->get(InfoHeader::GeoCountryName))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "city", read_header(cx, fetch_event, "geoip-city"))) {
+  if (!store_str(cx, self, Slots::City, headers->get(InfoHeader::GeoCity))) {
     return nullptr;
   }
 
@@ -249,9 +723,15 @@ JSObject *GeoInfo::create(JSContext *cx, JS::HandleObject fetch_event) {
 
 // === ServerInfo ===
 
-const JSFunctionSpec ServerInfo::methods[] = {JS_FS_END};
+const JSFunctionSpec ServerInfo::methods[] = {
+    JS_FN("toJSON", info_to_json<ServerInfo>, 0, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
 const JSPropertySpec ServerInfo::properties[] = {
-    JS_PSG("pop", server_info_pop_get, JSPROP_ENUMERATE),
+    JS_PSG("address", (slot_get<ServerInfo, ServerInfo::Slots::Address>), JSPROP_ENUMERATE),
+    JS_PSG("name", (slot_get<ServerInfo, ServerInfo::Slots::Name>), JSPROP_ENUMERATE),
+    JS_PSG("pop", (nested_info_get<ServerInfo, PopInfo, ServerInfo::Slots::Pop>),
+           JSPROP_ENUMERATE),
     JS_PS_END,
 };
 const JSFunctionSpec ServerInfo::static_methods[] = {JS_FS_END};
@@ -261,14 +741,16 @@ JSObject *ServerInfo::create(JSContext *cx, JS::HandleObject fetch_event) {
   JS::RootedObject self(cx, JS_NewObjectWithGivenProto(cx, &class_, proto_obj));
   if (!self) return nullptr;
 
+  const InfoHeaderSnapshot *headers = event_headers(cx, fetch_event);
+  if (!headers) return nullptr;
+
   JS::SetReservedSlot(self, static_cast<uint32_t>(Slots::FetchEvent),
                       JS::ObjectValue(*fetch_event));
 
-  if (!define_str(cx, self, "address",
-                  read_header(cx, fetch_event, "server_addr"))) {
+  if (!store_str(cx, self, Slots::Address, headers->get(InfoHeader::ServerAddr))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "name", read_header(cx, fetch_event, "server_name"))) {
+  if (!store_str(cx, self, Slots::Name, headers->get(InfoHeader::ServerName))) {
     return nullptr;
   }
 
@@ -277,8 +759,20 @@ JSObject *ServerInfo::create(JSContext *cx, JS::HandleObject fetch_event) {
 
 // === PopInfo ===
 
-const JSFunctionSpec PopInfo::methods[] = {JS_FS_END};
-const JSPropertySpec PopInfo::properties[] = {JS_PS_END};
+const JSFunctionSpec PopInfo::methods[] = {
+    JS_FN("toJSON", info_to_json<PopInfo>, 0, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+const JSPropertySpec PopInfo::properties[] = {
+    JS_PSG("latitude", (slot_get<PopInfo, PopInfo::Slots::Latitude>), JSPROP_ENUMERATE),
+    JS_PSG("longitude", (slot_get<PopInfo, PopInfo::Slots::Longitude>), JSPROP_ENUMERATE),
+    JS_PSG("region", (slot_get<PopInfo, PopInfo::Slots::Region>), JSPROP_ENUMERATE),
+    JS_PSG("continent", (slot_get<PopInfo, PopInfo::Slots::Continent>), JSPROP_ENUMERATE),
+    JS_PSG("countryCode", (slot_get<PopInfo, PopInfo::Slots::CountryCode>), JSPROP_ENUMERATE),
+    JS_PSG("countryName", (slot_get<PopInfo, PopInfo::Slots::CountryName>), JSPROP_ENUMERATE),
+    JS_PSG("city", (slot_get<PopInfo, PopInfo::Slots::City>), JSPROP_ENUMERATE),
+    JS_PS_END,
+};
 const JSFunctionSpec PopInfo::static_methods[] = {JS_FS_END};
 const JSPropertySpec PopInfo::static_properties[] = {JS_PS_END};
 
@@ -286,34 +780,141 @@ JSObject *PopInfo::create(JSContext *cx, JS::HandleObject fetch_event) {
   JS::RootedObject self(cx, JS_NewObjectWithGivenProto(cx, &class_, proto_obj));
   if (!self) return nullptr;
 
-  if (!define_decimal_or_null(cx, self, "latitude",
-                              read_header(cx, fetch_event, "pop-lat"))) {
+  const InfoHeaderSnapshot *headers = event_headers(cx, fetch_event);
+  if (!headers) return nullptr;
+
+  store_decimal_or_null(self, Slots::Latitude, headers->get(InfoHeader::PopLat));
+  store_decimal_or_null(self, Slots::Longitude, headers->get(InfoHeader::PopLong));
+  if (!store_interned_str(cx, self, Slots::Region, headers->get(InfoHeader::PopReg))) {
     return nullptr;
   }
-  if (!define_decimal_or_null(cx, self, "longitude",
-                              read_header(cx, fetch_event, "pop-long"))) {
+  if (!store_interned_str(cx, self, Slots::Continent,
+                          headers->get(InfoHeader::PopContinent))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "region", read_header(cx, fetch_event, "pop-reg"))) {
+  if (!store_interned_str(cx, self, Slots::CountryCode,
+                          headers->get(InfoHeader::PopCountryCode))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "continent",
-                  read_header(cx, fetch_event, "pop-continent"))) {
+  if (!store_interned_str(cx, self, Slots::CountryName,
+                          headers->get(InfoHeader::PopCountryName))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "countryCode",
-                  read_header(cx, fetch_event, "pop-country-code"))) {
+  if (!store_interned_str(cx, self, Slots::City, headers->get(InfoHeader::PopCity))) {
     return nullptr;
   }
-  if (!define_str(cx, self, "countryName",
-                  read_header(cx, fetch_event, "pop-country-name"))) {
-    return nullptr;
+
+  return self;
+}
+
+// === CookieJar ===
+
+const JSFunctionSpec CookieJar::methods[] = {
+    JS_FN("get", CookieJar::get, 1, JSPROP_ENUMERATE),
+    JS_FN("has", CookieJar::has, 1, JSPROP_ENUMERATE),
+    JS_FN("getAll", CookieJar::get_all, 0, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+const JSPropertySpec CookieJar::properties[] = {JS_PS_END};
+const JSFunctionSpec CookieJar::static_methods[] = {JS_FS_END};
+const JSPropertySpec CookieJar::static_properties[] = {JS_PS_END};
+
+JSObject *CookieJar::create(JSContext *cx, JS::HandleObject fetch_event) {
+  JS::RootedObject self(cx, JS_NewObjectWithGivenProto(cx, &class_, proto_obj));
+  if (!self) return nullptr;
+
+  // Nothing is parsed here; get / has / getAll scan the Cookie header from
+  // the FetchEvent's header snapshot when called.
+  JS::SetReservedSlot(self, static_cast<uint32_t>(Slots::FetchEvent),
+                      JS::ObjectValue(*fetch_event));
+  return self;
+}
+
+bool CookieJar::get(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  std::string_view header;
+  JS::RootedString name(cx);
+  if (!cookie_args(cx, args, "get", &header, &name)) return false;
+
+  // The scan doesn't allocate, so `linear` stays valid throughout.
+  JSLinearString *linear = JS_ASSERT_STRING_IS_LINEAR(name);
+  std::optional<std::string_view> found;
+  for_each_cookie(header, [&](std::string_view cookie_name, std::string_view value) {
+    if (!linear_equals(linear, cookie_name)) return true;
+    found = value;
+    return false;
+  });
+
+  if (!found) {
+    args.rval().setNull();
+    return true;
   }
-  if (!define_str(cx, self, "city", read_header(cx, fetch_event, "pop-city"))) {
-    return nullptr;
+  JSString *value = new_cookie_string(cx, *found);
+  if (!value) return false;
+  args.rval().setString(value);
+  return true;
+}
+
+bool CookieJar::has(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  std::string_view header;
+  JS::RootedString name(cx);
+  if (!cookie_args(cx, args, "has", &header, &name)) return false;
+
+  JSLinearString *linear = JS_ASSERT_STRING_IS_LINEAR(name);
+  bool found = false;
+  for_each_cookie(header, [&](std::string_view cookie_name, std::string_view) {
+    found = linear_equals(linear, cookie_name);
+    return !found;
+  });
+  args.rval().setBoolean(found);
+  return true;
+}
+
+bool CookieJar::get_all(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!check_receiver(cx, args.thisv(), "getAll")) return false;
+  JS::RootedObject self(cx, &args.thisv().toObject());
+
+  JS::Value fe_val = JS::GetReservedSlot(self, static_cast<uint32_t>(Slots::FetchEvent));
+  if (!fe_val.isObject()) {
+    JS_ReportErrorUTF8(cx, "CookieJar.getAll: missing FetchEvent reference");
+    return false;
   }
+  JS::RootedObject fe(cx, &fe_val.toObject());
+  const InfoHeaderSnapshot *headers = event_headers(cx, fe);
+  if (!headers) return false;
+  std::string_view header = headers->cookies;
 
-  return self;
+  JS::RootedObject out(cx, JS_NewPlainObject(cx));
+  if (!out) return false;
+
+  bool ok = true;
+  JS::RootedString str(cx);
+  JS::RootedId id(cx);
+  JS::RootedValue val(cx);
+  for_each_cookie(header, [&](std::string_view cookie_name, std::string_view value) {
+    str = new_cookie_string(cx, cookie_name);
+    ok = str && JS_StringToId(cx, str, &id);
+    if (!ok) return false;
+
+    // The first occurrence wins, matching get().
+    bool exists;
+    ok = JS_HasOwnPropertyById(cx, out, id, &exists);
+    if (!ok) return false;
+    if (exists) return true;
+
+    str = new_cookie_string(cx, value);
+    ok = str != nullptr;
+    if (!ok) return false;
+    val.setString(str);
+    ok = JS_DefinePropertyById(cx, out, id, val, JSPROP_ENUMERATE);
+    return ok;
+  });
+  if (!ok) return false;
+
+  args.rval().setObject(*out);
+  return true;
 }
 
 // === install ===
@@ -322,15 +923,22 @@ bool install(api::Engine *engine) {
   JSContext *cx = engine->cx();
   JS::RootedObject global(cx, engine->global());
 
-  // Initialise the four classes. BuiltinNoConstructor::init_class registers
+  JS::RootedObject event_info_map(cx, JS::NewWeakMapObject(cx));
+  if (!event_info_map) return false;
+  EVENT_INFO = new JS::PersistentRooted<JSObject *>(cx, event_info_map);
+  if (!seed_interned_strings(cx)) return false;
+
+  // Initialise the info classes. BuiltinNoConstructor::init_class registers
   // the JSClass via JS_InitClass (which creates the prototype) and then
   // removes the class name from globalThis so user code can't `new` them.
   if (!ClientInfo::init_class(cx, global)) return false;
   if (!GeoInfo::init_class(cx, global)) return false;
   if (!ServerInfo::init_class(cx, global)) return false;
   if (!PopInfo::init_class(cx, global)) return false;
+  if (!CookieJar::init_class(cx, global)) return false;
 
-  // Patch FetchEvent.prototype with the lazy `client` and `server` getters.
+  // Patch FetchEvent.prototype with the lazy `client`, `server` and
+  // `cookies` getters.
   // FetchEvent itself is a BuiltinNoConstructor, which means its
   // constructor is deleted from globalThis after init_class runs — so we
   // can't reach the prototype via `globalThis.FetchEvent.prototype`.
@@ -345,6 +953,7 @@ bool install(api::Engine *engine) {
   static const JSPropertySpec fetch_event_extension[] = {
       JS_PSG("client", fetch_event_client_get, JSPROP_ENUMERATE),
       JS_PSG("server", fetch_event_server_get, JSPROP_ENUMERATE),
+      JS_PSG("cookies", fetch_event_cookies_get, JSPROP_ENUMERATE),
       JS_PS_END,
   };
   if (!JS_DefineProperties(cx, fe_proto, fetch_event_extension)) return false;
@@ -6,16 +6,21 @@
 namespace fastedge::request_info {
 
 // Lazy `event.client` namespace.
-// Direct fields (address, tlsJA3MD5, protocol) are populated as data
-// properties when the instance is constructed; the nested `geo` namespace
-// is a separate getter on this class's prototype that builds GeoInfo on
-// first access and replaces itself with a data property on the instance.
+// Direct fields (address, ip, tlsJA3MD5, protocol) are stored in reserved slots
+// when the instance is constructed and read through getters on the
+// prototype, so every instance shares one shape. The nested `geo`
+// namespace is built on first access and kept in the Geo slot.
 class ClientInfo final : public ::builtins::BuiltinNoConstructor<ClientInfo> {
 public:
   static constexpr const char *class_name = "ClientInfo";
 
   enum class Slots : uint8_t {
     FetchEvent,  // Back-reference; needed by the lazy `geo` getter.
+    Address,
+    Ip,          // Uint8Array (4 or 16 bytes), or null if `address` doesn't parse.
+    TlsJA3MD5,
+    Protocol,
+    Geo,         // GeoInfo, or undefined until first accessed.
     Count,
   };
 
@@ -37,6 +42,14 @@ public:
   static constexpr const char *class_name = "GeoInfo";
 
   enum class Slots : uint8_t {
+    Asn,
+    Latitude,
+    Longitude,
+    Region,
+    Continent,
+    CountryCode,
+    CountryName,
+    City,
     Count,
   };
 
@@ -57,6 +70,9 @@ public:
 
   enum class Slots : uint8_t {
     FetchEvent,  // Back-reference; needed by the lazy `pop` getter.
+    Address,
+    Name,
+    Pop,         // PopInfo, or undefined until first accessed.
     Count,
   };
 
@@ -74,6 +90,13 @@ public:
   static constexpr const char *class_name = "PopInfo";
 
   enum class Slots : uint8_t {
+    Latitude,
+    Longitude,
+    Region,
+    Continent,
+    CountryCode,
+    CountryName,
+    City,
     Count,
   };
 
@@ -85,6 +108,30 @@ public:
   static JSObject *create(JSContext *cx, JS::HandleObject fetch_event);
 };
 
+// Lazy `event.cookies` namespace.
+// Holds only a FetchEvent back-reference. Each lookup scans the Cookie
+// header natively and allocates a JS string only for the value it returns.
+class CookieJar final : public ::builtins::BuiltinNoConstructor<CookieJar> {
+public:
+  static constexpr const char *class_name = "CookieJar";
+
+  enum class Slots : uint8_t {
+    FetchEvent,  // Back-reference; the Cookie header is read from its snapshot.
+    Count,
+  };
+
+  static const JSFunctionSpec methods[];
+  static const JSPropertySpec properties[];
+  static const JSFunctionSpec static_methods[];
+  static const JSPropertySpec static_properties[];
+
+  static bool get(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool has(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool get_all(JSContext *cx, unsigned argc, JS::Value *vp);
+
+  static JSObject *create(JSContext *cx, JS::HandleObject fetch_event);
+};
+
 bool install(api::Engine *engine);
 
 }  // namespace fastedge::request_info
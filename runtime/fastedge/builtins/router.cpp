@@ -0,0 +1,492 @@
+#include "builtin.h"
+#include "encode.h"
+
+#include <js/Array.h>
+#include <js/CharacterEncoding.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fastedge::router {
+
+namespace {
+
+// Method value of routes that match any method.
+constexpr std::string_view ANY_METHOD = "*";
+
+struct Route {
+  std::string method;                    // Upper-case, or ANY_METHOD.
+  std::vector<std::string> param_names;  // `:name` segments, in order.
+  bool wildcard = false;                 // Ends in `*`.
+};
+
+// One path segment position in the tree: static children by segment text,
+// one `:param` child shared by every parameter name at this position, and
+// the routes ending here. Among all routes that match a path, the one
+// registered first wins, as in Hono's and itty's routers.
+struct Node {
+  std::map<std::string, std::unique_ptr<Node>, std::less<>> statics;
+  std::unique_ptr<Node> param;
+  std::vector<uint32_t> routes;           // Routes ending exactly here.
+  std::vector<uint32_t> wildcard_routes;  // Routes ending in `*` here.
+  uint32_t min_route = UINT32_MAX;        // Lowest route index in this subtree.
+};
+
+// Split `path` into segments after its leading `/`. `/` has no segments;
+// a trailing slash yields a final empty segment, so `/a/` and `/a` differ.
+std::vector<std::string_view> split_path(std::string_view path) {
+  std::vector<std::string_view> segments;
+  if (!path.empty() && path.front() == '/') path.remove_prefix(1);
+  if (path.empty()) return segments;
+  size_t pos = 0;
+  for (;;) {
+    size_t slash = path.find('/', pos);
+    if (slash == std::string_view::npos) {
+      segments.push_back(path.substr(pos));
+      return segments;
+    }
+    segments.push_back(path.substr(pos, slash - pos));
+    pos = slash + 1;
+  }
+}
+
+// The path of `target`: a full URL is reduced to its path, and the query
+// string and fragment are dropped. Only a "://" ahead of the first '/', '?'
+// or '#' marks a scheme, so one inside the query never moves the path.
+std::string_view request_path(std::string_view target) {
+  size_t scheme = target.find("://");
+  if (scheme != std::string_view::npos && scheme < target.find_first_of("/?#")) {
+    size_t authority_end = target.find_first_of("/?#", scheme + 3);
+    target = authority_end == std::string_view::npos || target[authority_end] != '/'
+                 ? std::string_view("/")
+                 : target.substr(authority_end);
+  }
+  size_t end = target.find_first_of("?#");
+  return end == std::string_view::npos ? target : target.substr(0, end);
+}
+
+int hex_digit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Percent-decode `text` into `out`. Malformed escapes are kept as-is.
+void percent_decode(std::string_view text, std::string *out) {
+  out->clear();
+  out->reserve(text.size());
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] == '%' && i + 2 < text.size()) {
+      int hi = hex_digit(text[i + 1]);
+      int lo = hex_digit(text[i + 2]);
+      if (hi >= 0 && lo >= 0) {
+        out->push_back(static_cast<char>((hi << 4) | lo));
+        i += 2;
+        continue;
+      }
+    }
+    out->push_back(text[i]);
+  }
+}
+
+class RouteTree {
+public:
+  RouteTree() : root_(std::make_unique<Node>()) {}
+
+  // Add `pattern` for `method` as the next route. Returns an error message
+  // on failure.
+  const char *add(std::string method, std::string_view pattern) {
+    if (pattern.empty() || pattern.front() != '/') return "route must start with '/'";
+
+    uint32_t index = static_cast<uint32_t>(routes_.size());
+    Route route;
+    route.method = std::move(method);
+
+    Node *node = root_.get();
+    node->min_route = std::min(node->min_route, index);
+    auto segments = split_path(pattern);
+    for (size_t i = 0; i < segments.size(); i++) {
+      std::string_view segment = segments[i];
+      if (segment == "*") {
+        if (i + 1 != segments.size()) return "'*' is only supported as the last segment";
+        route.wildcard = true;
+        break;
+      }
+      if (!segment.empty() && segment.front() == ':') {
+        std::string_view name = segment.substr(1);
+        if (name.empty()) return "parameter name must not be empty";
+        if (name.find_first_of("{}()?*") != std::string_view::npos) {
+          return "parameter patterns and optional parameters are not supported";
+        }
+        route.param_names.emplace_back(name);
+        if (!node->param) node->param = std::make_unique<Node>();
+        node = node->param.get();
+      } else {
+        auto it = node->statics.find(segment);
+        if (it == node->statics.end()) {
+          it = node->statics.emplace(std::string(segment), std::make_unique<Node>()).first;
+        }
+        node = it->second.get();
+      }
+      node->min_route = std::min(node->min_route, index);
+    }
+
+    (route.wildcard ? node->wildcard_routes : node->routes).push_back(index);
+    routes_.push_back(std::move(route));
+    return nullptr;
+  }
+
+  struct Match {
+    uint32_t route = UINT32_MAX;
+    std::vector<std::string_view> params;
+    std::string_view rest;  // Remainder matched by `*`.
+  };
+
+  // Find the first-registered route matching `method` and `path`.
+  bool match(std::string_view method, std::string_view path, Match *out) const {
+    auto segments = split_path(path);
+    std::vector<std::string_view> params;
+    std::string_view base = path.empty() || path.front() != '/' ? path : path.substr(1);
+    search(root_.get(), method, base, segments, 0, &params, out);
+    return out->route != UINT32_MAX;
+  }
+
+  const Route &route(uint32_t index) const { return routes_[index]; }
+  size_t size() const { return routes_.size(); }
+
+private:
+  bool method_matches(uint32_t index, std::string_view method) const {
+    const std::string &route_method = routes_[index].method;
+    return route_method == ANY_METHOD || route_method == method;
+  }
+
+  // Lowest-index route in `candidates` accepting `method`, or UINT32_MAX.
+  uint32_t first_route(const std::vector<uint32_t> &candidates, std::string_view method) const {
+    for (uint32_t index : candidates) {
+      if (method_matches(index, method)) return index;
+    }
+    return UINT32_MAX;
+  }
+
+  // Depth-first search for the lowest-index match. Subtrees whose lowest
+  // route index can't beat the best match so far are skipped.
+  void search(const Node *node, std::string_view method, std::string_view path,
+              const std::vector<std::string_view> &segments, size_t depth,
+              std::vector<std::string_view> *params, Match *best) const {
+    if (node->min_route >= best->route) return;
+
+    // `*` matches the rest of the path, including nothing.
+    uint32_t wildcard = first_route(node->wildcard_routes, method);
+    if (wildcard < best->route) {
+      best->route = wildcard;
+      best->params = *params;
+      best->rest = std::string_view();
+      if (depth < segments.size()) {
+        size_t offset = segments[depth].data() - path.data();
+        best->rest = path.substr(offset);
+      }
+    }
+
+    if (depth == segments.size()) {
+      uint32_t exact = first_route(node->routes, method);
+      if (exact < best->route) {
+        best->route = exact;
+        best->params = *params;
+        best->rest = std::string_view();
+      }
+      return;
+    }
+
+    std::string_view segment = segments[depth];
+    auto it = node->statics.find(segment);
+    if (it != node->statics.end()) {
+      search(it->second.get(), method, path, segments, depth + 1, params, best);
+    }
+    if (node->param && !segment.empty()) {
+      params->push_back(segment);
+      search(node->param.get(), method, path, segments, depth + 1, params, best);
+      params->pop_back();
+    }
+  }
+
+  std::unique_ptr<Node> root_;
+  std::vector<Route> routes_;
+};
+
+std::string upper_ascii(std::string_view s) {
+  std::string out(s);
+  for (char &c : out) {
+    if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+  }
+  return out;
+}
+
+// Read one route definition: a path string (any method), a
+// `[method, path]` pair or a `{ method, path }` object.
+bool read_route(JSContext *cx, JS::HandleValue def, uint32_t i, std::string *method,
+                std::string *path) {
+  JS::RootedValue method_val(cx);
+  JS::RootedValue path_val(cx);
+
+  if (def.isString()) {
+    path_val = def;
+  } else if (def.isObject()) {
+    JS::RootedObject obj(cx, &def.toObject());
+    bool is_array = false;
+    if (!JS::IsArrayObject(cx, def, &is_array)) return false;
+    if (is_array) {
+      if (!JS_GetElement(cx, obj, 0, &method_val) || !JS_GetElement(cx, obj, 1, &path_val)) {
+        return false;
+      }
+    } else if (!JS_GetProperty(cx, obj, "method", &method_val) ||
+               !JS_GetProperty(cx, obj, "path", &path_val)) {
+      return false;
+    }
+  }
+
+  if (!path_val.isString() || !(method_val.isUndefined() || method_val.isString())) {
+    JS_ReportErrorUTF8(cx, "Router.compile: route %u must be a path, [method, path] or "
+                           "{ method, path }", i);
+    return false;
+  }
+
+  auto path_chars = core::encode(cx, path_val);
+  if (!path_chars) return false;
+  path->assign(path_chars.ptr.get(), path_chars.len);
+
+  *method = std::string(ANY_METHOD);
+  if (method_val.isString()) {
+    auto method_chars = core::encode(cx, method_val);
+    if (!method_chars) return false;
+    std::string upper = upper_ascii(std::string_view(method_chars.ptr.get(), method_chars.len));
+    if (upper != "ALL") *method = upper;
+  }
+  return true;
+}
+
+JSString *new_string(JSContext *cx, std::string_view text) {
+  for (char c : text) {
+    if (static_cast<uint8_t>(c) & 0x80) {
+      return JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(text.data(), text.size()));
+    }
+  }
+  return JS_NewStringCopyN(cx, text.data(), text.size());
+}
+
+// Define param `name` = percent-decoded `raw` on `params`. If the decoded
+// bytes aren't valid UTF-8 (e.g. `/users/%FF`), the param keeps the raw,
+// still-encoded segment, as Hono's `tryDecode` does, so request paths can't
+// make `match` throw.
+bool define_param(JSContext *cx, JS::HandleObject params, std::string_view name,
+                  std::string_view raw, std::string *scratch) {
+  std::string_view value = raw;
+  if (raw.find('%') != std::string_view::npos) {
+    percent_decode(raw, scratch);
+    if (JS::StringIsUTF8(mozilla::Span(scratch->data(), scratch->size()))) {
+      value = *scratch;
+    }
+  }
+  JS::RootedString value_str(cx, new_string(cx, value));
+  if (!value_str) return false;
+  JS::RootedString name_str(cx, new_string(cx, name));
+  if (!name_str) return false;
+  JS::RootedId id(cx);
+  if (!JS_StringToId(cx, name_str, &id)) return false;
+  JS::RootedValue val(cx, JS::StringValue(value_str));
+  return JS_DefinePropertyById(cx, params, id, val, JSPROP_ENUMERATE);
+}
+
+JS::PersistentRooted<JSObject *> *ROUTER_PROTO = nullptr;
+
+// Compiled router instance. Owns its RouteTree; freed by the finalizer.
+class RouterObject {
+public:
+  enum class Slot : uint32_t {
+    Tree,  // PrivateValue(RouteTree*)
+    Count
+  };
+
+  static const JSClass class_;
+  static const JSFunctionSpec methods[];
+  static const JSPropertySpec properties[];
+
+  static bool compile(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool match(JSContext *cx, unsigned argc, JS::Value *vp);
+  static bool size_get(JSContext *cx, unsigned argc, JS::Value *vp);
+
+  static void finalize(JS::GCContext *gcx, JSObject *obj);
+};
+
+static const JSClassOps router_class_ops = {
+    .finalize = RouterObject::finalize,
+};
+
+const JSClass RouterObject::class_ = {
+    "Router",
+    JSCLASS_HAS_RESERVED_SLOTS(static_cast<uint32_t>(RouterObject::Slot::Count)) |
+        JSCLASS_FOREGROUND_FINALIZE,
+    &router_class_ops
+};
+
+const JSFunctionSpec RouterObject::methods[] = {
+    JS_FN("match", RouterObject::match, 2, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+const JSPropertySpec RouterObject::properties[] = {
+    JS_PSG("size", RouterObject::size_get, JSPROP_ENUMERATE),
+    JS_PS_END,
+};
+
+RouteTree *route_tree(JSObject *obj) {
+  if (!obj || JS::GetClass(obj) != &RouterObject::class_) return nullptr;
+  JS::Value v = JS::GetReservedSlot(obj, static_cast<uint32_t>(RouterObject::Slot::Tree));
+  if (v.isUndefined()) return nullptr;
+  return static_cast<RouteTree *>(v.toPrivate());
+}
+
+RouteTree *this_tree(JSContext *cx, JS::CallArgs &args, const char *fn_name) {
+  RouteTree *tree = args.thisv().isObject() ? route_tree(&args.thisv().toObject()) : nullptr;
+  if (!tree) JS_ReportErrorUTF8(cx, "%s: receiver must be a Router", fn_name);
+  return tree;
+}
+
+void RouterObject::finalize(JS::GCContext *gcx, JSObject *obj) {
+  delete route_tree(obj);
+}
+
+bool RouterObject::compile(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "Router.compile", 1)) return false;
+
+  bool is_array = false;
+  if (!JS::IsArrayObject(cx, args[0], &is_array)) return false;
+  if (!is_array) {
+    JS_ReportErrorUTF8(cx, "Router.compile: routes must be an array");
+    return false;
+  }
+  JS::RootedObject defs(cx, &args[0].toObject());
+  uint32_t len;
+  if (!JS::GetArrayLength(cx, defs, &len)) return false;
+
+  auto tree = std::make_unique<RouteTree>();
+  JS::RootedValue def(cx);
+  std::string method;
+  std::string path;
+  for (uint32_t i = 0; i < len; i++) {
+    if (!JS_GetElement(cx, defs, i, &def)) return false;
+    if (!read_route(cx, def, i, &method, &path)) return false;
+    if (const char *error = tree->add(method, path)) {
+      JS_ReportErrorUTF8(cx, "Router.compile: route %u ('%s'): %s", i, path.c_str(), error);
+      return false;
+    }
+  }
+
+  JS::RootedObject proto(cx, *ROUTER_PROTO);
+  JS::RootedObject obj(cx, JS_NewObjectWithGivenProto(cx, &RouterObject::class_, proto));
+  if (!obj) return false;
+  JS::SetReservedSlot(obj, static_cast<uint32_t>(Slot::Tree), JS::PrivateValue(tree.release()));
+
+  args.rval().setObject(*obj);
+  return true;
+}
+
+bool RouterObject::match(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  RouteTree *tree = this_tree(cx, args, "Router.match");
+  if (!tree) return false;
+  if (!args.requireAtLeast(cx, "Router.match", 2)) return false;
+
+  auto method_chars = core::encode(cx, args[0]);
+  if (!method_chars) return false;
+  auto target_chars = core::encode(cx, args[1]);
+  if (!target_chars) return false;
+
+  std::string method = upper_ascii(std::string_view(method_chars.ptr.get(), method_chars.len));
+  std::string_view path =
+      request_path(std::string_view(target_chars.ptr.get(), target_chars.len));
+
+  RouteTree::Match found;
+  if (!tree->match(method, path, &found)) {
+    args.rval().setNull();
+    return true;
+  }
+
+  const Route &route = tree->route(found.route);
+  JS::RootedObject params(cx, JS_NewPlainObject(cx));
+  if (!params) return false;
+  std::string scratch;
+  for (size_t i = 0; i < route.param_names.size(); i++) {
+    if (!define_param(cx, params, route.param_names[i], found.params[i], &scratch)) {
+      return false;
+    }
+  }
+  if (route.wildcard && !define_param(cx, params, "*", found.rest, &scratch)) {
+    return false;
+  }
+
+  JS::RootedObject result(cx, JS_NewPlainObject(cx));
+  if (!result) return false;
+  JS::RootedValue index_val(cx, JS::NumberValue(found.route));
+  JS::RootedValue params_val(cx, JS::ObjectValue(*params));
+  if (!JS_DefineProperty(cx, result, "index", index_val, JSPROP_ENUMERATE) ||
+      !JS_DefineProperty(cx, result, "params", params_val, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  args.rval().setObject(*result);
+  return true;
+}
+
+bool RouterObject::size_get(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  RouteTree *tree = this_tree(cx, args, "Router.size");
+  if (!tree) return false;
+  args.rval().setNumber(static_cast<double>(tree->size()));
+  return true;
+}
+
+const JSFunctionSpec router_static_methods[] = {
+    JS_FN("compile", RouterObject::compile, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+}  // namespace
+
+bool install(api::Engine *engine) {
+  JSContext *cx = engine->cx();
+
+  JS::RootedObject proto(cx, JS_NewPlainObject(cx));
+  if (!proto) return false;
+  if (!JS_DefineFunctions(cx, proto, RouterObject::methods) ||
+      !JS_DefineProperties(cx, proto, RouterObject::properties)) {
+    return false;
+  }
+  ROUTER_PROTO = new JS::PersistentRooted<JSObject *>(cx, proto);
+
+  JS::RootedObject router_obj(cx, JS_NewPlainObject(cx));
+  if (!router_obj) return false;
+  if (!JS_DefineFunctions(cx, router_obj, router_static_methods)) return false;
+
+  // `fastedge` is installed by the fastedge builtin, which is registered
+  // before this one.
+  JS::RootedValue fastedge_val(cx);
+  if (!JS_GetProperty(cx, engine->global(), "fastedge", &fastedge_val)) return false;
+  if (!fastedge_val.isObject()) {
+    JS_ReportErrorUTF8(cx, "router.install: globalThis.fastedge is missing");
+    return false;
+  }
+  JS::RootedObject fastedge(cx, &fastedge_val.toObject());
+  if (!JS_DefineProperty(cx, fastedge, "Router", router_obj, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace fastedge::router
@@ -0,0 +1,791 @@
+#include "value-decode.h"
+#include "encode.h"
+
+#include <js/Array.h>
+#include <js/ArrayBuffer.h>
+#include <js/BigInt.h>
+#include <js/CharacterEncoding.h>
+#include <js/Date.h>
+
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace fastedge::value_decode {
+
+namespace {
+
+api::Engine *ENGINE;
+
+// Nesting limit for arrays / maps / tags. Keeps hostile input from
+// exhausting the native stack.
+constexpr uint32_t MAX_DEPTH = 256;
+
+// Largest integer a JS number represents exactly. Wider 64-bit integers
+// decode to BigInt.
+constexpr uint64_t MAX_SAFE_INTEGER = (uint64_t(1) << 53) - 1;
+
+JSString *new_string(JSContext *cx, const uint8_t *bytes, size_t len) {
+  // ASCII is valid Latin-1, which skips UTF-8 validation and inflation.
+  bool ascii = true;
+  for (size_t i = 0; i < len; i++) {
+    if (bytes[i] & 0x80) {
+      ascii = false;
+      break;
+    }
+  }
+  if (ascii) {
+    return JS_NewStringCopyN(cx, reinterpret_cast<const char *>(bytes), len);
+  }
+  return JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(reinterpret_cast<const char *>(bytes), len));
+}
+
+JSObject *new_bytes(JSContext *cx, const uint8_t *bytes, size_t len) {
+  JS::RootedObject byte_array(cx, JS_NewUint8Array(cx, len));
+  if (!byte_array) return nullptr;
+
+  if (len > 0) {
+    JS::AutoCheckCannotGC noGC(cx);
+    bool is_shared;
+    void *dst = JS_GetArrayBufferViewData(byte_array, &is_shared, noGC);
+    memcpy(dst, bytes, len);
+  }
+  return byte_array;
+}
+
+bool set_uint(JSContext *cx, uint64_t n, JS::MutableHandleValue out) {
+  if (n <= MAX_SAFE_INTEGER) {
+    out.setNumber(static_cast<double>(n));
+    return true;
+  }
+  JS::BigInt *big = JS::BigIntFromUint64(cx, n);
+  if (!big) return false;
+  out.setBigInt(big);
+  return true;
+}
+
+bool set_int(JSContext *cx, int64_t n, JS::MutableHandleValue out) {
+  if (n >= -static_cast<int64_t>(MAX_SAFE_INTEGER) && n <= static_cast<int64_t>(MAX_SAFE_INTEGER)) {
+    out.setNumber(static_cast<double>(n));
+    return true;
+  }
+  JS::BigInt *big = JS::BigIntFromInt64(cx, n);
+  if (!big) return false;
+  out.setBigInt(big);
+  return true;
+}
+
+bool set_date(JSContext *cx, double ms, JS::MutableHandleValue out) {
+  JSObject *date = JS::NewDateObject(cx, JS::TimeClip(ms));
+  if (!date) return false;
+  out.setObject(*date);
+  return true;
+}
+
+double half_to_double(uint16_t half) {
+  int exp = (half >> 10) & 0x1f;
+  int mant = half & 0x3ff;
+  double val;
+  if (exp == 0) {
+    val = std::ldexp(mant, -24);
+  } else if (exp != 31) {
+    val = std::ldexp(mant + 1024, exp - 25);
+  } else {
+    val = mant == 0 ? INFINITY : NAN;
+  }
+  return (half & 0x8000) ? -val : val;
+}
+
+// Shared cursor and JS construction for both formats. Every read is
+// bounds-checked; the first failure reports an error naming the format.
+class Reader {
+public:
+  Reader(JSContext *cx, const char *format_name, const uint8_t *bytes, size_t len)
+      : cx_(cx), format_name_(format_name), pos_(bytes), end_(bytes + len) {}
+
+  size_t remaining() const { return end_ - pos_; }
+  bool at_end() const { return pos_ == end_; }
+
+  bool fail(const char *what) {
+    JS_ReportErrorUTF8(cx_, "%s decode error: %s", format_name_, what);
+    return false;
+  }
+
+  bool read_u8(uint8_t *out) {
+    if (pos_ == end_) return fail("unexpected end of input");
+    *out = *pos_++;
+    return true;
+  }
+
+  bool peek_u8(uint8_t *out) {
+    if (pos_ == end_) return fail("unexpected end of input");
+    *out = *pos_;
+    return true;
+  }
+
+  // Read an `n`-byte big-endian unsigned integer.
+  bool read_be(size_t n, uint64_t *out) {
+    if (remaining() < n) return fail("unexpected end of input");
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; i++) {
+      v = (v << 8) | pos_[i];
+    }
+    pos_ += n;
+    *out = v;
+    return true;
+  }
+
+  bool read_f32(double *out) {
+    uint64_t bits;
+    if (!read_be(4, &bits)) return false;
+    uint32_t raw = static_cast<uint32_t>(bits);
+    float f;
+    memcpy(&f, &raw, sizeof f);
+    *out = f;
+    return true;
+  }
+
+  bool read_f64(double *out) {
+    uint64_t bits;
+    if (!read_be(8, &bits)) return false;
+    memcpy(out, &bits, sizeof *out);
+    return true;
+  }
+
+  // Borrow `n` raw bytes from the input.
+  bool take(uint64_t n, const uint8_t **out) {
+    if (n > remaining()) return fail("unexpected end of input");
+    *out = pos_;
+    pos_ += n;
+    return true;
+  }
+
+  bool string(uint64_t n, JS::MutableHandleValue out) {
+    const uint8_t *bytes;
+    if (!take(n, &bytes)) return false;
+    JSString *str = new_string(cx_, bytes, n);
+    if (!str) return false;
+    out.setString(str);
+    return true;
+  }
+
+  bool bytes(uint64_t n, JS::MutableHandleValue out) {
+    const uint8_t *data;
+    if (!take(n, &data)) return false;
+    JSObject *arr = new_bytes(cx_, data, n);
+    if (!arr) return false;
+    out.setObject(*arr);
+    return true;
+  }
+
+  // Reject container lengths that cannot possibly fit in what is left of
+  // the input (every item takes at least `min_item_size` bytes) before
+  // allocating anything for them.
+  bool check_count(uint64_t count, size_t min_item_size) {
+    if (count > remaining() / min_item_size) return fail("unexpected end of input");
+    return true;
+  }
+
+  bool enter() {
+    if (++depth_ > MAX_DEPTH) return fail("nesting too deep");
+    return true;
+  }
+  void leave() { depth_--; }
+
+  // Define `value` on `obj` under a decoded map key. Only string and number
+  // keys map onto JS property keys.
+  bool define_entry(JS::HandleObject obj, JS::HandleValue key, JS::HandleValue value) {
+    if (!key.isString() && !key.isNumber()) {
+      return fail("map keys must be strings or numbers");
+    }
+    JS::RootedId id(cx_);
+    if (!JS_ValueToId(cx_, key, &id)) return false;
+    return JS_DefinePropertyById(cx_, obj, id, value, JSPROP_ENUMERATE);
+  }
+
+  JSContext *cx() const { return cx_; }
+
+private:
+  JSContext *cx_;
+  const char *format_name_;
+  const uint8_t *pos_;
+  const uint8_t *end_;
+  uint32_t depth_ = 0;
+};
+
+// MessagePack (https://github.com/msgpack/msgpack/blob/master/spec.md).
+// Extension type -1 (timestamp) decodes to a Date; other extensions are
+// rejected.
+class MsgPackDecoder {
+public:
+  explicit MsgPackDecoder(Reader &r) : r_(r) {}
+
+  bool value(JS::MutableHandleValue out) {
+    uint8_t b;
+    if (!r_.read_u8(&b)) return false;
+
+    if (b <= 0x7f) {
+      out.setInt32(b);
+      return true;
+    }
+    if (b >= 0xe0) {
+      out.setInt32(static_cast<int8_t>(b));
+      return true;
+    }
+    if (b >= 0x80 && b <= 0x8f) return map(b & 0x0f, out);
+    if (b >= 0x90 && b <= 0x9f) return array(b & 0x0f, out);
+    if (b >= 0xa0 && b <= 0xbf) return r_.string(b & 0x1f, out);
+
+    uint64_t n;
+    double d;
+    switch (b) {
+      case 0xc0:
+        out.setNull();
+        return true;
+      case 0xc2:
+        out.setBoolean(false);
+        return true;
+      case 0xc3:
+        out.setBoolean(true);
+        return true;
+      case 0xc4:
+      case 0xc5:
+      case 0xc6:
+        return r_.read_be(size_t(1) << (b - 0xc4), &n) && r_.bytes(n, out);
+      case 0xc7:
+      case 0xc8:
+      case 0xc9:
+        return r_.read_be(size_t(1) << (b - 0xc7), &n) && ext(n, out);
+      case 0xca:
+        if (!r_.read_f32(&d)) return false;
+        out.setDouble(d);
+        return true;
+      case 0xcb:
+        if (!r_.read_f64(&d)) return false;
+        out.setDouble(d);
+        return true;
+      case 0xcc:
+      case 0xcd:
+      case 0xce:
+      case 0xcf:
+        return r_.read_be(size_t(1) << (b - 0xcc), &n) && set_uint(r_.cx(), n, out);
+      case 0xd0:
+      case 0xd1:
+      case 0xd2:
+      case 0xd3: {
+        size_t width = size_t(1) << (b - 0xd0);
+        if (!r_.read_be(width, &n)) return false;
+        // Sign-extend from `width` bytes.
+        unsigned shift = 64 - 8 * width;
+        int64_t v = static_cast<int64_t>(n << shift) >> shift;
+        return set_int(r_.cx(), v, out);
+      }
+      case 0xd4:
+      case 0xd5:
+      case 0xd6:
+      case 0xd7:
+      case 0xd8:
+        return ext(uint64_t(1) << (b - 0xd4), out);
+      case 0xd9:
+      case 0xda:
+      case 0xdb:
+        return r_.read_be(size_t(1) << (b - 0xd9), &n) && r_.string(n, out);
+      case 0xdc:
+      case 0xdd:
+        return r_.read_be(b == 0xdc ? 2 : 4, &n) && array(n, out);
+      case 0xde:
+      case 0xdf:
+        return r_.read_be(b == 0xde ? 2 : 4, &n) && map(n, out);
+      default:
+        return r_.fail("invalid type byte 0xc1");
+    }
+  }
+
+private:
+  Reader &r_;
+
+  bool array(uint64_t count, JS::MutableHandleValue out) {
+    if (!r_.check_count(count, 1) || !r_.enter()) return false;
+
+    JSContext *cx = r_.cx();
+    JS::RootedObject arr(cx, JS::NewArrayObject(cx, count));
+    if (!arr) return false;
+
+    JS::RootedValue item(cx);
+    for (uint64_t i = 0; i < count; i++) {
+      if (!value(&item)) return false;
+      if (!JS_DefineElement(cx, arr, static_cast<uint32_t>(i), item, JSPROP_ENUMERATE)) {
+        return false;
+      }
+    }
+
+    r_.leave();
+    out.setObject(*arr);
+    return true;
+  }
+
+  bool map(uint64_t count, JS::MutableHandleValue out) {
+    if (!r_.check_count(count, 2) || !r_.enter()) return false;
+
+    JSContext *cx = r_.cx();
+    JS::RootedObject obj(cx, JS_NewPlainObject(cx));
+    if (!obj) return false;
+
+    JS::RootedValue key(cx);
+    JS::RootedValue item(cx);
+    for (uint64_t i = 0; i < count; i++) {
+      if (!value(&key) || !value(&item)) return false;
+      if (!r_.define_entry(obj, key, item)) return false;
+    }
+
+    r_.leave();
+    out.setObject(*obj);
+    return true;
+  }
+
+  bool ext(uint64_t len, JS::MutableHandleValue out) {
+    uint8_t type;
+    if (!r_.read_u8(&type)) return false;
+    const uint8_t *data;
+    if (!r_.take(len, &data)) return false;
+
+    if (static_cast<int8_t>(type) != -1) {
+      return r_.fail("unsupported extension type");
+    }
+
+    // Timestamp: 32-bit seconds, 30-bit nanos + 34-bit seconds, or
+    // 32-bit nanos + signed 64-bit seconds.
+    Reader ts(r_.cx(), "msgpack", data, len);
+    uint64_t secs = 0;
+    uint64_t nanos = 0;
+    double seconds;
+    if (len == 4) {
+      if (!ts.read_be(4, &secs)) return false;
+      seconds = static_cast<double>(secs);
+    } else if (len == 8) {
+      uint64_t packed;
+      if (!ts.read_be(8, &packed)) return false;
+      nanos = packed >> 34;
+      seconds = static_cast<double>(packed & ((uint64_t(1) << 34) - 1));
+    } else if (len == 12) {
+      if (!ts.read_be(4, &nanos) || !ts.read_be(8, &secs)) return false;
+      seconds = static_cast<double>(static_cast<int64_t>(secs));
+    } else {
+      return r_.fail("invalid timestamp length");
+    }
+    return set_date(r_.cx(), seconds * 1000 + static_cast<double>(nanos) / 1e6, out);
+  }
+};
+
+// CBOR (RFC 8949). Tag 1 (epoch time) decodes to a Date and tags 2/3
+// (bignums) up to 64 bits decode to BigInt; other tags decode to their
+// content.
+class CborDecoder {
+public:
+  explicit CborDecoder(Reader &r) : r_(r) {}
+
+  bool value(JS::MutableHandleValue out) {
+    uint8_t b;
+    if (!r_.read_u8(&b)) return false;
+
+    uint8_t major = b >> 5;
+    uint8_t info = b & 0x1f;
+
+    if (major == 7) return simple(info, out);
+
+    if (info == 31) {
+      switch (major) {
+        case 2:
+        case 3:
+          return indefinite_string(major, out);
+        case 4:
+          return indefinite_array(out);
+        case 5:
+          return indefinite_map(out);
+        default:
+          return r_.fail("invalid indefinite-length item");
+      }
+    }
+
+    uint64_t arg;
+    if (!argument(info, &arg)) return false;
+
+    switch (major) {
+      case 0:
+        return set_uint(r_.cx(), arg, out);
+      case 1:
+        if (arg > static_cast<uint64_t>(INT64_MAX)) {
+          return r_.fail("negative integer out of range");
+        }
+        return set_int(r_.cx(), -1 - static_cast<int64_t>(arg), out);
+      case 2:
+        return r_.bytes(arg, out);
+      case 3:
+        return r_.string(arg, out);
+      case 4:
+        return array(arg, out);
+      case 5:
+        return map(arg, out);
+      default:
+        return tag(arg, out);
+    }
+  }
+
+private:
+  Reader &r_;
+
+  bool argument(uint8_t info, uint64_t *out) {
+    if (info < 24) {
+      *out = info;
+      return true;
+    }
+    if (info <= 27) {
+      return r_.read_be(size_t(1) << (info - 24), out);
+    }
+    return r_.fail("invalid additional information");
+  }
+
+  // Consume the 0xff "break" stop code if it is next.
+  bool read_break(bool *found) {
+    uint8_t b;
+    if (!r_.peek_u8(&b)) return false;
+    *found = b == 0xff;
+    if (*found) r_.read_u8(&b);
+    return true;
+  }
+
+  bool simple(uint8_t info, JS::MutableHandleValue out) {
+    uint64_t bits;
+    double d;
+    switch (info) {
+      case 20:
+        out.setBoolean(false);
+        return true;
+      case 21:
+        out.setBoolean(true);
+        return true;
+      case 22:
+        out.setNull();
+        return true;
+      case 23:
+        out.setUndefined();
+        return true;
+      case 25:
+        if (!r_.read_be(2, &bits)) return false;
+        out.setDouble(half_to_double(static_cast<uint16_t>(bits)));
+        return true;
+      case 26:
+        if (!r_.read_f32(&d)) return false;
+        out.setDouble(d);
+        return true;
+      case 27:
+        if (!r_.read_f64(&d)) return false;
+        out.setDouble(d);
+        return true;
+      case 31:
+        return r_.fail("unexpected break");
+      default:
+        return r_.fail("unsupported simple value");
+    }
+  }
+
+  bool array(uint64_t count, JS::MutableHandleValue out) {
+    if (!r_.check_count(count, 1) || !r_.enter()) return false;
+
+    JSContext *cx = r_.cx();
+    JS::RootedObject arr(cx, JS::NewArrayObject(cx, count));
+    if (!arr) return false;
+
+    JS::RootedValue item(cx);
+    for (uint64_t i = 0; i < count; i++) {
+      if (!value(&item)) return false;
+      if (!JS_DefineElement(cx, arr, static_cast<uint32_t>(i), item, JSPROP_ENUMERATE)) {
+        return false;
+      }
+    }
+
+    r_.leave();
+    out.setObject(*arr);
+    return true;
+  }
+
+  bool map(uint64_t count, JS::MutableHandleValue out) {
+    if (!r_.check_count(count, 2) || !r_.enter()) return false;
+
+    JSContext *cx = r_.cx();
+    JS::RootedObject obj(cx, JS_NewPlainObject(cx));
+    if (!obj) return false;
+
+    JS::RootedValue key(cx);
+    JS::RootedValue item(cx);
+    for (uint64_t i = 0; i < count; i++) {
+      if (!value(&key) || !value(&item)) return false;
+      if (!r_.define_entry(obj, key, item)) return false;
+    }
+
+    r_.leave();
+    out.setObject(*obj);
+    return true;
+  }
+
+  bool indefinite_array(JS::MutableHandleValue out) {
+    if (!r_.enter()) return false;
+
+    JSContext *cx = r_.cx();
+    JS::RootedObject arr(cx, JS::NewArrayObject(cx, 0));
+    if (!arr) return false;
+
+    JS::RootedValue item(cx);
+    uint32_t i = 0;
+    while (true) {
+      bool done;
+      if (!read_break(&done)) return false;
+      if (done) break;
+      if (!value(&item)) return false;
+      if (!JS_DefineElement(cx, arr, i++, item, JSPROP_ENUMERATE)) return false;
+    }
+
+    r_.leave();
+    out.setObject(*arr);
+    return true;
+  }
+
+  bool indefinite_map(JS::MutableHandleValue out) {
+    if (!r_.enter()) return false;
+
+    JSContext *cx = r_.cx();
+    JS::RootedObject obj(cx, JS_NewPlainObject(cx));
+    if (!obj) return false;
+
+    JS::RootedValue key(cx);
+    JS::RootedValue item(cx);
+    while (true) {
+      bool done;
+      if (!read_break(&done)) return false;
+      if (done) break;
+      if (!value(&key) || !value(&item)) return false;
+      if (!r_.define_entry(obj, key, item)) return false;
+    }
+
+    r_.leave();
+    out.setObject(*obj);
+    return true;
+  }
+
+  // Concatenate the definite-length chunks of an indefinite byte or text
+  // string, then materialise it once.
+  bool indefinite_string(uint8_t major, JS::MutableHandleValue out) {
+    std::vector<uint8_t> buf;
+    while (true) {
+      bool done;
+      if (!read_break(&done)) return false;
+      if (done) break;
+
+      uint8_t b;
+      r_.read_u8(&b);
+      if ((b >> 5) != major || (b & 0x1f) == 31) {
+        return r_.fail("invalid chunk in indefinite-length string");
+      }
+      uint64_t n;
+      const uint8_t *chunk;
+      if (!argument(b & 0x1f, &n) || !r_.take(n, &chunk)) return false;
+      buf.insert(buf.end(), chunk, chunk + n);
+    }
+
+    JSContext *cx = r_.cx();
+    if (major == 2) {
+      JSObject *arr = new_bytes(cx, buf.data(), buf.size());
+      if (!arr) return false;
+      out.setObject(*arr);
+    } else {
+      JSString *str = new_string(cx, buf.data(), buf.size());
+      if (!str) return false;
+      out.setString(str);
+    }
+    return true;
+  }
+
+  bool tag(uint64_t number, JS::MutableHandleValue out) {
+    if (!r_.enter()) return false;
+    if (!value(out)) return false;
+    r_.leave();
+
+    JSContext *cx = r_.cx();
+    switch (number) {
+      case 1:
+        if (!out.isNumber()) {
+          return r_.fail("epoch time tag must wrap a number");
+        }
+        return set_date(cx, out.toNumber() * 1000, out);
+      case 2:
+      case 3: {
+        if (!out.isObject() || !JS_IsUint8Array(&out.toObject())) {
+          return r_.fail("bignum tag must wrap a byte string");
+        }
+        uint64_t n = 0;
+        {
+          JS::AutoCheckCannotGC noGC(cx);
+          JSObject *arr = &out.toObject();
+          size_t len = JS_GetTypedArrayLength(arr);
+          bool is_shared;
+          const uint8_t *data =
+              static_cast<const uint8_t *>(JS_GetArrayBufferViewData(arr, &is_shared, noGC));
+          size_t skip = 0;
+          while (skip < len && data[skip] == 0) skip++;
+          if (len - skip > 8) {
+            return r_.fail("bignum wider than 64 bits");
+          }
+          for (size_t i = skip; i < len; i++) {
+            n = (n << 8) | data[i];
+          }
+        }
+        if (number == 2) {
+          JS::BigInt *big = JS::BigIntFromUint64(cx, n);
+          if (!big) return false;
+          out.setBigInt(big);
+          return true;
+        }
+        if (n > static_cast<uint64_t>(INT64_MAX)) {
+          return r_.fail("bignum wider than 64 bits");
+        }
+        JS::BigInt *big = JS::BigIntFromInt64(cx, -1 - static_cast<int64_t>(n));
+        if (!big) return false;
+        out.setBigInt(big);
+        return true;
+      }
+      default:
+        return true;
+    }
+  }
+};
+
+// Copy the contents of an ArrayBuffer or ArrayBufferView into `out`.
+// The copy keeps the input stable while the decoder allocates JS objects.
+bool read_input_bytes(JSContext *cx, JS::HandleValue value, const char *fn_name,
+                      std::vector<uint8_t> *out) {
+  if (value.isObject()) {
+    JS::RootedObject obj(cx, &value.toObject());
+
+    if (JS::IsArrayBufferObject(obj)) {
+      size_t len = JS::GetArrayBufferByteLength(obj);
+      out->resize(len);
+      if (len > 0) {
+        JS::AutoCheckCannotGC noGC(cx);
+        bool is_shared;
+        void *src = JS::GetArrayBufferData(obj, &is_shared, noGC);
+        memcpy(out->data(), src, len);
+      }
+      return true;
+    }
+
+    if (JS_IsArrayBufferViewObject(obj)) {
+      size_t len = JS_GetArrayBufferViewByteLength(obj);
+      out->resize(len);
+      if (len > 0) {
+        JS::AutoCheckCannotGC noGC(cx);
+        bool is_shared;
+        void *src = JS_GetArrayBufferViewData(obj, &is_shared, noGC);
+        memcpy(out->data(), src, len);
+      }
+      return true;
+    }
+  }
+
+  JS_ReportErrorUTF8(cx, "%s: expected an ArrayBuffer or ArrayBufferView", fn_name);
+  return false;
+}
+
+bool decode_input(JSContext *cx, JS::CallArgs &args, const char *fn_name, Format format) {
+  std::vector<uint8_t> bytes;
+  if (!read_input_bytes(cx, args[0], fn_name, &bytes)) return false;
+  return decode(cx, format, bytes.data(), bytes.size(), args.rval());
+}
+
+bool decode_msgpack(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "Codec.decodeMsgpack", 1)) return false;
+  return decode_input(cx, args, "Codec.decodeMsgpack", Format::MsgPack);
+}
+
+bool decode_cbor(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "Codec.decodeCbor", 1)) return false;
+  return decode_input(cx, args, "Codec.decodeCbor", Format::Cbor);
+}
+
+bool decode_any(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  if (!args.requireAtLeast(cx, "Codec.decode", 2)) return false;
+
+  Format format;
+  if (!read_format(cx, args[1], "Codec.decode", &format)) return false;
+  return decode_input(cx, args, "Codec.decode", format);
+}
+
+const JSFunctionSpec codec_methods[] = {
+    JS_FN("decode", decode_any, 2, JSPROP_ENUMERATE),
+    JS_FN("decodeMsgpack", decode_msgpack, 1, JSPROP_ENUMERATE),
+    JS_FN("decodeCbor", decode_cbor, 1, JSPROP_ENUMERATE),
+    JS_FS_END,
+};
+
+}  // namespace
+
+bool read_format(JSContext *cx, JS::HandleValue value, const char *fn_name, Format *out) {
+  if (value.isString()) {
+    auto name = core::encode(cx, value);
+    if (!name) return false;
+
+    std::string_view sv(name.ptr.get(), name.len);
+    if (sv == "msgpack") {
+      *out = Format::MsgPack;
+      return true;
+    }
+    if (sv == "cbor") {
+      *out = Format::Cbor;
+      return true;
+    }
+  }
+
+  JS_ReportErrorUTF8(cx, "%s: format must be 'msgpack' or 'cbor'", fn_name);
+  return false;
+}
+
+bool decode(JSContext *cx, Format format, const uint8_t *bytes, size_t len,
+            JS::MutableHandleValue out) {
+  const char *name = format == Format::MsgPack ? "msgpack" : "cbor";
+  Reader reader(cx, name, bytes, len);
+
+  if (format == Format::MsgPack) {
+    MsgPackDecoder decoder(reader);
+    if (!decoder.value(out)) return false;
+  } else {
+    CborDecoder decoder(reader);
+    if (!decoder.value(out)) return false;
+  }
+
+  if (!reader.at_end()) {
+    return reader.fail("trailing bytes after value");
+  }
+  return true;
+}
+
+bool install(api::Engine *engine) {
+  ENGINE = engine;
+
+  JS::RootedObject codec_obj(engine->cx(), JS_NewPlainObject(engine->cx()));
+  if (!codec_obj) return false;
+
+  if (!JS_DefineFunctions(engine->cx(), codec_obj, codec_methods)) {
+    return false;
+  }
+
+  if (!JS_DefineProperty(engine->cx(), engine->global(), "Codec", codec_obj, 0)) {
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace fastedge::value_decode
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "builtin.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fastedge::value_decode {
+
+// Binary serialisation formats understood by the native decoder.
+enum class Format {
+  MsgPack,
+  Cbor,
+};
+
+// Read a format name ('msgpack' | 'cbor') from `value`. Reports a TypeError
+// naming `fn_name` and returns false on anything else.
+bool read_format(JSContext *cx, JS::HandleValue value, const char *fn_name, Format *out);
+
+// Decode one complete `format` document from `bytes` straight into JS
+// values. Trailing bytes, truncated input and unsupported types report an
+// error and return false. `bytes` must stay valid for the duration of the
+// call but is never retained.
+bool decode(JSContext *cx, Format format, const uint8_t *bytes, size_t len,
+            JS::MutableHandleValue out);
+
+} // namespace fastedge::value_decode
@@ -1,7 +1,13 @@
 #include "fastedge_host_api.h"
 
 #include "bindings/bindings.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <vector>
+
+bool debug_logging_enabled();
 
 namespace host_api {
 
@@ -21,8 +27,179 @@ namespace host_api {
     }
 
     auto string_view_to_world_string = from_string_view<bindings_string_t>;
+
+    // A host-allocated result buffer recorded by the arena.
+    struct Allocation {
+      enum class Kind : uint8_t { Bytes, StringList, ZList };
+
+      Kind kind;
+      void *ptr;
+      size_t len;
+      size_t bytes;
+    };
+
+    // Cumulative byte counts for host-allocated result buffers.
+    struct HostArenaStats {
+      // Freed by a HostArenaScope.
+      uint64_t reclaimed_bytes = 0;
+      // Handed over to a builtin via host_arena_detach.
+      uint64_t detached_bytes = 0;
+      // Tracked but not yet freed. Non-zero outside any scope means a wrapper
+      // was called without a HostArenaScope and its buffers have leaked.
+      uint64_t outstanding_bytes = 0;
+      // `outstanding_bytes` when the last leak was reported, so each leak is
+      // reported once rather than at every later scope exit.
+      uint64_t reported_bytes = 0;
+    };
+
+    std::vector<Allocation> ARENA;
+    size_t SCOPE_DEPTH = 0;
+    HostArenaStats STATS;
+
+    void free_allocation(const Allocation &alloc) {
+      switch (alloc.kind) {
+        case Allocation::Kind::Bytes:
+          free(alloc.ptr);
+          break;
+        case Allocation::Kind::StringList: {
+          bindings_list_string_t list{static_cast<bindings_string_t *>(alloc.ptr), alloc.len};
+          bindings_list_string_free(&list);
+          break;
+        }
+        case Allocation::Kind::ZList: {
+          bindings_list_tuple2_value_f64_t list{static_cast<bindings_tuple2_value_f64_t *>(alloc.ptr), alloc.len};
+          bindings_list_tuple2_value_f64_free(&list);
+          break;
+        }
+      }
+    }
+
+    void track(Allocation alloc) {
+      // Zero-length canonical-ABI lists and strings are not heap allocated.
+      if (!alloc.ptr || alloc.len == 0) {
+        return;
+      }
+      STATS.outstanding_bytes += alloc.bytes;
+      ARENA.push_back(alloc);
+    }
+
+    void track_bytes(uint8_t *ptr, size_t len) {
+      track({Allocation::Kind::Bytes, ptr, len, len});
+    }
+
+    void track_string_list(const bindings_list_string_t &list) {
+      size_t bytes = list.len * sizeof(bindings_string_t);
+      for (size_t i = 0; i < list.len; i++) {
+        bytes += list.ptr[i].len;
+      }
+      track({Allocation::Kind::StringList, list.ptr, list.len, bytes});
+    }
+
+    void track_zlist(const bindings_list_tuple2_value_f64_t &list) {
+      size_t bytes = list.len * sizeof(bindings_tuple2_value_f64_t);
+      for (size_t i = 0; i < list.len; i++) {
+        bytes += list.ptr[i].f0.len;
+      }
+      track({Allocation::Kind::ZList, list.ptr, list.len, bytes});
+    }
+
+    template <typename E> void track_error(const E &err, uint8_t other_tag) {
+      if (err.tag == other_tag) {
+        track_bytes(err.val.other.ptr, err.val.other.len);
+      }
+    }
+
+    // Narrow an ascending zrange-by-score result in place to what `options`
+    // asks for. Dropped members are freed; kept members are moved to the
+    // front of the same allocation so the list can still be freed normally.
+    //
+    // The key-value WIT has no LIMIT / REV / exclusive-bound parameters, so
+    // this runs guest-side on the full host result.
+    void apply_zrange_options(bindings_list_tuple2_value_f64_t &list, double min, double max,
+                              const KvStoreZRangeOptions &options) {
+      // An empty canonical-ABI list is not heap allocated (`cabi_realloc`
+      // returns the alignment as its pointer); there is nothing to narrow
+      // and its pointer must never reach `free`.
+      if (list.len == 0) {
+        return;
+      }
+
+      size_t lo = 0;
+      size_t hi = list.len;
+      if (options.min_exclusive) {
+        while (lo < hi && list.ptr[lo].f1 <= min) lo++;
+      }
+      if (options.max_exclusive) {
+        while (hi > lo && list.ptr[hi - 1].f1 >= max) hi--;
+      }
+
+      size_t available = hi - lo;
+      size_t skip = std::min(options.offset, available);
+      size_t take = std::min(options.count.value_or(available), available - skip);
+      size_t first = options.reverse ? hi - skip - take : lo + skip;
+      size_t last = first + take;
+
+      for (size_t i = 0; i < list.len; i++) {
+        if (i < first || i >= last) {
+          bindings_tuple2_value_f64_free(&list.ptr[i]);
+        }
+      }
+      if (options.reverse) {
+        std::reverse(list.ptr + first, list.ptr + last);
+      }
+      if (first > 0 && take > 0) {
+        memmove(list.ptr, list.ptr + first, take * sizeof(*list.ptr));
+      }
+      if (take == 0) {
+        // The original list was non-empty, so its storage came from malloc.
+        free(list.ptr);
+        list.ptr = nullptr;
+      }
+      list.len = take;
+    }
   } // namespace
 
+// Host allocation arena
+
+HostArenaScope::HostArenaScope() : mark_(ARENA.size()) {
+  SCOPE_DEPTH++;
+}
+
+HostArenaScope::~HostArenaScope() {
+  uint64_t reclaimed = 0;
+  for (size_t i = mark_; i < ARENA.size(); i++) {
+    const Allocation &alloc = ARENA[i];
+    if (alloc.ptr) {
+      free_allocation(alloc);
+      reclaimed += alloc.bytes;
+    }
+  }
+  ARENA.resize(mark_);
+  STATS.outstanding_bytes -= reclaimed;
+  STATS.reclaimed_bytes += reclaimed;
+  SCOPE_DEPTH--;
+
+  if (SCOPE_DEPTH == 0 && STATS.outstanding_bytes > STATS.reported_bytes) {
+    if (debug_logging_enabled()) {
+      fprintf(stderr, "host_api: %llu bytes of host result buffers leaked outside a HostArenaScope\n",
+              static_cast<unsigned long long>(STATS.outstanding_bytes - STATS.reported_bytes));
+    }
+    STATS.reported_bytes = STATS.outstanding_bytes;
+  }
+}
+
+void host_arena_detach(const void *ptr) {
+  for (size_t i = ARENA.size(); i > 0; i--) {
+    Allocation &alloc = ARENA[i - 1];
+    if (alloc.ptr == ptr) {
+      STATS.outstanding_bytes -= alloc.bytes;
+      STATS.detached_bytes += alloc.bytes;
+      alloc.ptr = nullptr;
+      return;
+    }
+  }
+}
+
 // Gcore FastEdge API extensions
 
 /*
@@ -48,26 +225,32 @@ HostString get_env_vars(std::string_view name) {
   return bindings_string_to_host_string(value_str);
 }
 
-HostString get_secret_vars(std::string_view name) {
+HostLookup get_secret_vars(std::string_view name) {
   auto key_str = string_view_to_world_string(name);
   bindings_option_string_t ret{};
-  gcore_fastedge_secret_error_t err;
-  auto has_value = gcore_fastedge_secret_get(&key_str, &ret, &err);
-  if (has_value && ret.is_some) {
-    return bindings_string_to_host_string(ret.val);
+  gcore_fastedge_secret_error_t err{};
+  if (!gcore_fastedge_secret_get(&key_str, &ret, &err)) {
+    track_error(err, GCORE_FASTEDGE_SECRET_ERROR_OTHER);
+    return {nullptr, true};
   }
-  return nullptr;
+  if (!ret.is_some) {
+    return {};
+  }
+  return {bindings_string_to_host_string(ret.val)};
 }
 
-HostString get_secret_vars_effective_at(std::string_view name, uint32_t effective_at) {
+HostLookup get_secret_vars_effective_at(std::string_view name, uint32_t effective_at) {
   auto key_str = string_view_to_world_string(name);
   bindings_option_string_t ret{};
-  gcore_fastedge_secret_error_t err;
-  auto has_value = gcore_fastedge_secret_get_effective_at(&key_str, effective_at, &ret, &err);
-  if (has_value && ret.is_some) {
-    return bindings_string_to_host_string(ret.val);
+  gcore_fastedge_secret_error_t err{};
+  if (!gcore_fastedge_secret_get_effective_at(&key_str, effective_at, &ret, &err)) {
+    track_error(err, GCORE_FASTEDGE_SECRET_ERROR_OTHER);
+    return {nullptr, true};
+  }
+  if (!ret.is_some) {
+    return {};
   }
-  return nullptr;
+  return {bindings_string_to_host_string(ret.val)};
 }
 
 // KV Store implementations
@@ -86,6 +269,7 @@ KvStoreResult<int32_t> kv_store_open(std::string_view name) {
   if (success) {
     return KvStoreResult<int32_t>::ok(store.__handle);
   } else {
+    track_error(err, GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER);
     KvStoreError error;
     error.tag = static_cast<KvStoreErrorTag>(err.tag);
     if (err.tag == GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER) {
@@ -96,6 +280,11 @@ KvStoreResult<int32_t> kv_store_open(std::string_view name) {
   }
 }
 
+void kv_store_close(int32_t store_handle) {
+  gcore_fastedge_key_value_own_store_t store = {store_handle};
+  gcore_fastedge_key_value_store_drop_own(store);
+}
+
 KvStoreResult<KvStoreOption<KvStoreValue>> kv_store_get(int32_t store_handle, std::string_view key) {
   auto key_str = string_view_to_world_string(key);
   gcore_fastedge_key_value_borrow_store_t store = {store_handle};
@@ -106,6 +295,7 @@ KvStoreResult<KvStoreOption<KvStoreValue>> kv_store_get(int32_t store_handle, st
 
   if (success) {
     if (ret.is_some) {
+      track_bytes(ret.val.ptr, ret.val.len);
       KvStoreValue value;
       value.ptr = ret.val.ptr;
       value.len = ret.val.len;
@@ -114,6 +304,7 @@ KvStoreResult<KvStoreOption<KvStoreValue>> kv_store_get(int32_t store_handle, st
       return KvStoreResult<KvStoreOption<KvStoreValue>>::ok(KvStoreOption<KvStoreValue>::none());
     }
   } else {
+    track_error(err, GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER);
     KvStoreError error;
     error.tag = static_cast<KvStoreErrorTag>(err.tag);
     if (err.tag == GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER) {
@@ -133,11 +324,13 @@ KvStoreResult<KvStoreStringList> kv_store_scan(int32_t store_handle, std::string
   bool success = gcore_fastedge_key_value_method_store_scan(store, &pattern_str, &ret, &err);
 
   if (success) {
+    track_string_list(ret);
     KvStoreStringList result;
     result.ptr = reinterpret_cast<HostString*>(ret.ptr);
     result.len = ret.len;
     return KvStoreResult<KvStoreStringList>::ok(result);
   } else {
+    track_error(err, GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER);
     KvStoreError error;
     error.tag = static_cast<KvStoreErrorTag>(err.tag);
     if (err.tag == GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER) {
@@ -148,7 +341,8 @@ KvStoreResult<KvStoreStringList> kv_store_scan(int32_t store_handle, std::string
   }
 }
 
-KvStoreResult<KvStoreZList> kv_store_zrange_by_score(int32_t store_handle, std::string_view key, double min, double max) {
+KvStoreResult<KvStoreZList> kv_store_zrange_by_score(int32_t store_handle, std::string_view key, double min, double max,
+                                                     const KvStoreZRangeOptions &options) {
   auto key_str = string_view_to_world_string(key);
   gcore_fastedge_key_value_borrow_store_t store = {store_handle};
   bindings_list_tuple2_value_f64_t ret{};
@@ -157,11 +351,14 @@ KvStoreResult<KvStoreZList> kv_store_zrange_by_score(int32_t store_handle, std::
   bool success = gcore_fastedge_key_value_method_store_zrange_by_score(store, &key_str, min, max, &ret, &err);
 
   if (success) {
+    apply_zrange_options(ret, min, max, options);
+    track_zlist(ret);
     KvStoreZList result;
     result.ptr = reinterpret_cast<KvStoreTuple*>(ret.ptr);
     result.len = ret.len;
     return KvStoreResult<KvStoreZList>::ok(result);
   } else {
+    track_error(err, GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER);
     KvStoreError error;
     error.tag = static_cast<KvStoreErrorTag>(err.tag);
     if (err.tag == GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER) {
@@ -172,6 +369,23 @@ KvStoreResult<KvStoreZList> kv_store_zrange_by_score(int32_t store_handle, std::
   }
 }
 
+KvStoreResult<std::vector<KvStoreZList>> kv_store_zrange_by_score_many(int32_t store_handle,
+                                                                       const std::vector<std::string_view> &keys,
+                                                                       double min, double max,
+                                                                       const KvStoreZRangeOptions &options) {
+  // No multi-key zrange in the WIT interface; see kv_store_bf_exists_many.
+  std::vector<KvStoreZList> lists;
+  lists.reserve(keys.size());
+  for (std::string_view key : keys) {
+    auto result = kv_store_zrange_by_score(store_handle, key, min, max, options);
+    if (!result.is_ok()) {
+      return KvStoreResult<std::vector<KvStoreZList>>::err(result.unwrap_err());
+    }
+    lists.push_back(result.unwrap());
+  }
+  return KvStoreResult<std::vector<KvStoreZList>>::ok(std::move(lists));
+}
+
 KvStoreResult<KvStoreZList> kv_store_zscan(int32_t store_handle, std::string_view key, std::string_view pattern) {
   auto key_str = string_view_to_world_string(key);
   auto pattern_str = string_view_to_world_string(pattern);
@@ -182,11 +396,13 @@ KvStoreResult<KvStoreZList> kv_store_zscan(int32_t store_handle, std::string_vie
   bool success = gcore_fastedge_key_value_method_store_zscan(store, &key_str, &pattern_str, &ret, &err);
 
   if (success) {
+    track_zlist(ret);
     KvStoreZList result;
     result.ptr = reinterpret_cast<KvStoreTuple*>(ret.ptr);
     result.len = ret.len;
     return KvStoreResult<KvStoreZList>::ok(result);
   } else {
+    track_error(err, GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER);
     KvStoreError error;
     error.tag = static_cast<KvStoreErrorTag>(err.tag);
     if (err.tag == GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER) {
@@ -209,6 +425,7 @@ KvStoreResult<bool> kv_store_bf_exists(int32_t store_handle, std::string_view ke
   if (success) {
     return KvStoreResult<bool>::ok(ret);
   } else {
+    track_error(err, GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER);
     KvStoreError error;
     error.tag = static_cast<KvStoreErrorTag>(err.tag);
     if (err.tag == GCORE_FASTEDGE_KEY_VALUE_ERROR_OTHER) {
@@ -219,10 +436,41 @@ KvStoreResult<bool> kv_store_bf_exists(int32_t store_handle, std::string_view ke
   }
 }
 
+KvStoreResult<std::vector<bool>> kv_store_bf_exists_many(int32_t store_handle, std::string_view key,
+                                                         const std::vector<std::string_view> &items) {
+  // The key-value WIT interface has no batched bf-exists, so the batch is
+  // issued item by item here. Callers still cross into host_api once per
+  // batch, and a batched host call can replace this loop without touching
+  // them.
+  std::vector<bool> found;
+  found.reserve(items.size());
+  for (std::string_view item : items) {
+    auto result = kv_store_bf_exists(store_handle, key, item);
+    if (!result.is_ok()) {
+      return KvStoreResult<std::vector<bool>>::err(result.unwrap_err());
+    }
+    found.push_back(result.unwrap());
+  }
+  return KvStoreResult<std::vector<bool>>::ok(std::move(found));
+}
+
+void kv_store_free_string_list(KvStoreStringList &list) {
+  bindings_list_string_t ret{reinterpret_cast<bindings_string_t*>(list.ptr), list.len};
+  bindings_list_string_free(&ret);
+  list = {};
+}
+
+void kv_store_free_zlist(KvStoreZList &list) {
+  bindings_list_tuple2_value_f64_t ret{reinterpret_cast<bindings_tuple2_value_f64_t*>(list.ptr), list.len};
+  bindings_list_tuple2_value_f64_free(&ret);
+  list = {};
+}
+
 // Cache implementations
 
 namespace {
   CacheError convert_cache_error(const gcore_fastedge_cache_sync_error_t& err) {
+    track_error(err, GCORE_FASTEDGE_CACHE_TYPES_ERROR_OTHER);
     CacheError error;
     error.tag = static_cast<CacheErrorTag>(err.tag);
     if (err.tag == GCORE_FASTEDGE_CACHE_TYPES_ERROR_OTHER) {
@@ -242,6 +490,7 @@ CacheResult<CacheOption<CacheBytes>> cache_get(std::string_view key) {
 
   if (success) {
     if (ret.is_some) {
+      track_bytes(ret.val.ptr, ret.val.len);
       CacheBytes bytes;
       bytes.ptr = ret.val.ptr;
       bytes.len = ret.val.len;
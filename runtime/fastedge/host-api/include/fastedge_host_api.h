@@ -4,16 +4,52 @@
 #include "host_api.h"
 
 #include <optional>
+#include <vector>
 
 typedef uint32_t FastEdgeHandle;
 struct JSErrorFormatString;
 
 namespace host_api {
 
+// Ownership of canonical-ABI allocations.
+//
+// The wrappers below hand out raw pointers into host-allocated buffers
+// (KvStoreValue, KvStoreZList, CacheBytes, error strings, ...). Every such
+// allocation is recorded when the wrapper returns and freed when the
+// innermost enclosing HostArenaScope is destroyed. Builtins open a scope
+// around each host call, copy what they need into JS, and let the scope
+// release the rest. Anything that must outlive the call (e.g. a paged scan
+// cursor) is taken out of the arena with `host_arena_detach` and freed by
+// its new owner.
+class HostArenaScope {
+public:
+    HostArenaScope();
+    ~HostArenaScope();
+
+    HostArenaScope(const HostArenaScope &) = delete;
+    HostArenaScope &operator=(const HostArenaScope &) = delete;
+
+private:
+    size_t mark_;
+};
+
+// Stop tracking the allocation whose outer buffer is `ptr`; the caller now
+// owns it. No-op if `ptr` is not tracked.
+void host_arena_detach(const void *ptr);
+
 // Environment and secrets
+//
+// A secret lookup can fail on the host (access denied, decryption or I/O
+// error). `failed` tells that apart from a secret that isn't set; `value`
+// is empty in both cases.
+struct HostLookup {
+    HostString value;
+    bool failed = false;
+};
+
 HostString get_env_vars(std::string_view name);
-HostString get_secret_vars(std::string_view name);
-HostString get_secret_vars_effective_at(std::string_view name, uint32_t effective_at);
+HostLookup get_secret_vars(std::string_view name);
+HostLookup get_secret_vars_effective_at(std::string_view name, uint32_t effective_at);
 
 // KV Store types and enums
 enum class KvStoreErrorTag : uint8_t {
@@ -109,13 +145,39 @@ struct KvStoreStringList {
     size_t len;
 };
 
+// LIMIT / ordering / bound modifiers for kv_store_zrange_by_score.
+// Defaults reproduce the plain inclusive, ascending, unbounded range.
+struct KvStoreZRangeOptions {
+    bool min_exclusive = false;
+    bool max_exclusive = false;
+    bool reverse = false;
+    size_t offset = 0;
+    std::optional<size_t> count;
+};
+
 // KV Store functions
 KvStoreResult<int32_t> kv_store_open(std::string_view name);
+void kv_store_close(int32_t store_handle);
 KvStoreResult<KvStoreOption<KvStoreValue>> kv_store_get(int32_t store_handle, std::string_view key);
 KvStoreResult<KvStoreStringList> kv_store_scan(int32_t store_handle, std::string_view pattern);
-KvStoreResult<KvStoreZList> kv_store_zrange_by_score(int32_t store_handle, std::string_view key, double min, double max);
+KvStoreResult<KvStoreZList> kv_store_zrange_by_score(int32_t store_handle, std::string_view key, double min, double max,
+                                                     const KvStoreZRangeOptions &options = {});
+// zrange_by_score over each of `keys` with the same bounds and options,
+// in order. Fails on the first host error.
+KvStoreResult<std::vector<KvStoreZList>> kv_store_zrange_by_score_many(int32_t store_handle,
+                                                                       const std::vector<std::string_view> &keys,
+                                                                       double min, double max,
+                                                                       const KvStoreZRangeOptions &options = {});
 KvStoreResult<KvStoreZList> kv_store_zscan(int32_t store_handle, std::string_view key, std::string_view pattern);
 KvStoreResult<bool> kv_store_bf_exists(int32_t store_handle, std::string_view key, std::string_view item);
+// Membership of each of `items` in the Bloom filter at `key`, in order.
+// Fails on the first host error.
+KvStoreResult<std::vector<bool>> kv_store_bf_exists_many(int32_t store_handle, std::string_view key,
+                                                         const std::vector<std::string_view> &items);
+
+// Release host-allocated result lists detached from the arena. Resets `list` to empty.
+void kv_store_free_string_list(KvStoreStringList &list);
+void kv_store_free_zlist(KvStoreZList &list);
 
 // Cache types and enums
 //
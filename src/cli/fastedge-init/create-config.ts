@@ -57,7 +57,7 @@ const defaultConfig: DefaultConfig = {
     static: {
       extendedCache: [],
       publicDirPrefix: '',
-      compression: [], // Not implemented - seems excessive for inline-wasm sizes ['br', 'gzip']
+      compression: [], // Only applies to packed archives built with the same `compression`
       notFoundPage: '/404.html',
       autoExt: [], // Never used before
       autoIndex: ['index.html', 'index.htm'],
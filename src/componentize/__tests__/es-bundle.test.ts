@@ -27,6 +27,12 @@ describe('es-bundle - fastedge:: namespace resolver', () => {
     expect(out).toContain('globalThis.fastedge.getEnv');
   });
 
+  it('resolves fastedge::env env to globalThis.fastedge.env', async () => {
+    expect.assertions(1);
+    const out = await bundle(`import { env } from 'fastedge::env'; export { env };`);
+    expect(out).toContain('globalThis.fastedge.env');
+  });
+
   it('resolves fastedge::fs to globalThis.fastedge.readFileSync', async () => {
     expect.assertions(1);
     const out = await bundle(
@@ -59,6 +65,48 @@ describe('es-bundle - fastedge:: namespace resolver', () => {
     expect(out).not.toContain('globalThis.fastedge.Cache');
   });
 
+  it('resolves fastedge::codec to globalThis.Codec', async () => {
+    expect.assertions(2);
+    const out = await bundle(`import { Codec } from 'fastedge::codec'; export { Codec };`);
+    expect(out).toContain('globalThis.Codec');
+    expect(out).not.toContain('globalThis.fastedge.Codec');
+  });
+
+  it('resolves fastedge::ip to globalThis.CidrSet', async () => {
+    expect.assertions(2);
+    const out = await bundle(`import { CidrSet } from 'fastedge::ip'; export { CidrSet };`);
+    expect(out).toContain('globalThis.CidrSet');
+    expect(out).not.toContain('globalThis.fastedge.CidrSet');
+  });
+
+  it('resolves fastedge::ja3 to globalThis.Ja3Set', async () => {
+    expect.assertions(2);
+    const out = await bundle(`import { Ja3Set } from 'fastedge::ja3'; export { Ja3Set };`);
+    expect(out).toContain('globalThis.Ja3Set');
+    expect(out).not.toContain('globalThis.fastedge.Ja3Set');
+  });
+
+  it('resolves fastedge::pattern to globalThis.PatternSet', async () => {
+    expect.assertions(2);
+    const out = await bundle(`import { PatternSet } from 'fastedge::pattern'; export { PatternSet };`);
+    expect(out).toContain('globalThis.PatternSet');
+    expect(out).not.toContain('globalThis.fastedge.PatternSet');
+  });
+
+  it('resolves fastedge::assets to globalThis.AssetArchive', async () => {
+    expect.assertions(1);
+    const out = await bundle(
+      `import { AssetArchive } from 'fastedge::assets'; export { AssetArchive };`,
+    );
+    expect(out).toContain('globalThis.AssetArchive');
+  });
+
+  it('resolves fastedge::router to globalThis.fastedge.Router', async () => {
+    expect.assertions(1);
+    const out = await bundle(`import { Router } from 'fastedge::router'; export { Router };`);
+    expect(out).toContain('globalThis.fastedge.Router');
+  });
+
   it('returns empty contents for unknown fastedge:: imports', async () => {
     expect.assertions(2);
     const out = await bundle(`import * as unknown from 'fastedge::unknown'; export { unknown };`);
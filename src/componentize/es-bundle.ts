@@ -15,7 +15,12 @@ const fastedgePackagePlugin: Plugin = {
     build.onLoad({ filter: /^.*/, namespace: 'fastedge' }, async (args) => {
       switch (args.path) {
         case 'env': {
-          return { contents: `export const getEnv = globalThis.fastedge.getEnv;` };
+          return {
+            contents: `
+            export const getEnv = globalThis.fastedge.getEnv;
+            export const env = globalThis.fastedge.env;
+            `,
+          };
         }
         case 'fs': {
           return { contents: `export const readFileSync = globalThis.fastedge.readFileSync;` };
@@ -42,6 +47,48 @@ const fastedgePackagePlugin: Plugin = {
             `,
           };
         }
+        case 'codec': {
+          return {
+            contents: `
+            export const Codec = globalThis.Codec;
+            `,
+          };
+        }
+        case 'ip': {
+          return {
+            contents: `
+            export const CidrSet = globalThis.CidrSet;
+            `,
+          };
+        }
+        case 'ja3': {
+          return {
+            contents: `
+            export const Ja3Set = globalThis.Ja3Set;
+            `,
+          };
+        }
+        case 'pattern': {
+          return {
+            contents: `
+            export const PatternSet = globalThis.PatternSet;
+            `,
+          };
+        }
+        case 'assets': {
+          return {
+            contents: `
+            export const AssetArchive = globalThis.AssetArchive;
+            `,
+          };
+        }
+        case 'router': {
+          return {
+            contents: `
+            export const Router = globalThis.fastedge.Router;
+            `,
+          };
+        }
         default: {
           return { contents: '' };
         }
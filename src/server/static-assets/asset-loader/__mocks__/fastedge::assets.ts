@@ -0,0 +1,3 @@
+import { jest } from '@jest/globals';
+
+export const AssetArchive = { open: jest.fn() };
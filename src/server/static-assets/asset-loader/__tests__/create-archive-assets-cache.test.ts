@@ -0,0 +1,114 @@
+import { createTestFileBinaryArray } from '../__fixtures__/index.ts';
+import { createArchiveAssetsCache } from '../create-archive-assets-cache.ts';
+
+const mockCreateEmbeddedStoreEntry = jest.fn();
+jest.mock('../embedded-store-entry/embedded-store-entry', () => ({
+  createEmbeddedStoreEntry: jest.fn((...args) => mockCreateEmbeddedStoreEntry(...args)),
+}));
+
+const createTestEntry = (overrides = {}) => ({
+  body: createTestFileBinaryArray('Hello'),
+  size: 5,
+  contentType: 'text/html',
+  etag: 'hash123',
+  lastModified: 'Sun, 01 Jan 2023 00:00:00 GMT',
+  lastModifiedTime: 1_672_531_200,
+  isText: true,
+  encodings: {},
+  ...overrides,
+});
+
+describe('createArchiveAssetsCache', () => {
+  const mockArchive = {
+    get: jest.fn(),
+    has: jest.fn(),
+    keys: jest.fn(),
+    serve: jest.fn(),
+    size: 0,
+  };
+
+  beforeEach(() => {
+    jest.clearAllMocks();
+  });
+
+  it('should return null for assets that are not in the archive', () => {
+    expect.assertions(2);
+    mockArchive.get.mockReturnValue(null);
+    const cache = createArchiveAssetsCache(mockArchive);
+
+    expect(cache.getAsset('/missing.html')).toBeNull();
+    expect(mockArchive.get).toHaveBeenCalledWith('/missing.html');
+  });
+
+  it('should expose archive entries as static assets', () => {
+    expect.assertions(3);
+    mockArchive.get.mockReturnValue(createTestEntry());
+    const asset = createArchiveAssetsCache(mockArchive).getAsset('/index.html');
+
+    expect(asset?.assetKey).toBe('/index.html');
+    expect(asset?.getMetadata()).toStrictEqual({
+      type: 'wasm-archive',
+      assetKey: '/index.html',
+      contentType: 'text/html',
+      isText: true,
+      fileInfo: {
+        assetPath: '/index.html',
+        hash: 'hash123',
+        size: 5,
+        lastModifiedTime: 1_672_531_200,
+      },
+    });
+    expect(asset?.getText()).toBe('Hello');
+  });
+
+  it('should create store entries from the archive bytes', async () => {
+    expect.assertions(2);
+    const entry = createTestEntry();
+    const storeEntry = { body: jest.fn() };
+    mockArchive.get.mockReturnValue(entry);
+    mockCreateEmbeddedStoreEntry.mockReturnValue(storeEntry);
+    const asset = createArchiveAssetsCache(mockArchive).getAsset('/index.html');
+
+    await expect(asset?.getEmbeddedStoreEntry(null)).resolves.toBe(storeEntry);
+    expect(mockCreateEmbeddedStoreEntry).toHaveBeenCalledWith(entry.body, null, 'hash123', 5);
+  });
+
+  it('should create store entries from the best precompressed variant', async () => {
+    expect.assertions(2);
+    const br = createTestFileBinaryArray('b');
+    const gzip = createTestFileBinaryArray('gz');
+    mockArchive.get.mockReturnValue(createTestEntry({ encodings: { br, gzip } }));
+    const asset = createArchiveAssetsCache(mockArchive).getAsset('/index.html');
+
+    await asset?.getEmbeddedStoreEntry([['zstd'], ['gzip', 'br']]);
+    await asset?.getEmbeddedStoreEntry([['zstd']]);
+
+    expect(mockCreateEmbeddedStoreEntry).toHaveBeenNthCalledWith(1, br, 'br', 'hash123-br', 1);
+    expect(mockCreateEmbeddedStoreEntry).toHaveBeenNthCalledWith(
+      2,
+      expect.any(Uint8Array),
+      null,
+      'hash123',
+      5,
+    );
+  });
+
+  it('should throw when reading non-text assets as text', () => {
+    expect.assertions(1);
+    mockArchive.get.mockReturnValue(createTestEntry({ isText: false }));
+    const asset = createArchiveAssetsCache(mockArchive).getAsset('/logo.png');
+
+    expect(() => asset?.getText()).toThrow("Can't getText() for non-text content");
+  });
+
+  it('should list asset keys from the archive and reject new assets', () => {
+    expect.assertions(2);
+    mockArchive.keys.mockReturnValue(['/index.html', '/app.js']);
+    const cache = createArchiveAssetsCache(mockArchive);
+
+    expect(cache.getAssetKeys()).toStrictEqual(['/index.html', '/app.js']);
+    expect(() => cache.loadAsset('/new.html', {} as any)).toThrow(
+      'Assets cannot be added to an asset archive',
+    );
+  });
+});
@@ -0,0 +1,86 @@
+import { createEmbeddedStoreEntry } from './embedded-store-entry/embedded-store-entry.ts';
+
+import type { AssetCache } from './asset-cache/asset-cache.ts';
+import type {
+  ContentCompressionTypes,
+  StaticAsset,
+  StaticAssetMetadata,
+} from './inline-asset/inline-asset.ts';
+import type { AssetArchiveEntry, AssetArchiveInstance } from 'fastedge::assets';
+
+/**
+ * Wraps an archive entry in the `StaticAsset` interface used by the static server.
+ *
+ * @param assetKey - The key of the asset.
+ * @param entry - The archive entry for the asset.
+ * @returns A `StaticAsset` backed by the archive's bytes.
+ */
+const createArchiveAsset = (assetKey: string, entry: AssetArchiveEntry): StaticAsset => {
+  const metadata: StaticAssetMetadata = {
+    type: 'wasm-archive',
+    assetKey,
+    contentType: entry.contentType,
+    isText: entry.isText,
+    fileInfo: {
+      assetPath: assetKey,
+      hash: entry.etag,
+      size: entry.size,
+      lastModifiedTime: entry.lastModifiedTime,
+    },
+  };
+
+  return {
+    assetKey,
+    getMetadata: () => metadata,
+    getEmbeddedStoreEntry: async (acceptEncodingsGroups: Array<ContentCompressionTypes[]> | null) => {
+      // Groups are ordered by q-value; within the first group that has a variant, the smallest one wins.
+      // Variant ETags match the ones `AssetArchiveInstance.serve` sends.
+      for (const encodingGroup of acceptEncodingsGroups ?? []) {
+        const [encoding] = encodingGroup
+          .filter((x) => entry.encodings[x] != null)
+          .sort((a, b) => entry.encodings[a]!.length - entry.encodings[b]!.length);
+        if (encoding != null) {
+          const variant = entry.encodings[encoding]!;
+          return createEmbeddedStoreEntry(
+            variant,
+            encoding,
+            `${entry.etag}-${encoding}`,
+            variant.length,
+          );
+        }
+      }
+      return createEmbeddedStoreEntry(entry.body, null, entry.etag, entry.size);
+    },
+    getText: (): string => {
+      if (!entry.isText) {
+        throw new Error("Can't getText() for non-text content");
+      }
+      return new TextDecoder().decode(entry.body);
+    },
+    type: metadata.type,
+  };
+};
+
+/**
+ * Creates an `AssetCache` over a packed asset archive written by `fastedge-assets`.
+ * Lookups are resolved natively by `AssetArchive`, so no per-asset JS objects are kept in the heap.
+ *
+ * @param archive - The archive, opened with `AssetArchive.open` during Wizer processing.
+ * @returns A read-only `AssetCache` instance.
+ */
+function createArchiveAssetsCache(archive: AssetArchiveInstance): AssetCache<StaticAsset> {
+  return {
+    getAsset: (assetKey: string): StaticAsset | null => {
+      const entry = archive.get(assetKey);
+      return entry == null ? null : createArchiveAsset(assetKey, entry);
+    },
+
+    getAssetKeys: (): string[] => archive.keys(),
+
+    loadAsset: (): void => {
+      throw new Error('Assets cannot be added to an asset archive');
+    },
+  };
+}
+
+export { createArchiveAssetsCache };
@@ -1,6 +1,6 @@
 import type { EmbeddedStoreEntry } from '../embedded-store-entry/embedded-store-entry.ts';
 
-type ContentCompressionTypes = 'br' | 'gzip';
+type ContentCompressionTypes = 'br' | 'gzip' | 'zstd';
 
 /**
  * Represents the source and metadata of an asset.
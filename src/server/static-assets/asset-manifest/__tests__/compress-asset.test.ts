@@ -0,0 +1,65 @@
+import { randomBytes } from 'node:crypto';
+import { brotliDecompressSync, gunzipSync } from 'node:zlib';
+
+import { compressAsset, normalizeArchiveEncodings } from '../compress-asset.ts';
+
+const mockColorLog = jest.fn();
+jest.mock('~utils/color-log', () => ({
+  colorLog: (...args: any[]) => mockColorLog(...args),
+}));
+
+const decoder = new TextDecoder();
+
+describe('compressAsset', () => {
+  beforeEach(() => {
+    jest.clearAllMocks();
+  });
+
+  it('should create decodable variants for each requested encoding', () => {
+    expect.assertions(3);
+    const content = new TextEncoder().encode('<p>hello</p>'.repeat(100));
+    const variants = compressAsset(content, ['br', 'gzip'], true);
+
+    expect(Object.keys(variants)).toStrictEqual(['br', 'gzip']);
+    expect(decoder.decode(brotliDecompressSync(variants.br!))).toBe(decoder.decode(content));
+    expect(decoder.decode(gunzipSync(variants.gzip!))).toBe(decoder.decode(content));
+  });
+
+  it('should drop variants that are not smaller than the original', () => {
+    expect.assertions(1);
+    const content = new Uint8Array(randomBytes(256));
+
+    expect(compressAsset(content, ['br', 'gzip'], false)).toStrictEqual({});
+  });
+
+  it('should create no variants when no encodings are requested', () => {
+    expect.assertions(1);
+    const content = new TextEncoder().encode('aaaa'.repeat(100));
+
+    expect(compressAsset(content, [], true)).toStrictEqual({});
+  });
+});
+
+describe('normalizeArchiveEncodings', () => {
+  beforeEach(() => {
+    jest.clearAllMocks();
+  });
+
+  it('should keep supported encodings once, in configured order', () => {
+    expect.assertions(2);
+
+    expect(normalizeArchiveEncodings(['gzip', 'br', 'gzip', 'zstd'])).toStrictEqual([
+      'gzip',
+      'br',
+      'zstd',
+    ]);
+    expect(mockColorLog).not.toHaveBeenCalled();
+  });
+
+  it('should warn about and skip unsupported encodings', () => {
+    expect.assertions(2);
+
+    expect(normalizeArchiveEncodings(['deflate', 'br'])).toStrictEqual(['br']);
+    expect(mockColorLog).toHaveBeenCalledWith('warning', expect.stringContaining("'deflate'"));
+  });
+});
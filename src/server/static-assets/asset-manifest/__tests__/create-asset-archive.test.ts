@@ -0,0 +1,181 @@
+import { brotliDecompressSync, gunzipSync } from 'node:zlib';
+
+import {
+  ARCHIVE_MAGIC,
+  ARCHIVE_VERSION,
+  createAssetArchive,
+  ENTRY_WORDS,
+  EntryField,
+  hashAssetPath,
+} from '../create-asset-archive.ts';
+
+import type { StaticAssetManifest } from '../types.ts';
+
+const encoder = new TextEncoder();
+const decoder = new TextDecoder();
+
+const createManifest = (keys: string[]): StaticAssetManifest =>
+  Object.fromEntries(
+    keys.map((assetKey, i) => [
+      assetKey,
+      {
+        assetKey,
+        type: 'wasm-inline',
+        contentType: assetKey.endsWith('.html') ? 'text/html' : 'application/octet-stream',
+        isText: assetKey.endsWith('.html'),
+        fileInfo: {
+          assetPath: `./public${assetKey}`,
+          hash: `hash-${i}`,
+          lastModifiedTime: i === 0 ? 0 : 1_700_000_000 + i,
+          size: assetKey.length,
+        },
+      },
+    ]),
+  );
+
+// Contents of each test file are its own asset path
+const readTestFile = (assetPath: string) => encoder.encode(assetPath);
+
+/**
+ * Mirrors the runtime lookup in runtime/fastedge/builtins/asset-archive.cpp.
+ */
+const readArchive = (archive: Uint8Array) => {
+  const view = new DataView(archive.buffer, archive.byteOffset, archive.byteLength);
+  const header = (i: number) => view.getUint32(i * 4, true);
+  const [count, displacementsOffset, entriesOffset, stringsOffset, dataOffset] = [2, 3, 4, 5, 6].map(
+    header,
+  );
+  const field = (index: number, f: number) =>
+    view.getUint32(entriesOffset + (index * ENTRY_WORDS + f) * 4, true);
+  const string = (index: number, f: number) => {
+    const offset = stringsOffset + field(index, f);
+    return decoder.decode(archive.subarray(offset, offset + field(index, f + 1)));
+  };
+
+  const find = (path: string) => {
+    const bytes = encoder.encode(path);
+    const displacement = view.getInt32(
+      displacementsOffset + (hashAssetPath(0, bytes) % count) * 4,
+      true,
+    );
+    const index = displacement < 0 ? -displacement - 1 : hashAssetPath(displacement, bytes) % count;
+    if (string(index, EntryField.PathOffset) !== path) {
+      return null;
+    }
+    const start = dataOffset + field(index, EntryField.DataStart);
+    return {
+      index,
+      body: decoder.decode(archive.subarray(start, start + field(index, EntryField.DataLength))),
+      contentType: string(index, EntryField.ContentTypeOffset),
+      etag: string(index, EntryField.EtagOffset),
+      lastModified: string(index, EntryField.LastModifiedOffset),
+      lastModifiedTime: field(index, EntryField.LastModifiedTime),
+      flags: field(index, EntryField.Flags),
+    };
+  };
+
+  return { header, find };
+};
+
+describe('createAssetArchive', () => {
+  it('should write the archive header', () => {
+    expect.assertions(4);
+    const archive = createAssetArchive(createManifest(['/index.html', '/app.js']), { readFile: readTestFile });
+    const { header } = readArchive(archive);
+
+    expect(header(0)).toBe(ARCHIVE_MAGIC);
+    expect(header(1)).toBe(ARCHIVE_VERSION);
+    expect(header(2)).toBe(2);
+    expect(header(7)).toBe(archive.length);
+  });
+
+  it('should resolve every asset key to its own entry through the perfect hash', () => {
+    expect.assertions(2);
+    const keys = Array.from({ length: 500 }, (_, i) => `/assets/file-${i}.html`);
+    const { find } = readArchive(createAssetArchive(createManifest(keys), { readFile: readTestFile }));
+
+    const indexes = keys.map((key) => find(key)?.index);
+
+    expect(new Set(indexes).size).toBe(keys.length);
+    expect(keys.every((key) => find(key)?.body === `./public${key}`)).toBe(true);
+  });
+
+  it('should store precomputed headers and flags', () => {
+    expect.assertions(2);
+    const { find } = readArchive(
+      createAssetArchive(createManifest(['/index.html', '/logo.png']), { readFile: readTestFile }),
+    );
+
+    expect(find('/index.html')).toMatchObject({
+      contentType: 'text/html',
+      etag: 'hash-0',
+      lastModified: '',
+      lastModifiedTime: 0,
+      flags: 1,
+    });
+    expect(find('/logo.png')).toMatchObject({
+      contentType: 'application/octet-stream',
+      etag: 'hash-1',
+      lastModified: new Date(1_700_000_001 * 1000).toUTCString(),
+      lastModifiedTime: 1_700_000_001,
+      flags: 0,
+    });
+  });
+
+  it('should not match paths that are not in the archive', () => {
+    expect.assertions(2);
+    const { find } = readArchive(
+      createAssetArchive(createManifest(['/index.html', '/app.js']), { readFile: readTestFile }),
+    );
+
+    expect(find('/missing.html')).toBeNull();
+    expect(find('/index.htm')).toBeNull();
+  });
+
+  it('should align file contents to 8 bytes', () => {
+    expect.assertions(1);
+    const archive = createAssetArchive(createManifest(['/a.html', '/bb.html', '/ccc.html']), { readFile: readTestFile });
+    const view = new DataView(archive.buffer);
+    const dataOffset = view.getUint32(24, true);
+    const starts = [0, 1, 2].map((i) =>
+      view.getUint32(view.getUint32(16, true) + (i * ENTRY_WORDS + EntryField.DataStart) * 4, true),
+    );
+
+    expect([dataOffset, ...starts].every((offset) => offset % 8 === 0)).toBe(true);
+  });
+
+  it('should store smaller precompressed variants after the original', () => {
+    expect.assertions(4);
+    const text = 'compressible '.repeat(200);
+    const archive = createAssetArchive(createManifest(['/index.html', '/tiny.html']), {
+      compression: ['br', 'gzip'],
+      readFile: (assetPath) => encoder.encode(assetPath.endsWith('tiny.html') ? 'x' : text),
+    });
+    const { header, find } = readArchive(archive);
+    const view = new DataView(archive.buffer);
+    const variant = (path: string, encoding: number) => {
+      const { index } = find(path)!;
+      const field = (f: number) =>
+        view.getUint32(header(4) + (index * ENTRY_WORDS + EntryField.VariantsStart + f) * 4, true);
+      const start = header(6) + field(encoding * 2);
+      return archive.subarray(start, start + field(encoding * 2 + 1));
+    };
+
+    expect(decoder.decode(brotliDecompressSync(variant('/index.html', 0)))).toBe(text);
+    expect(decoder.decode(gunzipSync(variant('/index.html', 1)))).toBe(text);
+    // zstd was not requested; a one-byte file doesn't shrink
+    expect(variant('/index.html', 2)).toHaveLength(0);
+    expect([0, 1, 2].map((encoding) => variant('/tiny.html', encoding).length)).toStrictEqual([
+      0, 0, 0,
+    ]);
+  });
+
+  it('should create an empty archive for an empty manifest', () => {
+    expect.assertions(2);
+    const archive = createAssetArchive({}, { readFile: readTestFile });
+    const { header } = readArchive(archive);
+
+    expect(header(2)).toBe(0);
+    expect(archive.length).toBe(32);
+  });
+});
@@ -14,11 +14,15 @@ const mockPrettierObjectString = jest.fn();
 const mockCreateOutputDirectory = jest.fn();
 const mockColorLog = jest.fn();
 const mockNormalizeConfig = jest.fn();
+const mockCreateAssetArchive = jest.fn();
 
 jest.mock('../create-manifest-file-map', () => ({
   createManifestFileMap: (...args: any[]) => mockCreateManifestFileMap(...args),
   prettierObjectString: (...args: any[]) => mockPrettierObjectString(...args),
 }));
+jest.mock('../create-asset-archive', () => ({
+  createAssetArchive: (...args: any[]) => mockCreateAssetArchive(...args),
+}));
 jest.mock('~utils/file-system', () => {
   // eslint-disable-next-line unicorn/prefer-module, @typescript-eslint/no-require-imports
   const path = require('node:path');
@@ -45,6 +49,7 @@ describe('createStaticAssetsManifest', () => {
   beforeEach(() => {
     jest.clearAllMocks();
     mockPrettierObjectString.mockImplementation((obj) => JSON.stringify(obj));
+    mockCreateAssetArchive.mockReturnValue(new Uint8Array([1, 2, 3]));
   });
 
   it('should create manifest file and return manifest object', async () => {
@@ -60,6 +65,7 @@ describe('createStaticAssetsManifest', () => {
       ignorePaths: [],
       contentTypes: [],
       assetManifestPath: '',
+      compression: [],
     };
     const manifest: StaticAssetManifest = {
       '/index.html': {
@@ -91,6 +97,32 @@ describe('createStaticAssetsManifest', () => {
     expect(result).toBe(manifest);
   });
 
+  it('should write the asset archive next to the manifest and export its path', async () => {
+    expect.assertions(3);
+    const manifest: StaticAssetManifest = {
+      '/index.html': { assetKey: '/index.html', contentType: 'text/html' } as any,
+    };
+    const archive = new Uint8Array([1, 2, 3]);
+
+    mockNormalizeConfig.mockReturnValue({ publicDir, assetManifestPath: '' });
+    mockCreateManifestFileMap.mockResolvedValue(manifest);
+    mockCreateAssetArchive.mockReturnValue(archive);
+
+    await createStaticAssetsManifest({ publicDir });
+
+    expect(mockCreateAssetArchive).toHaveBeenCalledWith(manifest, { compression: [] });
+    expect(writeFileSync).toHaveBeenCalledWith(
+      path.resolve('./.fastedge/build/static-asset-manifest.pack'),
+      archive,
+    );
+    expect(writeFileSync).toHaveBeenCalledWith(
+      path.resolve(`.${DEFAULT_ASSET_MANIFEST_PATH}`),
+      expect.stringContaining(
+        "const staticAssetArchive = './.fastedge/build/static-asset-manifest.pack';",
+      ),
+    );
+  });
+
   it('should use provided assetManifestPath if it is a file', async () => {
     expect.assertions(4);
     const config: Partial<AssetCacheConfig> = {
@@ -207,6 +239,7 @@ describe('createStaticAssetsManifest', () => {
       ignorePaths: [],
       contentTypes: [],
       assetManifestPath: '',
+      compression: [],
     };
     const manifest: StaticAssetManifest = {
       '/foo.txt': { assetKey: '/foo.txt', contentType: 'text/plain' } as any,
@@ -240,6 +273,7 @@ describe('createStaticAssetsManifest', () => {
       ignorePaths: [],
       contentTypes: [],
       assetManifestPath: '',
+      compression: [],
     };
     const manifest: StaticAssetManifest = {};
 
@@ -267,6 +301,7 @@ describe('createStaticAssetsManifest', () => {
       ignorePaths: [],
       contentTypes: [],
       assetManifestPath: '',
+      compression: [],
     };
     const manifest: StaticAssetManifest = {};
 
@@ -280,6 +315,21 @@ describe('createStaticAssetsManifest', () => {
     expect(mockCreateOutputDirectory).toHaveBeenCalledWith(expectedManifestBuildOutput);
   });
 
+  it('should precompress archive assets with the supported configured encodings', async () => {
+    expect.assertions(2);
+    mockNormalizeConfig.mockReturnValue({
+      publicDir,
+      assetManifestPath: '',
+      compression: ['br', 'deflate', 'zstd'],
+    });
+    mockCreateManifestFileMap.mockResolvedValue({});
+
+    await createStaticAssetsManifest({ publicDir });
+
+    expect(mockCreateAssetArchive).toHaveBeenCalledWith({}, { compression: ['br', 'zstd'] });
+    expect(mockColorLog).toHaveBeenCalledWith('warning', expect.stringContaining("'deflate'"));
+  });
+
   it('should pass correct normalization schema to normalizeConfig', async () => {
     expect.assertions(1);
     const config: Partial<AssetCacheConfig> = { publicDir };
@@ -290,6 +340,7 @@ describe('createStaticAssetsManifest', () => {
       ignorePaths: [],
       contentTypes: [],
       assetManifestPath: '',
+      compression: [],
     });
 
     mockCreateManifestFileMap.mockResolvedValue({});
@@ -305,6 +356,7 @@ describe('createStaticAssetsManifest', () => {
         publicDir: 'path',
         contentTypes: 'stringArray',
         assetManifestPath: 'path',
+        compression: 'stringArray',
       }),
     );
   });
@@ -0,0 +1,108 @@
+import * as zlib from 'node:zlib';
+
+import type { ContentCompressionTypes } from '~static-assets/asset-loader/inline-asset/inline-asset.ts';
+
+import { colorLog } from '~utils/color-log.ts';
+
+/**
+ * Encodings that can be precompressed into an asset archive, in the order their variants are stored.
+ */
+const ARCHIVE_ENCODINGS: readonly ContentCompressionTypes[] = ['br', 'gzip', 'zstd'];
+
+type CompressedVariants = Partial<Record<ContentCompressionTypes, Uint8Array>>;
+
+let warnedZstdUnavailable = false;
+
+/**
+ * Compresses `content` with an encoding at its strongest setting. This runs once per asset at build time, so ratio
+ * matters more than speed.
+ * @param encoding - The content encoding.
+ * @param content - The bytes to compress.
+ * @param isText - Whether the content is text, used as a Brotli mode hint.
+ * @returns The compressed bytes, or `null` if this Node.js version can't produce the encoding.
+ */
+function compress(
+  encoding: ContentCompressionTypes,
+  content: Uint8Array,
+  isText: boolean,
+): Uint8Array | null {
+  switch (encoding) {
+    case 'br': {
+      return zlib.brotliCompressSync(content, {
+        params: {
+          [zlib.constants.BROTLI_PARAM_MODE]: isText
+            ? zlib.constants.BROTLI_MODE_TEXT
+            : zlib.constants.BROTLI_MODE_GENERIC,
+          [zlib.constants.BROTLI_PARAM_QUALITY]: zlib.constants.BROTLI_MAX_QUALITY,
+          [zlib.constants.BROTLI_PARAM_SIZE_HINT]: content.length,
+        },
+      });
+    }
+    case 'gzip': {
+      return zlib.gzipSync(content, { level: zlib.constants.Z_BEST_COMPRESSION });
+    }
+    case 'zstd': {
+      // zstd is only available from Node.js 22.15
+      if (typeof zlib.zstdCompressSync !== 'function') {
+        if (!warnedZstdUnavailable) {
+          warnedZstdUnavailable = true;
+          colorLog('warning', 'zstd compression requires Node.js 22.15 or later. Skipping zstd variants.');
+        }
+        return null;
+      }
+      return zlib.zstdCompressSync(content, {
+        params: { [zlib.constants.ZSTD_c_compressionLevel]: 19 },
+      });
+    }
+    default: {
+      return null;
+    }
+  }
+}
+
+/**
+ * Creates the precompressed variants of an asset for each requested encoding, keeping a variant only if it is
+ * smaller than the original.
+ *
+ * @param content - The asset's contents.
+ * @param encodings - The encodings to produce.
+ * @param isText - Whether the asset has a text content type.
+ * @returns The variants that were kept, by encoding.
+ */
+function compressAsset(
+  content: Uint8Array,
+  encodings: readonly ContentCompressionTypes[],
+  isText: boolean,
+): CompressedVariants {
+  const variants: CompressedVariants = {};
+  for (const encoding of encodings) {
+    const compressed = compress(encoding, content, isText);
+    if (compressed != null && compressed.length < content.length) {
+      variants[encoding] = compressed;
+    }
+  }
+  return variants;
+}
+
+/**
+ * Filters a configured list of encodings down to those an asset archive can hold, warning about the rest.
+ * @param compression - The configured encodings.
+ * @returns The supported encodings, without duplicates.
+ */
+function normalizeArchiveEncodings(compression: string[] = []): ContentCompressionTypes[] {
+  const encodings = new Set<ContentCompressionTypes>();
+  for (const encoding of compression) {
+    if (ARCHIVE_ENCODINGS.includes(encoding as ContentCompressionTypes)) {
+      encodings.add(encoding as ContentCompressionTypes);
+    } else {
+      colorLog(
+        'warning',
+        `Unsupported compression '${encoding}'. Supported: ${ARCHIVE_ENCODINGS.join(', ')}.`,
+      );
+    }
+  }
+  return [...encodings];
+}
+
+export { ARCHIVE_ENCODINGS, compressAsset, normalizeArchiveEncodings };
+export type { CompressedVariants };
@@ -0,0 +1,242 @@
+import { readFileSync } from 'node:fs';
+
+import { ARCHIVE_ENCODINGS, compressAsset } from './compress-asset.ts';
+
+import type { StaticAssetManifest } from './types.ts';
+import type { ContentCompressionTypes } from '~static-assets/asset-loader/inline-asset/inline-asset.ts';
+
+/**
+ * Packed asset archive layout (version 2). All integers are little-endian u32.
+ *
+ * | Section       | Contents                                                                   |
+ * | ------------- | -------------------------------------------------------------------------- |
+ * | header        | magic `FEPK`, version, entry count, offsets of the four sections, length    |
+ * | displacements | one i32 per entry, the minimal perfect hash over asset keys                 |
+ * | entries       | `ENTRY_WORDS` u32s per asset, see `EntryField`                              |
+ * | strings       | UTF-8 asset keys, content types, ETags and Last-Modified values             |
+ * | data          | file contents and their precompressed variants, each 8-byte aligned         |
+ *
+ * Each entry locates its precompressed variants with a start/length pair per encoding, in `ARCHIVE_ENCODINGS`
+ * order; a length of 0 means there is no variant for that encoding.
+ *
+ * The runtime reader is `runtime/fastedge/builtins/asset-archive.cpp`; the two must change together.
+ */
+const ARCHIVE_MAGIC = 0x4b_50_45_46; // "FEPK"
+const ARCHIVE_VERSION = 2;
+const HEADER_WORDS = 8;
+const ENTRY_WORDS = 18;
+const DATA_ALIGNMENT = 8;
+
+const EntryField = {
+  PathOffset: 0,
+  PathLength: 1,
+  DataStart: 2,
+  DataLength: 3,
+  ContentTypeOffset: 4,
+  ContentTypeLength: 5,
+  EtagOffset: 6,
+  EtagLength: 7,
+  LastModifiedOffset: 8,
+  LastModifiedLength: 9,
+  LastModifiedTime: 10,
+  Flags: 11,
+  // Start and length of each precompressed variant, in `ARCHIVE_ENCODINGS` order
+  VariantsStart: 12,
+} as const;
+
+const FLAG_IS_TEXT = 1;
+
+/**
+ * FNV-1a over the UTF-8 bytes of an asset key, with `seed` as the offset basis (0 selects the standard one).
+ * @param seed - The hash seed.
+ * @param bytes - The UTF-8 encoded asset key.
+ * @returns The 32-bit hash.
+ */
+function hashAssetPath(seed: number, bytes: Uint8Array): number {
+  let hash = seed === 0 ? 0x81_1c_9d_c5 : seed;
+  for (const byte of bytes) {
+    hash = Math.imul(hash ^ byte, 0x01_00_01_93) >>> 0;
+  }
+  return hash;
+}
+
+/**
+ * Builds a minimal perfect hash ("hash and displace") over `keys`.
+ *
+ * Each key falls into bucket `hash(0, key) % n`. Buckets are placed largest first: a bucket holding
+ * several keys searches for a seed `d >= 1` that sends all of them to free, distinct slots via
+ * `hash(d, key) % n` and stores `d`; a bucket holding one key takes the next free slot `s` directly and
+ * stores `-s - 1`.
+ *
+ * @param keys - The UTF-8 encoded keys, all distinct.
+ * @returns The displacement for each bucket, and the slot assigned to each key.
+ */
+function createPerfectHash(keys: Uint8Array[]): { displacements: Int32Array; slots: number[] } {
+  const count = keys.length;
+  const displacements = new Int32Array(count);
+  const slots = Array.from<number>({ length: count });
+  const buckets: number[][] = Array.from({ length: count }, () => []);
+  for (const [index, key] of keys.entries()) {
+    buckets[hashAssetPath(0, key) % count].push(index);
+  }
+
+  const order = [...buckets.keys()].sort((a, b) => buckets[b].length - buckets[a].length);
+  const taken = new Uint8Array(count);
+  let position = 0;
+
+  for (; position < count && buckets[order[position]].length > 1; position++) {
+    const bucket = buckets[order[position]];
+    for (let seed = 1; ; seed++) {
+      const placed = bucket.map((index) => hashAssetPath(seed, keys[index]) % count);
+      if (placed.every((slot, i) => !taken[slot] && placed.indexOf(slot) === i)) {
+        for (const [i, slot] of placed.entries()) {
+          taken[slot] = 1;
+          slots[bucket[i]] = slot;
+        }
+        displacements[order[position]] = seed;
+        break;
+      }
+    }
+  }
+
+  let freeSlot = 0;
+  for (; position < count && buckets[order[position]].length === 1; position++) {
+    while (taken[freeSlot]) {
+      freeSlot++;
+    }
+    taken[freeSlot] = 1;
+    slots[buckets[order[position]][0]] = freeSlot;
+    displacements[order[position]] = -freeSlot - 1;
+  }
+
+  return { displacements, slots };
+}
+
+interface AssetArchiveOptions {
+  /** Encodings to precompress each asset with; a variant is kept only if smaller than the original. */
+  compression?: readonly ContentCompressionTypes[];
+  /** Reads an asset's contents, given its `fileInfo.assetPath`. */
+  readFile?: (assetPath: string) => Uint8Array;
+}
+
+/**
+ * Packs every asset in a manifest into a single archive, with a minimal perfect hash over asset keys,
+ * precomputed `Content-Type`, `ETag` and `Last-Modified` values and optional precompressed variants, for
+ * `AssetArchive.open` (`fastedge::assets`).
+ *
+ * @param staticAssetManifest - The manifest of assets to pack.
+ * @param options - Compression and file reading options.
+ * @returns The archive bytes.
+ */
+function createAssetArchive(
+  staticAssetManifest: StaticAssetManifest,
+  {
+    compression = [],
+    readFile = (assetPath) => readFileSync(assetPath),
+  }: AssetArchiveOptions = {},
+): Uint8Array {
+  const encoder = new TextEncoder();
+  const assets = Object.values(staticAssetManifest);
+  const keys = assets.map((asset) => encoder.encode(asset.assetKey));
+  const { displacements, slots } = createPerfectHash(keys);
+
+  // String table, with repeated values (mostly content types) stored once
+  const strings: Uint8Array[] = [];
+  const stringOffsets = new Map<string, number>();
+  let stringsLength = 0;
+  const addString = (value: string): [number, number] => {
+    let offset = stringOffsets.get(value);
+    const bytes = encoder.encode(value);
+    if (offset === undefined) {
+      offset = stringsLength;
+      stringOffsets.set(value, offset);
+      strings.push(bytes);
+      stringsLength += bytes.length;
+    }
+    return [offset, bytes.length];
+  };
+
+  const entries = new Uint32Array(assets.length * ENTRY_WORDS);
+  // Data blocks by offset in the data section: originals and variants
+  const contents: Array<[number, Uint8Array]> = [];
+  let dataLength = 0;
+  const addData = (bytes: Uint8Array): number => {
+    const offset = Math.ceil(dataLength / DATA_ALIGNMENT) * DATA_ALIGNMENT;
+    contents.push([offset, bytes]);
+    dataLength = offset + bytes.length;
+    return offset;
+  };
+  for (const [index, asset] of assets.entries()) {
+    const entry = slots[index] * ENTRY_WORDS;
+    const content = readFile(asset.fileInfo.assetPath);
+    const { lastModifiedTime } = asset.fileInfo;
+
+    [entries[entry + EntryField.PathOffset], entries[entry + EntryField.PathLength]] = addString(
+      asset.assetKey,
+    );
+    [entries[entry + EntryField.ContentTypeOffset], entries[entry + EntryField.ContentTypeLength]] =
+      addString(asset.contentType);
+    [entries[entry + EntryField.EtagOffset], entries[entry + EntryField.EtagLength]] = addString(
+      asset.fileInfo.hash,
+    );
+    [entries[entry + EntryField.LastModifiedOffset], entries[entry + EntryField.LastModifiedLength]] =
+      lastModifiedTime === 0 ? [0, 0] : addString(new Date(lastModifiedTime * 1000).toUTCString());
+    entries[entry + EntryField.LastModifiedTime] = lastModifiedTime;
+    entries[entry + EntryField.Flags] = asset.isText ? FLAG_IS_TEXT : 0;
+
+    entries[entry + EntryField.DataStart] = addData(content);
+    entries[entry + EntryField.DataLength] = content.length;
+
+    const variants = compressAsset(content, compression, asset.isText);
+    for (const [i, encoding] of ARCHIVE_ENCODINGS.entries()) {
+      const variant = variants[encoding];
+      if (variant != null) {
+        const field = entry + EntryField.VariantsStart + i * 2;
+        entries[field] = addData(variant);
+        entries[field + 1] = variant.length;
+      }
+    }
+  }
+
+  const displacementsOffset = HEADER_WORDS * 4;
+  const entriesOffset = displacementsOffset + assets.length * 4;
+  const stringsOffset = entriesOffset + entries.byteLength;
+  const dataOffset = Math.ceil((stringsOffset + stringsLength) / DATA_ALIGNMENT) * DATA_ALIGNMENT;
+  const totalLength = dataOffset + dataLength;
+
+  const archive = new Uint8Array(totalLength);
+  const view = new DataView(archive.buffer);
+  const header = [
+    ARCHIVE_MAGIC,
+    ARCHIVE_VERSION,
+    assets.length,
+    displacementsOffset,
+    entriesOffset,
+    stringsOffset,
+    dataOffset,
+    totalLength,
+  ];
+  for (const [i, value] of header.entries()) {
+    view.setUint32(i * 4, value, true);
+  }
+  for (const [i, value] of displacements.entries()) {
+    view.setInt32(displacementsOffset + i * 4, value, true);
+  }
+  for (const [i, value] of entries.entries()) {
+    view.setUint32(entriesOffset + i * 4, value, true);
+  }
+
+  let stringOffset = stringsOffset;
+  for (const bytes of strings) {
+    archive.set(bytes, stringOffset);
+    stringOffset += bytes.length;
+  }
+  for (const [offset, content] of contents) {
+    archive.set(content, dataOffset + offset);
+  }
+
+  return archive;
+}
+
+export { ARCHIVE_MAGIC, ARCHIVE_VERSION, createAssetArchive, EntryField, ENTRY_WORDS, hashAssetPath };
+export type { AssetArchiveOptions };
@@ -1,5 +1,7 @@
 import { writeFileSync } from 'node:fs';
 
+import { normalizeArchiveEncodings } from './compress-asset.ts';
+import { createAssetArchive } from './create-asset-archive.ts';
 import { createManifestFileMap, prettierObjectString } from './create-manifest-file-map.ts';
 
 import type { AssetCacheConfig, StaticAssetManifest } from './types.ts';
@@ -12,6 +14,11 @@ import { createOutputDirectory, isFile, resolveOsPath } from '~utils/file-system
  * Creates a Static Asset Manifest file. This is a pre-build step that generates a manifest of all static assets to be included in the build.
  * This `StaticAssetManifest` will be used to create an in memory StaticAssetCache stored in the binary during Wizer processing.
  *
+ * The same assets are also packed into a single archive next to the manifest (`<manifest name>.pack`), whose path the
+ * manifest file exports as `staticAssetArchive`. With `compression` set, the archive also holds precompressed variants
+ * of each asset. Passing that path to `createStaticServer` serves assets from the
+ * archive through the native `AssetArchive` lookup instead of a JS manifest object.
+ *
  * @param assetCacheConfig - The configuration for what files to include.
  * @returns An `AssetCache` instance containing the static assets.
  */
@@ -48,6 +55,7 @@ async function createStaticAssetsManifest(
   }
 
   const manifestBuildOutput = resolveOsPath(`.${outputPath}`);
+  const archivePath = outputPath.replace(/\.(js|ts|cjs|mjs)$/u, '.pack');
 
   await createOutputDirectory(manifestBuildOutput);
   const inlineAssetManifest = await createManifestFileMap(config);
@@ -67,11 +75,19 @@ async function createStaticAssetsManifest(
     ...readableAssetLines,
     '};',
     '',
-    'export { staticAssetManifest };',
+    `const staticAssetArchive = '.${archivePath}';`,
+    '',
+    'export { staticAssetArchive, staticAssetManifest };',
     '',
   ];
 
   writeFileSync(manifestBuildOutput, manifestFileContents.join('\n'));
+  writeFileSync(
+    resolveOsPath(`.${archivePath}`),
+    createAssetArchive(inlineAssetManifest, {
+      compression: normalizeArchiveEncodings(config.compression),
+    }),
+  );
 
   return inlineAssetManifest;
 }
@@ -84,6 +100,7 @@ function normalizeAssetCacheConfig(config: Partial<AssetCacheConfig>): AssetCach
     ignoreDotFiles: 'booleanTruthy',
     ignorePaths: 'pathsArray',
     ignoreWellKnown: 'booleanFalsy',
+    compression: 'stringArray',
   });
 }
 
@@ -7,6 +7,7 @@ interface AssetCacheConfig extends Record<string, unknown> {
   ignoreDotFiles: boolean;
   ignorePaths: string[];
   ignoreWellKnown: boolean;
+  compression: string[];
 }
 
 export type { AssetCacheConfig };
@@ -6,7 +6,9 @@ import type { StaticAssetManifest } from '~static-assets/asset-loader/create-sta
 // Mocks
 const mockGetStaticServer = jest.fn();
 const mockCreateStaticAssetsCache = jest.fn();
+const mockCreateArchiveAssetsCache = jest.fn();
 const mockNormalizeConfig = jest.fn();
+const mockOpenArchive = jest.fn();
 
 jest.mock('../static-server', () => ({
   getStaticServer: (...args: any[]) => mockGetStaticServer(...args),
@@ -14,6 +16,12 @@ jest.mock('../static-server', () => ({
 jest.mock('~static-assets/asset-loader/create-static-assets-cache', () => ({
   createStaticAssetsCache: (...args: any[]) => mockCreateStaticAssetsCache(...args),
 }));
+jest.mock('~static-assets/asset-loader/create-archive-assets-cache', () => ({
+  createArchiveAssetsCache: (...args: any[]) => mockCreateArchiveAssetsCache(...args),
+}));
+jest.mock('fastedge::assets', () => ({
+  AssetArchive: { open: (...args: any[]) => mockOpenArchive(...args) },
+}));
 jest.mock('~utils/config-helpers', () => ({
   normalizeConfig: (...args: any[]) => mockNormalizeConfig(...args),
 }));
@@ -51,6 +59,40 @@ describe('createStaticServer', () => {
     expect(result).toBe(staticServer);
   });
 
+  it('should open the archive with the server config when given an archive path', () => {
+    expect.assertions(4);
+    const normalizedConfig = {
+      extendedCache: [/\.js$/],
+      publicDirPrefix: '/public',
+      routePrefix: '/static',
+      compression: ['br', 'gzip'],
+      notFoundPage: null,
+      autoExt: ['.html'],
+      autoIndex: ['index.html'],
+      spaEntrypoint: null,
+    } as ServerConfig;
+    const archive = { serve: jest.fn() };
+    const assetCache = { archive: true };
+    mockNormalizeConfig.mockReturnValue(normalizedConfig);
+    mockOpenArchive.mockReturnValue(archive);
+    mockCreateArchiveAssetsCache.mockReturnValue(assetCache);
+    mockGetStaticServer.mockReturnValue({});
+
+    createStaticServer('./.fastedge/build/static-asset-manifest.pack', {});
+
+    expect(mockOpenArchive).toHaveBeenCalledWith('./.fastedge/build/static-asset-manifest.pack', {
+      autoExt: ['.html'],
+      autoIndex: ['index.html'],
+      compression: ['br', 'gzip'],
+      extendedCache: [/\.js$/],
+      publicDirPrefix: '/public',
+      routePrefix: '/static',
+    });
+    expect(mockCreateArchiveAssetsCache).toHaveBeenCalledWith(archive);
+    expect(mockCreateStaticAssetsCache).not.toHaveBeenCalled();
+    expect(mockGetStaticServer).toHaveBeenCalledWith(normalizedConfig, assetCache, archive);
+  });
+
   it('should pass all config keys to normalizeConfig', () => {
     expect.assertions(1);
     const manifest: StaticAssetManifest = { assets: {} } as any;
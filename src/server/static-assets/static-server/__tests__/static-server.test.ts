@@ -261,7 +261,7 @@ describe('getStaticServer', () => {
     });
 
     it('should set Content-Encoding if present', async () => {
-      expect.assertions(1);
+      expect.assertions(2);
       const storeEntry = {
         body: () => new Uint8Array([1, 2, 3]),
         contentEncoding: () => 'gzip',
@@ -277,6 +277,7 @@ describe('getStaticServer', () => {
       const req = makeRequest('http://localhost/public/test.html', 'GET');
       const resp = await server.serveAsset(req, asset, { cache: 'extended' });
       expect(resp.headers.get('Content-Encoding')).toBe('gzip');
+      expect(resp.headers.get('Vary')).toBe('Accept-Encoding');
     });
 
     it('should set Last-Modified if present', async () => {
@@ -325,6 +326,33 @@ describe('getStaticServer', () => {
       expect(resp?.status).toBe(200);
     });
 
+    it('should serve assets through the native server when one is given', async () => {
+      expect.assertions(3);
+      const nativeResponse = new Response('native', { status: 206 });
+      const nativeServer = { serve: jest.fn(() => nativeResponse) };
+      server = getStaticServer(serverConfig, mockAssetCache({}), nativeServer as any);
+
+      const req = makeRequest('http://localhost/public/test.html', 'GET', { Range: 'bytes=0-1' });
+      const resp = await server.serveRequest(req);
+      expect(resp).toBe(nativeResponse);
+      expect(nativeServer.serve).toHaveBeenCalledWith(req);
+
+      const spaAsset = mockAsset({
+        contentType: 'text/html',
+        fileInfo: { lastModifiedTime: 123 },
+      });
+      nativeServer.serve.mockReturnValue(null as any);
+      server = getStaticServer(
+        serverConfig,
+        mockAssetCache({ [serverConfig.spaEntrypoint!]: spaAsset }),
+        nativeServer as any,
+      );
+      const fallback = await server.serveRequest(
+        makeRequest('http://localhost/unknown', 'GET', { Accept: 'text/html' }),
+      );
+      expect(fallback?.status).toBe(200);
+    });
+
     it('should serve SPA entrypoint if asset not found and Accept: text/html', async () => {
       expect.assertions(2);
       const spaAsset = mockAsset({
@@ -1,23 +1,41 @@
+import { AssetArchive } from 'fastedge::assets';
+
 import { getStaticServer } from './static-server.ts';
 
 import type { ServerConfig, StaticServer } from './types.ts';
 import type { StaticAssetManifest } from '~static-assets/asset-loader/create-static-assets-cache.ts';
 
+import { createArchiveAssetsCache } from '~static-assets/asset-loader/create-archive-assets-cache.ts';
 import { createStaticAssetsCache } from '~static-assets/asset-loader/create-static-assets-cache.ts';
 import { normalizeConfig } from '~utils/config-helpers.ts';
 
 /**
  * Creates a static server instance, able to serve static assets.
  *
- * @param staticAssetManifest - The StaticAssetManifest generated from "npx fastedge-assets".
+ * @param staticAssetManifest - The StaticAssetManifest generated from "npx fastedge-assets", or the path of its packed
+ *   asset archive (`staticAssetArchive` from the same generated file).
  * @param serverConfig - The server configuration.
  * @returns A `StaticServer` instance.
  */
 const createStaticServer = (
-  staticAssetManifest: StaticAssetManifest,
+  staticAssetManifest: StaticAssetManifest | string,
   serverConfig: Partial<ServerConfig>,
 ): StaticServer => {
   const normalizedServerConfig = normalizeServerConfig(serverConfig);
+  if (typeof staticAssetManifest === 'string') {
+    // Archive-backed servers answer asset hits natively through `archive.serve`
+    const { autoExt, autoIndex, compression, extendedCache, publicDirPrefix, routePrefix } =
+      normalizedServerConfig;
+    const archive = AssetArchive.open(staticAssetManifest, {
+      autoExt,
+      autoIndex,
+      compression,
+      extendedCache,
+      publicDirPrefix,
+      routePrefix,
+    });
+    return getStaticServer(normalizedServerConfig, createArchiveAssetsCache(archive), archive);
+  }
   const assetCache = createStaticAssetsCache(staticAssetManifest);
   return getStaticServer(normalizedServerConfig, assetCache);
 };
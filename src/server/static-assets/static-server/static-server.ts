@@ -7,6 +7,7 @@ import {
 } from './headers.ts';
 
 import type { AssetInit, HeadersType, ServerConfig, StaticServer } from './types.ts';
+import type { AssetArchiveInstance } from 'fastedge::assets';
 import type { AssetCache } from '~static-assets/asset-loader/asset-cache/asset-cache.ts';
 
 import type {
@@ -106,14 +107,18 @@ const handlePreconditions = (
  *
  * @param serverConfig - The server configuration.
  * @param assetCache - The asset cache.
+ * @param nativeServer - An asset archive opened with this `serverConfig`; when given, asset hits are served by
+ *   `nativeServer.serve` and only fallback pages go through the JS path.
  * @returns A `StaticServer` instance.
  */
 const getStaticServer = <T = StaticServer>(
   serverConfig: ServerConfig,
   assetCache: AssetCache<StaticAsset>,
+  nativeServer?: AssetArchiveInstance,
 ): T => {
   const _serverConfig = serverConfig;
   const _assetCache = assetCache;
+  const _nativeServer = nativeServer;
   const _extendedCache = serverConfig.extendedCache;
 
   /**
@@ -273,6 +278,10 @@ const getStaticServer = <T = StaticServer>(
     if (contentEncoding != null) {
       headers['Content-Encoding'] = contentEncoding;
     }
+    if (_serverConfig.compression.length > 0) {
+      // The representation depends on Accept-Encoding whenever precompressed variants may be served
+      headers.Vary = 'Accept-Encoding';
+    }
 
     headers.ETag = storeEntry.hash();
     if (metadata.fileInfo.lastModifiedTime !== 0) {
@@ -296,14 +305,22 @@ const getStaticServer = <T = StaticServer>(
       return;
     }
 
-    const url = new URL(request.url);
-    const { pathname } = url;
+    if (_nativeServer == null) {
+      const url = new URL(request.url);
+      const { pathname } = url;
 
-    const asset = getMatchingAsset(pathname);
-    if (asset != null) {
-      return serveAsset(request, asset, {
-        cache: testExtendedCache(pathname) ? 'extended' : null,
-      });
+      const asset = getMatchingAsset(pathname);
+      if (asset != null) {
+        return serveAsset(request, asset, {
+          cache: testExtendedCache(pathname) ? 'extended' : null,
+        });
+      }
+    } else {
+      // Matching, preconditions, ranges and the response are all handled natively
+      const response = _nativeServer.serve(request);
+      if (response != null) {
+        return response;
+      }
     }
 
     // Fallback HTML responses, like SPA and "not found" pages
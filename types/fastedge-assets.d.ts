@@ -0,0 +1,139 @@
+declare module 'fastedge::assets' {
+  /**
+   * Native lookups into a packed static-asset archive.
+   *
+   * `fastedge-assets` writes the archive next to the asset manifest (`static-asset-manifest.pack` by default) and
+   * exports its path as `staticAssetArchive`. The archive holds every file's contents with its precomputed
+   * `Content-Type`, `ETag` and `Last-Modified` values, indexed by a minimal perfect hash over asset keys.
+   *
+   * An archive is opened during build-time initialization. Its bytes stay outside the JS heap, and `get` resolves a
+   * path with one or two hashes and a single comparison, and `serve` answers a whole request natively. Most apps
+   * use it through `createStaticServer`, which accepts the archive path in place of the manifest.
+   *
+   * @example
+   * ```js
+   * /// <reference types="@gcoredev/fastedge-sdk-js" />
+   *
+   * import { AssetArchive } from "fastedge::assets";
+   * import { staticAssetArchive } from "./.fastedge/build/static-asset-manifest.js";
+   *
+   * const assets = AssetArchive.open(staticAssetArchive);
+   *
+   * function app(event) {
+   *   const asset = assets.get(new URL(event.request.url).pathname);
+   *   if (!asset) {
+   *     return new Response("Not found", { status: 404 });
+   *   }
+   *   return new Response(asset.body, {
+   *     headers: { "Content-Type": asset.contentType, ETag: asset.etag },
+   *   });
+   * }
+   *
+   * addEventListener("fetch", event => event.respondWith(app(event)));
+   * ```
+   */
+  export const AssetArchive: {
+    /**
+     * Opens the archive at `path`. Throws if the file can't be read or isn't a valid archive.
+     *
+     * **Note**: This can only be invoked during build-time initialization.
+     *
+     * @param {string} path  Path of the archive file, e.g. `staticAssetArchive`.
+     * @param {AssetArchiveOptions} [options]  How `serve` maps request paths to assets.
+     *
+     * @returns {AssetArchiveInstance} The opened archive.
+     */
+    open(path: string, options?: AssetArchiveOptions): AssetArchiveInstance;
+  };
+
+  /** Options for `AssetArchive.open`, matching the static server's `ServerConfig` fields of the same names. */
+  export interface AssetArchiveOptions {
+    /** Request path prefix the assets are served under, removed before lookup. */
+    routePrefix?: string;
+    /** Prefix added to the request path to form the asset key, e.g. `"/public"`. */
+    publicDirPrefix?: string;
+    /** Extensions tried when a path has no matching asset, e.g. `[".html"]`. */
+    autoExt?: string[];
+    /** File names tried when a path names a directory, e.g. `["index.html"]`. */
+    autoIndex?: string[];
+    /** Paths (exact, or prefixes ending in `/`) and patterns served with `Cache-Control: max-age=31536000`. */
+    extendedCache?: Array<string | RegExp>;
+    /** Precompressed variants `serve` may send, from `"br"`, `"gzip"` and `"zstd"`. Defaults to none. */
+    compression?: string[];
+  }
+
+  /** An asset returned by `AssetArchiveInstance.get`. */
+  export interface AssetArchiveEntry {
+    /** The file's contents. A fresh copy; writing to it doesn't change the archive. */
+    body: Uint8Array;
+    /** Size of the file in bytes. */
+    size: number;
+    /** Value for the `Content-Type` header. */
+    contentType: string;
+    /** Value for the `ETag` header. */
+    etag: string;
+    /** Value for the `Last-Modified` header, or `null` if the modification time is unknown. */
+    lastModified: string | null;
+    /** Modification time in seconds since the Unix epoch, or `0` if unknown. */
+    lastModifiedTime: number;
+    /** Whether the file has a text content type. */
+    isText: boolean;
+    /**
+     * Precompressed variants built with the `compression` build option, by content encoding. Only variants smaller
+     * than the original are stored. Each `get` returns fresh copies.
+     */
+    encodings: { br?: Uint8Array; gzip?: Uint8Array; zstd?: Uint8Array };
+  }
+
+  /** An archive returned by `AssetArchive.open`. */
+  export interface AssetArchiveInstance {
+    /**
+     * The asset stored under `path`, or `null`.
+     *
+     * @param {string} path  An asset key such as `"/index.html"`.
+     *
+     * @returns {AssetArchiveEntry | null} The asset.
+     */
+    get(path: string): AssetArchiveEntry | null;
+
+    /**
+     * Whether the archive has an asset stored under `path`.
+     *
+     * @param {string} path  An asset key.
+     *
+     * @returns {boolean} `true` if `get(path)` would return an asset.
+     */
+    has(path: string): boolean;
+
+    /**
+     * Every asset key in the archive.
+     *
+     * @returns {string[]} The asset keys, in archive order.
+     */
+    keys(): string[];
+
+    /**
+     * Answers a `GET` or `HEAD` request for an archived asset without leaving native code.
+     *
+     * The request path is matched with the `routePrefix`, `publicDirPrefix`, `autoExt` and `autoIndex` options given
+     * to `open`. If the asset has precompressed variants allowed by the `compression` option, the one with the
+     * highest `Accept-Encoding` q-value (the smallest on ties) is sent with `Content-Encoding`, an ETag suffixed with
+     * the encoding (e.g. `"<hash>-br"`) and `Vary: Accept-Encoding`. The response carries `Content-Type`, `ETag`,
+     * `Last-Modified` and `Accept-Ranges` headers, and is:
+     *
+     * - `304` when `If-None-Match` or `If-Modified-Since` shows the client's copy is current.
+     * - `206` with `Content-Range` for a single `bytes=` range (`GET` only, honouring `If-Range`, whose entity tag
+     *   must match strongly: a weak `W/` tag never does).
+     * - `416` when the range lies outside the file.
+     * - `200` otherwise. The body is a copy of the served bytes.
+     *
+     * @param {Request} request  The incoming request.
+     *
+     * @returns {Response | null} The response, or `null` for other methods and paths with no asset.
+     */
+    serve(request: Request): Response | null;
+
+    /** Number of assets. */
+    readonly size: number;
+  }
+}
@@ -0,0 +1,68 @@
+declare module 'fastedge::codec' {
+  /**
+   * Native decoders for compact binary formats written by other services.
+   *
+   * Decoding runs in the runtime rather than in a JS library, and builds
+   * the result objects directly from the input bytes.
+   *
+   * Mapping to JS values:
+   *
+   * - maps become plain objects; keys must be strings or numbers.
+   * - arrays become arrays; byte strings become `Uint8Array`.
+   * - integers outside the safe-integer range become `BigInt`.
+   * - MessagePack timestamps (extension type -1) and CBOR epoch times
+   *   (tag 1) become `Date`. CBOR bignums (tags 2 / 3) up to 64 bits
+   *   become `BigInt`. Other CBOR tags decode to their content; other
+   *   MessagePack extension types throw.
+   *
+   * Truncated input, trailing bytes and nesting deeper than 256 levels
+   * throw an `Error`.
+   *
+   * @example
+   * ```js
+   * /// <reference types="@gcoredev/fastedge-sdk-js" />
+   *
+   * import { Codec } from "fastedge::codec";
+   *
+   * async function app(event) {
+   *   const body = await event.request.arrayBuffer();
+   *   const payload = Codec.decodeMsgpack(body);
+   *   return Response.json(payload);
+   * }
+   *
+   * addEventListener("fetch", event => event.respondWith(app(event)));
+   * ```
+   */
+  export const Codec: {
+    /**
+     * Decodes a single value in the given format.
+     *
+     * @param {ArrayBuffer | ArrayBufferView} bytes  The encoded document.
+     * @param {CodecFormat} format  `'msgpack'` or `'cbor'`.
+     *
+     * @returns {T} The decoded value.
+     */
+    decode<T = unknown>(bytes: ArrayBuffer | ArrayBufferView, format: CodecFormat): T;
+
+    /**
+     * Decodes a single MessagePack value.
+     *
+     * @param {ArrayBuffer | ArrayBufferView} bytes  The encoded document.
+     *
+     * @returns {T} The decoded value.
+     */
+    decodeMsgpack<T = unknown>(bytes: ArrayBuffer | ArrayBufferView): T;
+
+    /**
+     * Decodes a single CBOR data item.
+     *
+     * @param {ArrayBuffer | ArrayBufferView} bytes  The encoded document.
+     *
+     * @returns {T} The decoded value.
+     */
+    decodeCbor<T = unknown>(bytes: ArrayBuffer | ArrayBufferView): T;
+  };
+
+  /** Binary formats understood by `Codec` and `KvStore.getDecoded`. */
+  export type CodecFormat = 'msgpack' | 'cbor';
+}
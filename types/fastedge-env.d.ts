@@ -4,6 +4,9 @@ declare module 'fastedge::env' {
    *
    * **Note**: The environment variables can only be retrieved when processing requests, not during build-time initialization.
    *
+   * Values don't change while an instance is running, so each name is fetched from the platform once and
+   * later calls return the cached value.
+   *
    * @param {string} name - The name of the environment variable.
    * @returns {string | null} The value of the environment variable, or `null` if not set.
    *
@@ -26,4 +29,31 @@ declare module 'fastedge::env' {
    * ```
    */
   function getEnv(name: string): string | null;
+
+  /**
+   * Environment variables as a read-only object, e.g. `env.API_HOST`.
+   *
+   * Each variable is looked up on first access and then kept as a plain property, so repeated reads (such as
+   * a config layer reading the same 20–40 names on every request) don't call into the platform. Variables
+   * that aren't set read as `undefined`.
+   *
+   * The object can be imported and kept at module scope, but its properties can only be read when processing
+   * requests; during build-time initialization every property reads as `undefined`. Only variables that have
+   * been read appear in `Object.keys(env)`.
+   *
+   * @example
+   * ```js
+   * /// <reference types="@gcoredev/fastedge-sdk-js" />
+   *
+   * import { env } from "fastedge::env";
+   *
+   * function app(event) {
+   *   const origin = env.ORIGIN_HOST ?? "origin.example.com";
+   *   return fetch(`https://${origin}${new URL(event.request.url).pathname}`);
+   * }
+   *
+   * addEventListener("fetch", event => event.respondWith(app(event)));
+   * ```
+   */
+  const env: Readonly<Record<string, string | undefined>>;
 }
@@ -5,6 +5,10 @@ declare module 'fastedge::fs' {
    *
    * **Note**: This can only be invoked during build-time initialization.
    *
+   * The file's bytes are kept outside the JS heap, and each call returns a view of them rather than a
+   * copy. Reading the same path again returns a new `Uint8Array` over the same bytes, so writes through
+   * one are visible through the other; treat the result as read-only.
+   *
    * @param {string} path The path to the file
    * @returns {Uint8Array} Byte array of the file contents
    *
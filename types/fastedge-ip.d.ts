@@ -0,0 +1,66 @@
+declare module 'fastedge::ip' {
+  /**
+   * Native IP prefix matching for allow / deny lists.
+   *
+   * A set is compiled once, typically at module scope so it is built
+   * during initialization, and then answers `contains` with a binary
+   * search. Lists with hundreds of thousands of prefixes stay cheap to
+   * query on every request.
+   *
+   * @example
+   * ```js
+   * /// <reference types="@gcoredev/fastedge-sdk-js" />
+   *
+   * import { readFileSync } from "fastedge::fs";
+   * import { CidrSet } from "fastedge::ip";
+   *
+   * const denyList = CidrSet.compile(readFileSync("/deny-list.txt"));
+   *
+   * async function app(event) {
+   *   if (denyList.contains(event.client.ip)) {
+   *     return new Response("Forbidden", { status: 403 });
+   *   }
+   *   return fetch(event.request);
+   * }
+   *
+   * addEventListener("fetch", event => event.respondWith(app(event)));
+   * ```
+   */
+  export const CidrSet: {
+    /**
+     * Compiles a list of IPv4 / IPv6 prefixes (`10.0.0.0/8`,
+     * `2001:db8::/32`). A bare address matches only itself. Host bits below
+     * the prefix length are ignored.
+     *
+     * A string source (or its bytes) holds one entry per line or
+     * comma-separated entries. `#` starts a comment and blank lines are
+     * skipped. Throws an `Error` naming the first invalid entry.
+     *
+     * @param {string[] | string | ArrayBuffer | ArrayBufferView} source
+     *   The prefixes: an array, a list in text form, or the bytes of one
+     *   (e.g. from `readFileSync` or `KvStore.get`).
+     *
+     * @returns {CidrSetInstance} The compiled set.
+     */
+    compile(source: string[] | string | ArrayBuffer | ArrayBufferView): CidrSetInstance;
+  };
+
+  /** A compiled prefix set returned by `CidrSet.compile`. */
+  export interface CidrSetInstance {
+    /**
+     * Whether `address` falls inside any prefix of the set.
+     *
+     * IPv4-mapped IPv6 addresses match IPv4 prefixes. `null`, `undefined`
+     * and strings that aren't IP addresses return `false`.
+     *
+     * @param {Uint8Array | string | null} address  `event.client.ip`, a 4- or
+     *   16-byte address, or an address in text form.
+     *
+     * @returns {boolean} `true` if the set contains the address.
+     */
+    contains(address: Uint8Array | string | null | undefined): boolean;
+
+    /** Number of prefixes the set was compiled from. */
+    readonly size: number;
+  }
+}
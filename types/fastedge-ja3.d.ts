@@ -0,0 +1,74 @@
+declare module 'fastedge::ja3' {
+  /**
+   * Native JA3 fingerprint lookups for bot mitigation.
+   *
+   * A set is compiled once from fingerprint lists, typically at module
+   * scope so it is built during initialization and kept in the snapshot.
+   * `classify` is a constant-time, allocation-free hash lookup.
+   *
+   * @example
+   * ```js
+   * /// <reference types="@gcoredev/fastedge-sdk-js" />
+   *
+   * import { readFileSync } from "fastedge::fs";
+   * import { Ja3Set } from "fastedge::ja3";
+   *
+   * const fingerprints = Ja3Set.compile({
+   *   good: readFileSync("/ja3-good.txt"),
+   *   bad: readFileSync("/ja3-bad.txt"),
+   * });
+   *
+   * async function app(event) {
+   *   if (fingerprints.classify(event.client.tlsJA3MD5) === "bad") {
+   *     return new Response("Forbidden", { status: 403 });
+   *   }
+   *   return fetch(event.request);
+   * }
+   *
+   * addEventListener("fetch", event => event.respondWith(app(event)));
+   * ```
+   */
+  export const Ja3Set: {
+    /**
+     * Compiles JA3 fingerprints (32-character MD5 hex strings) into a set.
+     *
+     * A single list holds one entry per line: the fingerprint, optionally
+     * followed by its label after whitespace or a comma. Entries without a
+     * label get `"match"`. `#` starts a comment and blank lines are skipped.
+     * The list can be a string, its bytes (e.g. from `readFileSync` or
+     * `KvStore.get`) or an array of lines.
+     *
+     * An object instead maps each label to a list of fingerprints in any of
+     * those forms. When a fingerprint appears more than once, the last label
+     * wins. Throws an `Error` naming the first invalid fingerprint.
+     *
+     * @param {Ja3ListSource | Record<string, Ja3ListSource>} source  The
+     *   fingerprints, either as one labelled list or grouped by label.
+     *
+     * @returns {Ja3SetInstance} The compiled set.
+     */
+    compile(source: Ja3ListSource | Record<string, Ja3ListSource>): Ja3SetInstance;
+  };
+
+  /** A fingerprint list accepted by `Ja3Set.compile`. */
+  export type Ja3ListSource = string[] | string | ArrayBuffer | ArrayBufferView;
+
+  /** A compiled fingerprint set returned by `Ja3Set.compile`. */
+  export interface Ja3SetInstance {
+    /**
+     * The label of `fingerprint`, or `null` if it isn't in the set.
+     *
+     * Malformed fingerprints, including the empty string that
+     * `event.client.tlsJA3MD5` holds for non-TLS requests, return `null`.
+     *
+     * @param {string | Uint8Array} fingerprint  An MD5 hex string such as
+     *   `event.client.tlsJA3MD5`, or the 16 digest bytes.
+     *
+     * @returns {string | null} The label the fingerprint was compiled with.
+     */
+    classify(fingerprint: string | Uint8Array): string | null;
+
+    /** Number of distinct fingerprints in the set. */
+    readonly size: number;
+  }
+}
@@ -36,11 +36,93 @@ declare module 'fastedge::kv' {
     /**
      * Static method to open a store and return an instance
      *
+     * The underlying host store is opened once per instance and reused by
+     * every later `open(name)` call, so it is cheap to call per request.
+     * The host handle stays open until {@link KvStoreInstance.close} is
+     * called; `open(name)` after `close()` reopens it. Stores can't be
+     * opened during build-time initialization; call `open` from the
+     * request handler.
+     *
      * @param {string} name  The name of the KV store as defined on your application.
      *
      * @returns {KvStoreInstance} The KvStore instance for the opened store.
      */
     static open(name: string): KvStoreInstance;
+
+    /**
+     * Opens a read-only, in-memory mirror of a small store.
+     *
+     * The first call in an instance loads every key into memory; later
+     * calls for the same name share that copy. Lookups on the mirror make
+     * no host calls. Once `refreshMs` has elapsed, the next lookup is
+     * still answered from the current copy, and the reload then runs
+     * synchronously on that same request after its code yields. There is
+     * no background refresh: the first request after the mirror goes
+     * stale makes one host call per key and its response waits for them,
+     * so choose `refreshMs` with the store size in mind. If a reload fails,
+     * the previous copy keeps being served. Sorted sets are pulled in full
+     * the first time `zrangeByScore` touches them.
+     *
+     * A load fails if the host returns an error for any key's `get`,
+     * including keys that hold sorted sets or Bloom filters if the host
+     * reports those as errors.
+     *
+     * Intended for stores under a few megabytes (redirects, tenant config,
+     * allow-lists). Stores larger than 16 MB are rejected.
+     *
+     * @param {string} name  The name of the KV store as defined on your application.
+     * @param {KvMirrorOptions} [options]  Refresh interval.
+     *
+     * @returns {KvMirrorInstance} The mirror for the store.
+     *
+     * @example
+     * ```js
+     * const redirects = KvStore.openMirrored("redirects", { refreshMs: 30000 });
+     * const target = redirects.getText(new URL(event.request.url).pathname);
+     * ```
+     */
+    static openMirrored(name: string, options?: KvMirrorOptions): KvMirrorInstance;
+  }
+
+  export interface KvMirrorOptions {
+    /**
+     * Milliseconds between reloads of the mirror. Defaults to 60000.
+     */
+    refreshMs?: number;
+  }
+
+  /**
+   * Read-only in-memory copy of a KV store, returned by
+   * `KvStore.openMirrored`.
+   */
+  export interface KvMirrorInstance {
+    /** Same as `KvStoreInstance.get`, answered from memory. */
+    get(key: string): ArrayBuffer | null;
+
+    /** Same as `KvStoreInstance.getText`, answered from memory. */
+    getText(key: string): string | null;
+
+    /** Same as `KvStoreInstance.getJSON`, answered from memory. */
+    getJSON<T = unknown>(key: string): T | null;
+
+    /**
+     * Returns the keys matching a Redis-style glob `pattern` (`*`, `?`,
+     * `[abc]` / `[^abc]` / `[a-z]` classes and `\` escapes), in sorted
+     * order. Unlike `KvStoreInstance.scan`, wildcards are not limited to
+     * the end of the pattern.
+     */
+    scan(pattern: string): Array<string>;
+
+    /** Same as `KvStoreInstance.zrangeByScore`, answered from memory. */
+    zrangeByScore(
+      key: string,
+      min: number,
+      max: number,
+      options?: KvZRangeOptions,
+    ): Array<[ArrayBuffer, number]>;
+
+    /** Reloads the mirror from the store immediately. */
+    refresh(): void;
   }
 
   /**
@@ -67,6 +149,98 @@ declare module 'fastedge::kv' {
     json(): Promise<unknown>;
   }
 
+  /**
+   * Options for {@link KvStoreInstance.scanIter} and
+   * {@link KvStoreInstance.zscanIter}.
+   */
+  export interface KvScanOptions {
+    /**
+     * Maximum number of items per page. Defaults to `100`.
+     */
+    count?: number;
+  }
+
+  /**
+   * Options for the `zrangeByScore` family of methods.
+   */
+  export interface KvZRangeOptions {
+    /** Number of matching members to skip. Defaults to `0`. */
+    offset?: number;
+    /** Maximum number of members to return. Defaults to all. */
+    count?: number;
+    /**
+     * Return members from highest to lowest score. `offset` and `count`
+     * then apply from the high end of the range.
+     */
+    reverse?: boolean;
+    /** Exclude members whose score equals `min`. */
+    minExclusive?: boolean;
+    /** Exclude members whose score equals `max`. */
+    maxExclusive?: boolean;
+  }
+
+  /**
+   * Sorted-set members packed into three typed arrays, as returned by
+   * {@link KvStoreInstance.zrangeByScoreColumnar} and
+   * {@link KvStoreInstance.zscanColumnar}.
+   *
+   * Member `i` is `values.subarray(offsets[i], offsets[i + 1])` and its
+   * score is `scores[i]`. `offsets` has one more element than `scores`.
+   */
+  export interface KvZListColumnar {
+    /** Every member's bytes, back to back. */
+    values: Uint8Array;
+    /** Start offset of each member in `values`, plus the total length. */
+    offsets: Uint32Array;
+    /** Score of each member. */
+    scores: Float64Array;
+  }
+
+  export interface BloomExistsCacheOptions {
+    /**
+     * Seconds before memoised answers are dropped and re-fetched.
+     * Defaults to 60.
+     */
+    ttl?: number;
+  }
+
+  export interface BloomExistsCache {
+    /** Checks whether `value` is in the Bloom filter. */
+    has(value: string): boolean;
+
+    /**
+     * Checks each of `values`, fetching any not yet memoised in one batch.
+     *
+     * @returns {boolean[]} One result per value, in order.
+     */
+    hasMany(values: string[]): boolean[];
+  }
+
+  /**
+   * Options for `zmerge`. Same as `KvZRangeOptions`, with `limit` as the
+   * preferred name for `count`.
+   */
+  export interface KvZMergeOptions extends KvZRangeOptions {
+    /** Maximum number of merged members to return. */
+    limit?: number;
+  }
+
+  export interface KvGeoNearbyOptions {
+    /** Maximum number of matches to return. */
+    limit?: number;
+  }
+
+  export interface KvGeoMatch {
+    /** The sorted-set member, decoded as UTF-8. */
+    member: string;
+    /** Great-circle distance from the search centre, in kilometres. */
+    distanceKm: number;
+    /** Member latitude decoded from its geohash score. */
+    latitude: number;
+    /** Member longitude decoded from its geohash score. */
+    longitude: number;
+  }
+
   export interface KvStoreInstance {
     /**
      * Retrieves the value associated with the given key from the KV store.
@@ -101,6 +275,56 @@ declare module 'fastedge::kv' {
      */
     getEntry(key: string): Promise<KvStoreEntry | null>;
 
+    /**
+     * Retrieves the value for the given key decoded as a UTF-8 string.
+     *
+     * The value is decoded straight from the host buffer, without an
+     * intermediate `Uint8Array` or `TextDecoder` pass.
+     *
+     * @param {string} key  The key to retrieve the value for.
+     *
+     * @returns {string | null} The decoded value, or `null` if the key is not present.
+     */
+    getText(key: string): string | null;
+
+    /**
+     * Retrieves the value for the given key parsed as JSON.
+     *
+     * The value is parsed straight from the host buffer, without an
+     * intermediate `Uint8Array` or string when it is ASCII.
+     *
+     * @param {string} key  The key to retrieve the value for.
+     *
+     * @returns {T | null} The parsed value, or `null` if the key is not present.
+     *
+     * @throws {SyntaxError} If the value is not valid JSON.
+     *
+     * @example
+     * ```js
+     * const config = kv.getJSON("config:routing");
+     * ```
+     */
+    getJSON<T = unknown>(key: string): T | null;
+
+    /**
+     * Retrieves the value for the given key decoded from MessagePack or CBOR.
+     *
+     * The value is decoded natively, straight from the host buffer. There is
+     * no intermediate `Uint8Array` and no JS-level parser. Decoding follows
+     * the same rules as `Codec.decode` from `fastedge::codec`.
+     *
+     * @param {string} key  The key to retrieve the value for.
+     * @param {'msgpack' | 'cbor'} format  The encoding of the stored value.
+     *
+     * @returns {T | null} The decoded value, or `null` if the key is not present.
+     *
+     * @example
+     * ```js
+     * const profile = kv.getDecoded("profile:42", "msgpack");
+     * ```
+     */
+    getDecoded<T = unknown>(key: string, format: 'msgpack' | 'cbor'): T | null;
+
     /**
      * Retrieves all key prefix matches from the KV store.
      *
@@ -110,18 +334,57 @@ declare module 'fastedge::kv' {
      */
     scan(pattern: string): Array<string>;
 
+    /**
+     * Iterates key prefix matches from the KV store one page at a time.
+     *
+     * Unlike `scan`, only one page of keys is converted to JS values at a
+     * time, so wide prefixes don't create every JS string up front.
+     *
+     * The host has no cursor-based scan, so the full list of matching keys
+     * is still fetched from the host when `scanIter` is called and held in
+     * instance memory until the iterator finishes. Paging bounds the JS
+     * heap, not the host round trip or the native buffer.
+     *
+     * @param {string} pattern  The prefix pattern to match keys against. e.g. 'foo*' ( Must include wildcard )
+     * @param {KvScanOptions} [options]  Page size (`count`).
+     *
+     * @returns {AsyncIterableIterator<Array<string>>} An async iterator yielding pages of matching keys.
+     *
+     * @example
+     * ```js
+     * for await (const keys of kv.scanIter("user:*", { count: 500 })) {
+     *   for (const key of keys) {
+     *     // ...
+     *   }
+     * }
+     * ```
+     */
+    scanIter(pattern: string, options?: KvScanOptions): AsyncIterableIterator<Array<string>>;
+
     /**
      * Retrieves all the values from ZSet with scores between the given range.
      *
      * @param {string} key  The key for the Sorted Set.
      * @param {number} min  The minimum score for the range.
      * @param {number} max  The maximum score for the range.
+     * @param {KvZRangeOptions} [options]  Paging, ordering and exclusive bounds.
      *
      * @returns {Array<[ArrayBuffer, number]>} Array of [value, score] tuples within range for the key, or an empty array if none found.
      *
      * @see {@link KvStoreInstance.zrangeByScoreEntries} for an entry-style API with `text()` / `json()` helpers.
+     *
+     * @example
+     * ```js
+     * // Top 10 by score
+     * const top = kv.zrangeByScore("board", -Infinity, Infinity, { reverse: true, count: 10 });
+     * ```
      */
-    zrangeByScore(key: string, min: number, max: number): Array<[ArrayBuffer, number]>;
+    zrangeByScore(
+      key: string,
+      min: number,
+      max: number,
+      options?: KvZRangeOptions,
+    ): Array<[ArrayBuffer, number]>;
 
     /**
      * Retrieves all values from a Sorted Set with scores between the given
@@ -133,6 +396,7 @@ declare module 'fastedge::kv' {
      * @param {string} key  The key for the Sorted Set.
      * @param {number} min  The minimum score for the range.
      * @param {number} max  The maximum score for the range.
+     * @param {KvZRangeOptions} [options]  Paging, ordering and exclusive bounds.
      *
      * @returns {Promise<Array<[KvStoreEntry, number]>>} Array of
      *   [entry, score] tuples within range, or an empty array if none found.
@@ -141,8 +405,40 @@ declare module 'fastedge::kv' {
       key: string,
       min: number,
       max: number,
+      options?: KvZRangeOptions,
     ): Promise<Array<[KvStoreEntry, number]>>;
 
+    /**
+     * Retrieves all values from a Sorted Set with scores between the given
+     * range, packed into typed arrays.
+     *
+     * Same members as `zrangeByScore(key, min, max)`, but the result is a
+     * fixed three-array layout instead of one tuple per member. Prefer it
+     * for large ranges where per-member allocation dominates.
+     *
+     * @param {string} key  The key for the Sorted Set.
+     * @param {number} min  The minimum score for the range.
+     * @param {number} max  The maximum score for the range.
+     * @param {KvZRangeOptions} [options]  Paging, ordering and exclusive bounds.
+     *
+     * @returns {KvZListColumnar} The members in range, in columnar form.
+     *
+     * @example
+     * ```js
+     * const { values, offsets, scores } = kv.zrangeByScoreColumnar("board", 0, Infinity);
+     * for (let i = 0; i < scores.length; i++) {
+     *   const member = values.subarray(offsets[i], offsets[i + 1]);
+     *   // ...
+     * }
+     * ```
+     */
+    zrangeByScoreColumnar(
+      key: string,
+      min: number,
+      max: number,
+      options?: KvZRangeOptions,
+    ): KvZListColumnar;
+
     /**
      * Retrieves all value prefix matches from the KV ZSet.
      *
@@ -175,6 +471,100 @@ declare module 'fastedge::kv' {
       pattern: string,
     ): Promise<Array<[KvStoreEntry, number]>>;
 
+    /**
+     * Retrieves all value prefix matches from a Sorted Set, packed into
+     * typed arrays. Columnar counterpart of `zscan`.
+     *
+     * @param {string} key      The key for the Sorted Set.
+     * @param {string} pattern  The prefix pattern to match values against.
+     *                          e.g. 'foo*' (must include wildcard).
+     *
+     * @returns {KvZListColumnar} The matching members, in columnar form.
+     */
+    zscanColumnar(key: string, pattern: string): KvZListColumnar;
+
+    /**
+     * Iterates value prefix matches from a Sorted Set one page at a time.
+     *
+     * Page-at-a-time counterpart of `zscan`: only one page of
+     * [value, score] tuples is converted to JS values at a time. As with
+     * `scanIter`, the full match list is fetched from the host up front;
+     * only the JS conversion is paged.
+     *
+     * @param {string} key      The key for the Sorted Set.
+     * @param {string} pattern  The prefix pattern to match values against.
+     *                          e.g. 'foo*' (must include wildcard).
+     * @param {KvScanOptions} [options]  Page size (`count`).
+     *
+     * @returns {AsyncIterableIterator<Array<[ArrayBuffer, number]>>} An
+     *   async iterator yielding pages of [value, score] tuples.
+     */
+    zscanIter(
+      key: string,
+      pattern: string,
+      options?: KvScanOptions,
+    ): AsyncIterableIterator<Array<[ArrayBuffer, number]>>;
+
+    /**
+     * Merges the score ranges of several sorted sets into one ordered list
+     * and returns only the requested window.
+     *
+     * Each shard is fetched already trimmed to `offset + limit` members.
+     * The shards are then merged natively with a k-way heap, so only the
+     * returned members are materialised as JS values. Members with equal
+     * scores keep the order of `keys`.
+     *
+     * @param {string[]} keys  The sorted-set keys to merge.
+     * @param {number} min  The minimum score (inclusive by default).
+     * @param {number} max  The maximum score (inclusive by default).
+     * @param {KvZMergeOptions} [options]  Window, order and bound exclusivity.
+     *
+     * @returns {Array<[ArrayBuffer, number]>} The merged [value, score] tuples.
+     *
+     * @example
+     * ```js
+     * const shards = Array.from({ length: 16 }, (_, i) => `leaderboard:${i}`);
+     * const top10 = kv.zmerge(shards, -Infinity, Infinity, { limit: 10, reverse: true });
+     * ```
+     */
+    zmerge(
+      keys: string[],
+      min: number,
+      max: number,
+      options?: KvZMergeOptions,
+    ): Array<[ArrayBuffer, number]>;
+
+    /**
+     * Finds members of a geo sorted set within `radiusKm` of a point,
+     * nearest first.
+     *
+     * Members are expected to be stored the way Redis `GEOADD` stores
+     * them: the score is the 52-bit interleaved geohash of the position.
+     * The lookup scans only the geohash cells around the point. Distances
+     * are haversine great-circle distances computed natively.
+     *
+     * @param {string} key  The geo sorted-set key.
+     * @param {number} latitude  Latitude of the search centre, in degrees.
+     * @param {number} longitude  Longitude of the search centre, in degrees.
+     * @param {number} radiusKm  Search radius in kilometres.
+     * @param {KvGeoNearbyOptions} [options]  Result limit.
+     *
+     * @returns {KvGeoMatch[]} Matches sorted by ascending distance.
+     *
+     * @example
+     * ```js
+     * const { latitude, longitude } = event.client.geo;
+     * const [nearest] = kv.geoNearby("origins", latitude, longitude, 500, { limit: 1 });
+     * ```
+     */
+    geoNearby(
+      key: string,
+      latitude: number,
+      longitude: number,
+      radiusKm: number,
+      options?: KvGeoNearbyOptions,
+    ): KvGeoMatch[];
+
     /**
      * Checks if a given value exists within the KV stores Bloom Filter.
      *
@@ -184,5 +574,52 @@ declare module 'fastedge::kv' {
      * @returns {boolean} True if the value exists, false otherwise.
      */
     bfExists(key: string, value: string): boolean;
+
+    /**
+     * Checks several values against the KV store's Bloom filter in a single
+     * call.
+     *
+     * @param {string} key  The key for the Bloom filter.
+     * @param {string[]} values  The values to check.
+     *
+     * @returns {boolean[]} One result per value, in order.
+     */
+    bfExistsMany(key: string, values: string[]): boolean[];
+
+    /**
+     * Returns a `BloomExistsCache` for the Bloom filter at `key`. It answers
+     * membership checks from instance memory.
+     *
+     * Each distinct value costs one host lookup per TTL window. Repeat
+     * checks within the window make no host call. This is a cache of
+     * per-value answers, not a copy of the filter: the host has no call
+     * that returns the filter's bit array. The cache is shared
+     * by every request served by the same instance. Items added to the
+     * filter in the meantime can report `false` until the TTL lapses.
+     *
+     * @param {string} key  The key for the Bloom filter.
+     * @param {BloomExistsCacheOptions} [options]  Cache lifetime.
+     *
+     * @returns {BloomExistsCache} The exists cache for `key`.
+     *
+     * @example
+     * ```js
+     * const bots = kv.bfExistsCache("bot-signals", { ttl: 30 });
+     * const [ip, ja3] = bots.hasMany([clientIp, ja3Hash]);
+     * ```
+     */
+    bfExistsCache(key: string, options?: BloomExistsCacheOptions): BloomExistsCache;
+
+    /**
+     * Releases the host handle for this store.
+     *
+     * Every instance returned by `KvStore.open(name)` for the same name
+     * shares one handle, so after `close()` all of them throw "KvStore is
+     * closed" until `KvStore.open(name)` is called again. Mirrors and
+     * exists caches built from the store keep what they already hold but fail
+     * when they next need the host. Calling `close()` more than once has
+     * no further effect.
+     */
+    close(): void;
   }
 }
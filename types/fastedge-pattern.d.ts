@@ -0,0 +1,106 @@
+declare module 'fastedge::pattern' {
+  /**
+   * Native multi-pattern matching for URL, header and body screening.
+   *
+   * A rule list is compiled once into an Aho-Corasick automaton, typically
+   * at module scope so compilation happens during initialization and the
+   * automaton is kept in the snapshot. Each input is then scanned in a
+   * single pass for every rule at once, instead of running one regular
+   * expression per rule.
+   *
+   * Patterns are literal substrings, not regular expressions: each is a
+   * byte string (UTF-8 for string patterns) matched anywhere in the input,
+   * and no character has a special meaning. `compile` rejects patterns that
+   * look like regular expressions (a leading `^`, a trailing `$`, `.*`,
+   * `.+`, `(?`, or a quantified class escape such as `\d+`), since as
+   * literals they would almost never match. Rules that need
+   * regular-expression features can use a `PatternSet` of their literal
+   * fragments as a prefilter and run the full `RegExp` only on inputs that
+   * match.
+   *
+   * @example
+   * ```js
+   * /// <reference types="@gcoredev/fastedge-sdk-js" />
+   *
+   * import { PatternSet } from "fastedge::pattern";
+   *
+   * const waf = PatternSet.compile(
+   *   [
+   *     { id: "sqli-union", pattern: "union select" },
+   *     { id: "xss-script", pattern: "<script" },
+   *     { id: "traversal", pattern: "../" },
+   *   ],
+   *   { caseInsensitive: true },
+   * );
+   *
+   * async function app(event) {
+   *   const hits = waf.scan(decodeURIComponent(event.request.url));
+   *   if (hits.length > 0) {
+   *     return new Response(`Blocked: ${hits.join(", ")}`, { status: 403 });
+   *   }
+   *   return fetch(event.request);
+   * }
+   *
+   * addEventListener("fetch", event => event.respondWith(app(event)));
+   * ```
+   */
+  export const PatternSet: {
+    /**
+     * Compiles a rule list. Each rule is either a pattern string, whose ID
+     * is its index in the list, or `{ id, pattern }`. Empty patterns throw,
+     * as do patterns that look like regular expressions unless
+     * `allowRegexSyntax` is set.
+     *
+     * @param {Array<string | PatternRule>} rules  The rules to match.
+     * @param {PatternSetOptions} [options]  Compile options.
+     *
+     * @returns {PatternSetInstance} The compiled set.
+     */
+    compile(rules: Array<string | PatternRule>, options?: PatternSetOptions): PatternSetInstance;
+  };
+
+  /** A rule for `PatternSet.compile`. */
+  export interface PatternRule {
+    /** Returned by `scan` when the rule matches. Defaults to the rule's index. */
+    id?: string | number;
+    /** Literal substring to find. Not a regular expression. */
+    pattern: string;
+  }
+
+  /** Options for `PatternSet.compile`. */
+  export interface PatternSetOptions {
+    /** Match ASCII letters case-insensitively. Defaults to `false`. */
+    caseInsensitive?: boolean;
+    /**
+     * Accept patterns that look like regular expressions and match them as
+     * literal text. Defaults to `false`, which makes `compile` throw on them.
+     */
+    allowRegexSyntax?: boolean;
+  }
+
+  /** A compiled rule set returned by `PatternSet.compile`. */
+  export interface PatternSetInstance {
+    /**
+     * IDs of every rule whose pattern occurs in `input`, each once, in rule
+     * order. The scan stops early once every rule has matched.
+     *
+     * @param {string | ArrayBuffer | ArrayBufferView} input  Text (scanned
+     *   as UTF-8) or raw bytes, such as a request body.
+     *
+     * @returns {Array<string | number>} The matched rule IDs.
+     */
+    scan(input: string | ArrayBuffer | ArrayBufferView): Array<string | number>;
+
+    /**
+     * Whether any rule matches `input`. Stops at the first match.
+     *
+     * @param {string | ArrayBuffer | ArrayBufferView} input  Text or bytes.
+     *
+     * @returns {boolean} `true` if some pattern occurs in `input`.
+     */
+    test(input: string | ArrayBuffer | ArrayBufferView): boolean;
+
+    /** Number of rules in the set. */
+    readonly size: number;
+  }
+}
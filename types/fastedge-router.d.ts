@@ -0,0 +1,87 @@
+declare module 'fastedge::router' {
+  /**
+   * Native request router.
+   *
+   * Routes are compiled once into a segment tree, typically at module scope
+   * so compilation happens during initialization and the tree is kept in
+   * the snapshot. `match` walks the request path natively and returns the
+   * index of the matching route with its parameters, in one call.
+   *
+   * Route syntax:
+   *
+   * - static segments: `/users/me`
+   * - parameters: `/users/:id` captures one non-empty segment. Values are
+   *   percent-decoded; a value whose escapes don't decode to valid UTF-8
+   *   (such as `%FF`) is kept as written.
+   * - a trailing wildcard: `/assets/*` matches `/assets` and anything below
+   *   it. The remainder is available as `params["*"]`.
+   *
+   * Trailing slashes are significant (`/a/` and `/a` are different paths).
+   * When several routes match, the one listed first wins.
+   *
+   * @example
+   * ```js
+   * /// <reference types="@gcoredev/fastedge-sdk-js" />
+   *
+   * import { Router } from "fastedge::router";
+   *
+   * const routes = [
+   *   ["GET", "/users/:id", (params) => Response.json({ user: params.id })],
+   *   ["POST", "/users", () => new Response("created", { status: 201 })],
+   *   ["*", "/static/*", (params) => fetch(`https://origin.example/${params["*"]}`)],
+   * ];
+   * const router = Router.compile(routes.map(([method, path]) => [method, path]));
+   *
+   * async function app(event) {
+   *   const { method, url } = event.request;
+   *   const match = router.match(method, url);
+   *   if (!match) return new Response("Not found", { status: 404 });
+   *   return routes[match.index][2](match.params);
+   * }
+   *
+   * addEventListener("fetch", event => event.respondWith(app(event)));
+   * ```
+   */
+  export const Router: {
+    /**
+     * Compiles a route list. Each route is a path (any method), a
+     * `[method, path]` pair or `{ method, path }`. A method of `"*"` or
+     * `"ALL"` matches any method. Throws on malformed paths, a `*` that
+     * isn't the last segment, and parameter patterns such as `:id{[0-9]+}`
+     * or `:id?`, which aren't supported.
+     *
+     * @param {RouteDefinition[]} routes  The routes, in priority order.
+     *
+     * @returns {RouterInstance} The compiled router.
+     */
+    compile(routes: RouteDefinition[]): RouterInstance;
+  };
+
+  /** A route for `Router.compile`. */
+  export type RouteDefinition = string | [method: string, path: string] | { method?: string; path: string };
+
+  /** Result of `RouterInstance.match`. */
+  export interface RouteMatch {
+    /** Index of the matching route in the list passed to `compile`. */
+    index: number;
+    /** Captured `:param` values, plus `"*"` for wildcard routes. */
+    params: Record<string, string>;
+  }
+
+  /** A compiled router returned by `Router.compile`. */
+  export interface RouterInstance {
+    /**
+     * Finds the first route matching `method` and `target`.
+     *
+     * @param {string} method  The request method (case-insensitive).
+     * @param {string} target  A path or a full URL such as
+     *   `event.request.url`. The query string and fragment are ignored.
+     *
+     * @returns {RouteMatch | null} The match, or `null` if no route matches.
+     */
+    match(method: string, target: string): RouteMatch | null;
+
+    /** Number of routes. */
+    readonly size: number;
+  }
+}
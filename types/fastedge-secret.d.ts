@@ -4,6 +4,9 @@ declare module 'fastedge::secret' {
    *
    * **Note**: The secret variables can only be retrieved when processing requests, not during build-time initialization.
    *
+   * Each secret is fetched and decrypted once per instance; later calls with the same name return the cached
+   * value. If the host fails to read the secret, `null` is returned and the next call tries again.
+   *
    * @param {string} name - The name of the secret variable.
    * @returns {string | null} The value of the secret variable, or `null` if not set.
    *
@@ -32,6 +35,10 @@ declare module 'fastedge::secret' {
    *
    * **Note**: The secret variables can only be retrieved when processing requests, not during build-time initialization.
    *
+   * Results are cached per name and `effectiveAt`, since the value effective at a given slot never changes. Only the
+   * few most recently used `effectiveAt` values keep a cache, so passing the current time on each request stays
+   * bounded.
+   *
    * @param {string} name - The name of the secret variable.
    * @param {number} effectiveAt - The slot index of the secret. (effectiveAt >= secret_slots.slot)
    * @returns {string | null} The value of the secret variable, or `null` if not set.
@@ -55,6 +55,12 @@ declare interface FetchEvent {
    * Lazy: nothing is parsed until first access.
    */
   readonly server: ServerInfo;
+  /**
+   * Cookies sent with the request (`Cookie` header).
+   * Lazy: the header is scanned natively on each lookup, and only the
+   * requested value is turned into a string.
+   */
+  readonly cookies: CookieJar;
   /**
    * The downstream request that came from the client
    */
@@ -104,6 +110,12 @@ declare interface FetchEvent {
  * the request. Direct fields are populated when this object is first
  * accessed; the nested {@link ClientInfo.geo} namespace is populated only
  * if you read it.
+ *
+ * Fields are getters on the prototype, not own properties, so
+ * `Object.keys(event.client)` is empty and `{ ...event.client }` copies
+ * nothing; `for...in` still lists them. `JSON.stringify` serializes the
+ * fields as before. The same applies to {@link GeoInfo},
+ * {@link ServerInfo} and {@link PopInfo}.
  */
 declare interface ClientInfo {
   /**
@@ -116,10 +128,22 @@ declare interface ClientInfo {
    * trust decisions on this platform.
    */
   readonly address: string;
+  /**
+   * {@link ClientInfo.address} parsed to binary form: a 4-byte
+   * `Uint8Array` for IPv4 or a 16-byte one for IPv6, in network byte
+   * order. IPv4-mapped IPv6 addresses are reported as IPv4. `null` if the
+   * address is empty or doesn't parse.
+   *
+   * Pass it to `CidrSet.contains` (`fastedge::ip`) for allow / deny lists.
+   */
+  readonly ip: Uint8Array | null;
   /**
    * JA3 TLS-handshake fingerprint as an MD5 hex string, from the
    * platform-set `x-ja3` header. Empty string for non-TLS requests or
    * when fingerprinting is unavailable.
+   *
+   * Pass it to `Ja3Set.classify` (`fastedge::ja3`) to look it up in
+   * known-good / known-bad lists.
    */
   readonly tlsJA3MD5: string;
   /**
@@ -193,6 +217,30 @@ declare interface PopInfo {
   readonly city: string;
 }
 
+/**
+ * Read-only view of the request's cookies, from {@link FetchEvent.cookies}.
+ *
+ * Every `Cookie` header of the request is considered. Cookie names are
+ * matched exactly and case-sensitively. When a name appears more than once,
+ * the first occurrence wins. Values are returned as sent, without percent
+ * decoding, except that surrounding double quotes are removed.
+ */
+declare interface CookieJar {
+  /**
+   * The value of cookie `name`, or `null` if the request doesn't carry it.
+   *
+   * @example
+   * ```js
+   * const session = event.cookies.get("session");
+   * ```
+   */
+  get(name: string): string | null;
+  /** Whether the request carries cookie `name`. Allocates nothing. */
+  has(name: string): boolean;
+  /** Every cookie as a `name → value` object. Parses the whole header. */
+  getAll(): Record<string, string>;
+}
+
 /**
  * The URL class as [specified by WHATWG](https://url.spec.whatwg.org/#url-class)
  *
@@ -3,6 +3,12 @@
 /// <reference path="fastedge-secret.d.ts" />
 /// <reference path="fastedge-kv.d.ts" />
 /// <reference path="fastedge-cache.d.ts" />
+/// <reference path="fastedge-codec.d.ts" />
+/// <reference path="fastedge-ip.d.ts" />
+/// <reference path="fastedge-ja3.d.ts" />
+/// <reference path="fastedge-pattern.d.ts" />
+/// <reference path="fastedge-router.d.ts" />
+/// <reference path="fastedge-assets.d.ts" />
 /// <reference path="globals.d.ts" />
 
 export * from './server/static-assets/index.d.ts';
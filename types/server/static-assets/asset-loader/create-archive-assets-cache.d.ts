@@ -0,0 +1,12 @@
+import type { AssetCache } from './asset-cache/asset-cache.ts';
+import type { StaticAsset } from './inline-asset/inline-asset.ts';
+import type { AssetArchiveInstance } from 'fastedge::assets';
+/**
+ * Creates an `AssetCache` over a packed asset archive written by `fastedge-assets`.
+ * Lookups are resolved natively by `AssetArchive`, so no per-asset JS objects are kept in the heap.
+ *
+ * @param archive - The archive, opened with `AssetArchive.open` during Wizer processing.
+ * @returns A read-only `AssetCache` instance.
+ */
+declare function createArchiveAssetsCache(archive: AssetArchiveInstance): AssetCache<StaticAsset>;
+export { createArchiveAssetsCache };
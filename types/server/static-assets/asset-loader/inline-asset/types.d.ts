@@ -1,5 +1,5 @@
 import type { EmbeddedStoreEntry } from '../embedded-store-entry/embedded-store-entry.ts';
-type ContentCompressionTypes = 'br' | 'gzip';
+type ContentCompressionTypes = 'br' | 'gzip' | 'zstd';
 /**
  * Represents the source and metadata of an asset.
  */
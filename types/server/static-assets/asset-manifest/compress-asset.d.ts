@@ -0,0 +1,24 @@
+import type { ContentCompressionTypes } from '~static-assets/asset-loader/inline-asset/inline-asset.ts';
+/**
+ * Encodings that can be precompressed into an asset archive, in the order their variants are stored.
+ */
+declare const ARCHIVE_ENCODINGS: readonly ContentCompressionTypes[];
+type CompressedVariants = Partial<Record<ContentCompressionTypes, Uint8Array>>;
+/**
+ * Creates the precompressed variants of an asset for each requested encoding, keeping a variant only if it is
+ * smaller than the original.
+ *
+ * @param content - The asset's contents.
+ * @param encodings - The encodings to produce.
+ * @param isText - Whether the asset has a text content type.
+ * @returns The variants that were kept, by encoding.
+ */
+declare function compressAsset(content: Uint8Array, encodings: readonly ContentCompressionTypes[], isText: boolean): CompressedVariants;
+/**
+ * Filters a configured list of encodings down to those an asset archive can hold, warning about the rest.
+ * @param compression - The configured encodings.
+ * @returns The supported encodings, without duplicates.
+ */
+declare function normalizeArchiveEncodings(compression?: string[]): ContentCompressionTypes[];
+export { ARCHIVE_ENCODINGS, compressAsset, normalizeArchiveEncodings };
+export type { CompressedVariants };
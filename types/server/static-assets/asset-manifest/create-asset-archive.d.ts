@@ -0,0 +1,61 @@
+import type { StaticAssetManifest } from './types.ts';
+import type { ContentCompressionTypes } from '~static-assets/asset-loader/inline-asset/inline-asset.ts';
+/**
+ * Packed asset archive layout (version 2). All integers are little-endian u32.
+ *
+ * | Section       | Contents                                                                   |
+ * | ------------- | -------------------------------------------------------------------------- |
+ * | header        | magic `FEPK`, version, entry count, offsets of the four sections, length    |
+ * | displacements | one i32 per entry, the minimal perfect hash over asset keys                 |
+ * | entries       | `ENTRY_WORDS` u32s per asset, see `EntryField`                              |
+ * | strings       | UTF-8 asset keys, content types, ETags and Last-Modified values             |
+ * | data          | file contents and their precompressed variants, each 8-byte aligned         |
+ *
+ * Each entry locates its precompressed variants with a start/length pair per encoding, in `ARCHIVE_ENCODINGS`
+ * order; a length of 0 means there is no variant for that encoding.
+ *
+ * The runtime reader is `runtime/fastedge/builtins/asset-archive.cpp`; the two must change together.
+ */
+declare const ARCHIVE_MAGIC = 1263551814;
+declare const ARCHIVE_VERSION = 2;
+declare const ENTRY_WORDS = 18;
+declare const EntryField: {
+    readonly PathOffset: 0;
+    readonly PathLength: 1;
+    readonly DataStart: 2;
+    readonly DataLength: 3;
+    readonly ContentTypeOffset: 4;
+    readonly ContentTypeLength: 5;
+    readonly EtagOffset: 6;
+    readonly EtagLength: 7;
+    readonly LastModifiedOffset: 8;
+    readonly LastModifiedLength: 9;
+    readonly LastModifiedTime: 10;
+    readonly Flags: 11;
+    readonly VariantsStart: 12;
+};
+interface AssetArchiveOptions {
+    /** Encodings to precompress each asset with; a variant is kept only if smaller than the original. */
+    compression?: readonly ContentCompressionTypes[];
+    /** Reads an asset's contents, given its `fileInfo.assetPath`. */
+    readFile?: (assetPath: string) => Uint8Array;
+}
+/**
+ * FNV-1a over the UTF-8 bytes of an asset key, with `seed` as the offset basis (0 selects the standard one).
+ * @param seed - The hash seed.
+ * @param bytes - The UTF-8 encoded asset key.
+ * @returns The 32-bit hash.
+ */
+declare function hashAssetPath(seed: number, bytes: Uint8Array): number;
+/**
+ * Packs every asset in a manifest into a single archive, with a minimal perfect hash over asset keys,
+ * precomputed `Content-Type`, `ETag` and `Last-Modified` values and optional precompressed variants, for
+ * `AssetArchive.open` (`fastedge::assets`).
+ *
+ * @param staticAssetManifest - The manifest of assets to pack.
+ * @param options - Compression and file reading options.
+ * @returns The archive bytes.
+ */
+declare function createAssetArchive(staticAssetManifest: StaticAssetManifest, { compression, readFile, }?: AssetArchiveOptions): Uint8Array;
+export { ARCHIVE_MAGIC, ARCHIVE_VERSION, createAssetArchive, EntryField, ENTRY_WORDS, hashAssetPath };
+export type { AssetArchiveOptions };
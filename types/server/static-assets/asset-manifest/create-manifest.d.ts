@@ -3,6 +3,11 @@ import type { AssetCacheConfig, StaticAssetManifest } from './types.ts';
  * Creates a Static Asset Manifest file. This is a pre-build step that generates a manifest of all static assets to be included in the build.
  * This `StaticAssetManifest` will be used to create an in memory StaticAssetCache stored in the binary during Wizer processing.
  *
+ * The same assets are also packed into a single archive next to the manifest (`<manifest name>.pack`), whose path the
+ * manifest file exports as `staticAssetArchive`. With `compression` set, the archive also holds precompressed variants
+ * of each asset. Passing that path to `createStaticServer` serves assets from the
+ * archive through the native `AssetArchive` lookup instead of a JS manifest object.
+ *
  * @param assetCacheConfig - The configuration for what files to include.
  * @returns An `AssetCache` instance containing the static assets.
  */
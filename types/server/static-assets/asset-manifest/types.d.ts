@@ -6,6 +6,7 @@ interface AssetCacheConfig extends Record<string, unknown> {
     ignoreDotFiles: boolean;
     ignorePaths: string[];
     ignoreWellKnown: boolean;
+    compression: string[];
 }
 export type { AssetCacheConfig };
 export type { StaticAssetManifest } from '../asset-loader/types.ts';
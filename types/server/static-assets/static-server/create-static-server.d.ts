@@ -3,11 +3,12 @@ import type { StaticAssetManifest } from '~static-assets/asset-loader/create-sta
 /**
  * Creates a static server instance, able to serve static assets.
  *
- * @param staticAssetManifest - The StaticAssetManifest generated from "npx fastedge-assets".
+ * @param staticAssetManifest - The StaticAssetManifest generated from "npx fastedge-assets", or the path of its packed
+ *   asset archive (`staticAssetArchive` from the same generated file).
  * @param serverConfig - The server configuration.
  * @returns A `StaticServer` instance.
  */
-declare const createStaticServer: (staticAssetManifest: StaticAssetManifest, serverConfig: Partial<ServerConfig>) => StaticServer;
+declare const createStaticServer: (staticAssetManifest: StaticAssetManifest | string, serverConfig: Partial<ServerConfig>) => StaticServer;
 export { createStaticServer };
 export type { ServerConfig, StaticServer } from './types.ts';
 export type { StaticAssetManifest } from '~static-assets/asset-loader/create-static-assets-cache.ts';
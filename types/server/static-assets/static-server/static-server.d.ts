@@ -1,4 +1,5 @@
 import type { ServerConfig, StaticServer } from './types.ts';
+import type { AssetArchiveInstance } from 'fastedge::assets';
 import type { AssetCache } from '~static-assets/asset-loader/asset-cache/asset-cache.ts';
 import type { StaticAsset } from '~static-assets/asset-loader/inline-asset/inline-asset.ts';
 /**
@@ -6,7 +7,9 @@ import type { StaticAsset } from '~static-assets/asset-loader/inline-asset/inlin
  *
  * @param serverConfig - The server configuration.
  * @param assetCache - The asset cache.
+ * @param nativeServer - An asset archive opened with this `serverConfig`; when given, asset hits are served by
+ *   `nativeServer.serve` and only fallback pages go through the JS path.
  * @returns A `StaticServer` instance.
  */
-declare const getStaticServer: <T = StaticServer>(serverConfig: ServerConfig, assetCache: AssetCache<StaticAsset>) => T;
+declare const getStaticServer: <T = StaticServer>(serverConfig: ServerConfig, assetCache: AssetCache<StaticAsset>, nativeServer?: AssetArchiveInstance) => T;
 export { getStaticServer };